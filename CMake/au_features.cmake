@@ -36,6 +36,7 @@ set(KNOWN_MODULES
 
 set(au_core_FEATURES
     "ThreadPinning"
+    "ThreadPool"
     "Status"
     "Logger"
     "RNG"
@@ -47,6 +48,8 @@ set(au_cpuid_FEATURES
 
 # Define feature dependencies
 set(Logger_DEPENDS "Status")
+set(ThreadPinning_DEPENDS "Status" "Logger")
+set(ThreadPool_DEPENDS "ThreadPinning" "Status" "Logger")
 
 # Define target names for modules
 set(au_cpuid_TARGET_NAME "au_cpuid")
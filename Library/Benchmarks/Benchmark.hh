@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include "Au/Types.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Small helpers shared by the benchmark executables.
+ *
+ * Every benchmark collects Result records into a Report, which is printed as
+ * one JSON document so that runs can be archived and compared by scripts.
+ */
+namespace Au::Benchmark {
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+inline Uint64
+nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Command line options understood by every benchmark.
+ *
+ * --threads N     largest producer count, runs 1, 2, 4, ... N
+ * --iterations N  operations per thread and run
+ * --output FILE   write the JSON report to FILE instead of stdout
+ * --smoke         tiny run to check that the benchmark works
+ */
+class Options
+{
+  public:
+    Uint32      m_maxThreads{ std::thread::hardware_concurrency() };
+    Uint64      m_iterations{ 1000000 };
+    std::string m_output{};
+    bool        m_smoke{ false };
+
+    /**
+     * @brief Overrides the members from the command line, exits on a usage
+     * error.
+     */
+    void parse(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if (!strcmp(argv[i], "--threads") && hasValue) {
+                m_maxThreads = std::max(1, atoi(argv[++i]));
+            } else if (!strcmp(argv[i], "--iterations") && hasValue) {
+                m_iterations = strtoull(argv[++i], nullptr, 10);
+            } else if (!strcmp(argv[i], "--output") && hasValue) {
+                m_output = argv[++i];
+            } else if (!strcmp(argv[i], "--smoke")) {
+                m_smoke = true;
+            } else {
+                fprintf(stderr,
+                        "Usage: %s [--threads N] [--iterations N] "
+                        "[--output FILE] [--smoke]\n",
+                        argv[0]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        m_maxThreads = std::max(m_maxThreads, 1U);
+        if (m_smoke) {
+            m_maxThreads = std::min(m_maxThreads, 2U);
+            m_iterations = std::min<Uint64>(m_iterations, 1000);
+        }
+    }
+
+    /**
+     * @brief Thread counts to run, powers of two up to and including the
+     * maximum.
+     */
+    std::vector<Uint32> threadCounts() const
+    {
+        std::vector<Uint32> counts;
+        for (Uint32 n = 1; n < m_maxThreads; n *= 2) {
+            counts.push_back(n);
+        }
+        counts.push_back(m_maxThreads);
+        return counts;
+    }
+};
+
+/**
+ * @brief Outcome of one benchmark run.
+ */
+class Result
+{
+  public:
+    std::string m_name{};       ///< e.g. "queue/LockingQueue"
+    Uint32      m_threads{};    ///< Concurrent producers
+    Uint64      m_operations{}; ///< Operations completed by all threads
+    Float64     m_seconds{};    ///< Wall time of the whole run
+
+    /// Per operation latencies in nanoseconds, may be empty
+    std::vector<Uint64> m_latencies{};
+};
+
+/**
+ * @brief Collects results and prints them as JSON.
+ *
+ * Layout:
+ * {"benchmark":"<name>","results":[{"name":..,"threads":..,
+ *  "operations":..,"seconds":..,"ops_per_second":..,
+ *  "latency_ns":{"p50":..,"p90":..,"p99":..,"p999":..,"max":..}}, ...]}
+ */
+class Report
+{
+  private:
+    std::string         m_benchmark;
+    std::vector<Result> m_results;
+
+    static Uint64 percentile(const std::vector<Uint64>& sorted, Float64 p)
+    {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+  public:
+    explicit Report(std::string benchmark)
+        : m_benchmark{ std::move(benchmark) }
+        , m_results{}
+    {
+    }
+
+    void add(Result result)
+    {
+        std::sort(result.m_latencies.begin(), result.m_latencies.end());
+        fprintf(stderr,
+                "%-32s threads %3u  %12.0f ops/s\n",
+                result.m_name.c_str(),
+                result.m_threads,
+                result.m_operations / result.m_seconds);
+        m_results.push_back(std::move(result));
+    }
+
+    /**
+     * @brief Writes the report to 'path', or stdout if it is empty.
+     * @return false if the file could not be written.
+     */
+    bool write(const std::string& path) const
+    {
+        FILE* out = path.empty() ? stdout : fopen(path.c_str(), "w");
+        if (out == nullptr) {
+            perror(path.c_str());
+            return false;
+        }
+
+        fprintf(out,
+                "{\"benchmark\":\"%s\",\"results\":[",
+                m_benchmark.c_str());
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const Result& r = m_results[i];
+            fprintf(out,
+                    "%s\n{\"name\":\"%s\",\"threads\":%u,\"operations\":%llu,"
+                    "\"seconds\":%.6f,\"ops_per_second\":%.1f",
+                    i ? "," : "",
+                    r.m_name.c_str(),
+                    r.m_threads,
+                    static_cast<unsigned long long>(r.m_operations),
+                    r.m_seconds,
+                    r.m_operations / r.m_seconds);
+            if (!r.m_latencies.empty()) {
+                const auto& l = r.m_latencies;
+                fprintf(out,
+                        ",\"latency_ns\":{\"p50\":%llu,\"p90\":%llu,"
+                        "\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+                        static_cast<unsigned long long>(percentile(l, 0.5)),
+                        static_cast<unsigned long long>(percentile(l, 0.9)),
+                        static_cast<unsigned long long>(percentile(l, 0.99)),
+                        static_cast<unsigned long long>(percentile(l, 0.999)),
+                        static_cast<unsigned long long>(l.back()));
+            }
+            fprintf(out, "}");
+        }
+        fprintf(out, "\n]}\n");
+
+        bool ok = !ferror(out);
+        if (out != stdout) {
+            ok = fclose(out) == 0 && ok;
+        }
+        return ok;
+    }
+};
+
+} // namespace Au::Benchmark
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Producer latency and end-to-end throughput of the logger.
+ *
+ * queue/<impl>  Producers push into the queue and a single consumer thread
+ *               drains it, as the LogWriter thread does.
+ * sink/<impl>   Producers log through the LogWriter, the run ends once the
+ *               sink has written every message.
+ * macro/<impl>  Same through AU_LOGGER_LOG, as applications log: the level
+ *               check, the writer lookup and the Message are timed too.
+ *
+ * Latencies are measured on the producer side, per call.
+ */
+
+#include "Benchmark.hh"
+
+#include "Au/Logger/LogWriter.hh"
+#include "Au/Logger/Logger.hh"
+#include "Au/Logger/Macros.hh"
+#include "Au/Logger/Queue.hh"
+#include "Au/Memory/ObjectPool.hh"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+using namespace Au;
+using namespace Au::Logger;
+using namespace Au::Benchmark;
+
+namespace {
+
+const std::string_view cText = "benchmark message with a typical length of "
+                               "about eighty characters";
+
+/**
+ * @brief Runs 'threads' copies of 'produce', each recording one latency per
+ * operation, while 'waitDone' blocks until the consumer side has finished.
+ */
+Result
+runProducers(const std::string&                 name,
+             Uint32                             threads,
+             Uint64                             iterations,
+             const std::function<void(Uint32)>& produce,
+             const std::function<void()>&       waitDone,
+             std::vector<std::vector<Uint64>>&  latencies)
+{
+    latencies.assign(threads, {});
+    for (auto& l : latencies) {
+        l.reserve(iterations);
+    }
+
+    std::atomic<bool>        go{ false };
+    std::vector<std::thread> producers;
+    for (Uint32 t = 0; t < threads; t++) {
+        producers.emplace_back([&go, &produce, t] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            produce(t);
+        });
+    }
+
+    Uint64 start = nowNs();
+    go.store(true, std::memory_order_release);
+    for (auto& p : producers) {
+        p.join();
+    }
+    waitDone();
+    Uint64 end = nowNs();
+
+    Result result;
+    result.m_name       = name;
+    result.m_threads    = threads;
+    result.m_operations = threads * iterations;
+    result.m_seconds    = (end - start) / 1e9;
+    for (auto& l : latencies) {
+        result.m_latencies.insert(result.m_latencies.end(), l.begin(), l.end());
+    }
+    return result;
+}
+
+Result
+benchLockingQueue(Uint32 threads, Uint64 iterations)
+{
+    LockingQueue                     queue;
+    std::vector<std::vector<Uint64>> latencies;
+    Uint64                           total = threads * iterations;
+
+    std::thread consumer([&queue, total] {
+        for (Uint64 n = 0; n < total;) {
+            if (queue.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+            queue.dequeue();
+            n++;
+        }
+    });
+
+    auto produce = [&](Uint32 t) {
+        Message msg(cText);
+        auto&   lat = latencies[t];
+        for (Uint64 i = 0; i < iterations; i++) {
+            Uint64 t0 = nowNs();
+            queue.enqueue(msg);
+            lat.push_back(nowNs() - t0);
+        }
+    };
+
+    return runProducers("queue/LockingQueue",
+                        threads,
+                        iterations,
+                        produce,
+                        [&consumer] { consumer.join(); },
+                        latencies);
+}
+
+Result
+benchSpscRing(Uint32 threads, Uint64 iterations)
+{
+    // Same arrangement as the LogWriter: one ring per producer, records
+    // taken from a shared pool
+    Memory::ObjectPool<Message>                      pool(8192);
+    std::vector<std::unique_ptr<SpscRing<Message*>>> rings;
+    for (Uint32 t = 0; t < threads; t++) {
+        rings.push_back(std::make_unique<SpscRing<Message*>>(1024));
+    }
+    std::vector<std::vector<Uint64>> latencies;
+    Uint64                           total = threads * iterations;
+
+    std::thread consumer([&rings, &pool, total] {
+        Message* rec = nullptr;
+        for (Uint64 n = 0; n < total;) {
+            bool any = false;
+            for (auto& ring : rings) {
+                for (int burst = 0; burst < 64 && ring->tryPop(rec); burst++) {
+                    pool.release(rec);
+                    n++;
+                    any = true;
+                }
+            }
+            if (!any) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    auto produce = [&](Uint32 t) {
+        Message msg(cText);
+        auto&   ring = *rings[t];
+        auto&   lat  = latencies[t];
+        for (Uint64 i = 0; i < iterations; i++) {
+            Uint64   t0  = nowNs();
+            Message* rec = pool.acquire(msg);
+            while (!ring.tryPush(rec)) {
+                std::this_thread::yield();
+            }
+            lat.push_back(nowNs() - t0);
+        }
+    };
+
+    return runProducers("queue/SpscRing",
+                        threads,
+                        iterations,
+                        produce,
+                        [&consumer] { consumer.join(); },
+                        latencies);
+}
+
+/**
+ * @brief Forwards to another logger and counts the messages written.
+ */
+class CountingLogger : public GenericLogger
+{
+  private:
+    std::unique_ptr<ILogger> m_logger;
+    std::atomic<Uint64>&     m_count;
+
+  public:
+    CountingLogger(std::unique_ptr<ILogger> logger, std::atomic<Uint64>& count)
+        : m_logger{ std::move(logger) }
+        , m_count{ count }
+    {
+    }
+
+    void write(const Message& msg) override
+    {
+        m_logger->write(msg);
+        m_count.fetch_add(1, std::memory_order_release);
+    }
+
+    void flush() override { m_logger->flush(); }
+};
+
+Result
+benchSink(const std::string&       name,
+          std::unique_ptr<ILogger> sink,
+          Uint32                   threads,
+          Uint64                   iterations,
+          bool                     macro)
+{
+    std::atomic<Uint64> written{ 0 };
+    Uint64              total = threads * iterations;
+
+    LogWriter::setLogger(
+        std::make_unique<CountingLogger>(std::move(sink), written));
+    auto writer = LogWriter::getLogWriter();
+
+    std::vector<std::vector<Uint64>> latencies;
+    auto                             produce = [&](Uint32 t) {
+        Priority priority(Priority::PriorityLevel::eInfo);
+        auto&    lat = latencies[t];
+        for (Uint64 i = 0; i < iterations; i++) {
+            Uint64 t0 = nowNs();
+            if (macro) {
+                AU_LOGGER_LOG(cText, eInfo);
+            } else {
+                writer->log(Message(cText, priority));
+            }
+            lat.push_back(nowNs() - t0);
+        }
+    };
+    auto waitDone = [&written, total] {
+        while (written.load(std::memory_order_acquire) < total) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+
+    Result result = runProducers((macro ? "macro/" : "sink/") + name,
+                                 threads,
+                                 iterations,
+                                 produce,
+                                 waitDone,
+                                 latencies);
+    writer->stop();
+    return result;
+}
+
+/**
+ * @brief Directory on tmpfs if there is one, so that the file sink measures
+ * the logger rather than the disk.
+ */
+std::filesystem::path
+scratchDirectory()
+{
+    std::error_code ec;
+    if (std::filesystem::is_directory("/dev/shm", ec)) {
+        return "/dev/shm";
+    }
+    return std::filesystem::temp_directory_path();
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Options opt;
+    opt.m_iterations = 200000;
+    opt.parse(argc, argv);
+
+    auto logFile = scratchDirectory() / "aoclutils_logger_bench.log";
+
+    Report report("logger");
+    for (Uint32 threads : opt.threadCounts()) {
+        report.add(benchLockingQueue(threads, opt.m_iterations));
+        report.add(benchSpscRing(threads, opt.m_iterations));
+        for (bool macro : { false, true }) {
+            report.add(benchSink("DummyLogger",
+                                 std::make_unique<DummyLogger>(),
+                                 threads,
+                                 opt.m_iterations,
+                                 macro));
+            report.add(benchSink("FileLogger",
+                                 std::make_unique<FileLogger>(logFile.string()),
+                                 threads,
+                                 opt.m_iterations,
+                                 macro));
+            std::filesystem::remove(logFile);
+        }
+    }
+
+    return report.write(opt.m_output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
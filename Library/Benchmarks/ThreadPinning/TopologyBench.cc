@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Cost of loading the CPU topology from sysfs, on synthetic trees written
+ * under the temporary directory.
+ *
+ * read/ifstream     One cpulist read with std::ifstream and getline.
+ * read/pread        The same file read with SysfsDir (openat, pread).
+ * topology/<cpus>   Construction of a CpuTopology for a machine with <cpus>
+ *                   logical CPUs.
+ *
+ * Latencies are per read or per construction.
+ */
+
+#include "Benchmark.hh"
+#include "SysfsTree.hh"
+
+#include "Au/ThreadPinning/Linux/CpuTopology.hh"
+
+#include <fstream>
+#include <functional>
+
+using namespace Au;
+using namespace Au::Benchmark;
+
+namespace {
+
+/**
+ * @brief Runs 'operation' 'iterations' times on the calling thread.
+ */
+Result
+runSerial(const std::string&           name,
+          Uint64                       iterations,
+          const std::function<bool()>& operation)
+{
+    Result result;
+    result.m_name    = name;
+    result.m_threads = 1;
+    result.m_latencies.reserve(iterations);
+
+    Uint64 start = nowNs();
+    for (Uint64 i = 0; i < iterations; i++) {
+        Uint64 t0 = nowNs();
+        if (!operation()) {
+            fprintf(stderr, "%s failed\n", name.c_str());
+            exit(EXIT_FAILURE);
+        }
+        result.m_latencies.push_back(nowNs() - t0);
+    }
+    result.m_seconds    = (nowNs() - start) * 1e-9;
+    result.m_operations = iterations;
+    return result;
+}
+
+Result
+benchIfstream(const SysfsTree& tree, Uint64 iterations)
+{
+    std::string path = tree.m_root + "/cpu/cpu1/cache/index3/shared_cpu_list";
+    return runSerial("read/ifstream", iterations, [&path] {
+        std::ifstream file(path);
+        std::string   line;
+        return getline(file, line) && !CpuSet::fromList(line).empty();
+    });
+}
+
+Result
+benchPread(const SysfsTree& tree, Uint64 iterations)
+{
+    SysfsDir index(tree.m_root + "/cpu/cpu1/cache/index3");
+    return runSerial("read/pread", iterations, [&index] {
+        CpuSet cpus;
+        return index.readList("shared_cpu_list", cpus) && !cpus.empty();
+    });
+}
+
+Result
+benchTopology(int cpus, Uint64 iterations)
+{
+    // SMT2, 8 cores per L3 cache, two sockets
+    SysfsTree tree("aoclutils_topology_bench_" + std::to_string(cpus),
+                   cpus,
+                   8,
+                   2,
+                   [](int) { return false; });
+    return runSerial(
+        "topology/" + std::to_string(cpus), iterations, [&tree, cpus] {
+            CpuTopology topology(tree.m_root, CpuSet());
+            return topology.active_processors == Uint32(cpus);
+        });
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Options opt;
+    opt.m_iterations = 100000;
+    opt.parse(argc, argv);
+
+    // A topology load reads thousands of files, run fewer of them
+    Uint64 loads = std::max<Uint64>(opt.m_iterations / 1000, 1);
+
+    Report report("topology");
+    {
+        SysfsTree tree(
+            "aoclutils_topology_bench_read", 256, 8, 2, [](int) {
+                return false;
+            });
+        report.add(benchIfstream(tree, opt.m_iterations));
+        report.add(benchPread(tree, opt.m_iterations));
+    }
+    for (int cpus : { 256, 1024 }) {
+        report.add(benchTopology(cpus, loads));
+    }
+
+    return report.write(opt.m_output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Cost of a barrier round for threads pinned with the spread strategy.
+ *
+ * barrier/tree         TreeBarrier, combining along the cache hierarchy.
+ * barrier/central      One counter and generation shared by every thread,
+ *                      spinning then yielding.
+ * barrier/condvar      One counter under a mutex, waiting on a condition
+ *                      variable.
+ * barrier/std          std::barrier, when the standard library has it.
+ * reduce/tree          TreeBarrier::reduce of a double sum.
+ *
+ * Every thread runs the same number of rounds, latencies are per round, as
+ * seen by the first thread.
+ */
+
+#include "Benchmark.hh"
+
+#include "Au/Barrier.hh"
+#include "Au/ThreadPinning.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#if __has_include(<barrier>)
+#include <barrier>
+#endif
+
+using namespace Au;
+using namespace Au::Benchmark;
+
+namespace {
+
+/**
+ * @brief Sense reversing barrier on a single cache line.
+ */
+class CentralBarrier
+{
+    alignas(64) std::atomic<Uint32> m_count;
+    std::atomic<Uint32> m_generation;
+    const Uint32        m_threads;
+
+  public:
+    explicit CentralBarrier(Uint32 threads)
+        : m_count{ 0 }
+        , m_generation{ 0 }
+        , m_threads{ threads }
+    {
+    }
+
+    void arriveAndWait()
+    {
+        Uint32 generation = m_generation.load(std::memory_order_acquire);
+        if (m_count.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threads) {
+            m_count.store(0, std::memory_order_relaxed);
+            m_generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (int spin = 0;
+             m_generation.load(std::memory_order_acquire) == generation;
+             spin++) {
+            if (spin > 4096)
+                std::this_thread::yield();
+        }
+    }
+};
+
+/**
+ * @brief Counting barrier under a mutex.
+ */
+class CondvarBarrier
+{
+    std::mutex              m_mutex;
+    std::condition_variable m_released;
+    Uint32                  m_count;
+    Uint32                  m_generation;
+    const Uint32            m_threads;
+
+  public:
+    explicit CondvarBarrier(Uint32 threads)
+        : m_mutex{}
+        , m_released{}
+        , m_count{ 0 }
+        , m_generation{ 0 }
+        , m_threads{ threads }
+    {
+    }
+
+    void arriveAndWait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Uint32                       generation = m_generation;
+        if (++m_count == m_threads) {
+            m_count = 0;
+            m_generation++;
+            m_released.notify_all();
+            return;
+        }
+        m_released.wait(lock, [&] { return m_generation != generation; });
+    }
+};
+
+/**
+ * @brief Runs 'rounds' rounds of 'round' on 'threads' pinned threads. The
+ * barrier is built by 'make' from the placement of the threads, once they
+ * are pinned.
+ */
+template<typename Barrier>
+Result
+runRounds(
+    const std::string& name,
+    Uint32             threads,
+    Uint64             rounds,
+    const std::function<std::unique_ptr<Barrier>(
+        std::vector<ThreadAffinity> const&)>&           make,
+    const std::function<void(Barrier&, Uint32 thread)>& round)
+{
+    std::unique_ptr<Barrier> barrier;
+    std::atomic<bool>        go{ false };
+    std::vector<Uint64>      latencies;
+    latencies.reserve(rounds);
+
+    std::vector<std::thread> workers;
+    for (Uint32 t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (Uint64 i = 0; i < rounds; i++) {
+                Uint64 t0 = t == 0 ? nowNs() : 0;
+                round(*barrier, t);
+                if (t == 0)
+                    latencies.push_back(nowNs() - t0);
+            }
+        });
+    }
+
+    std::vector<pthread_t> handles;
+    for (auto& worker : workers)
+        handles.push_back(worker.native_handle());
+    std::vector<ThreadAffinity> affinity;
+    ThreadPinning{}.pinThreads(handles, pinStrategy::SPREAD, affinity);
+    barrier = make(affinity);
+
+    Uint64 start = nowNs();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    Uint64 end = nowNs();
+
+    Result result;
+    result.m_name       = name;
+    result.m_threads    = threads;
+    result.m_operations = rounds;
+    result.m_seconds    = (end - start) / 1e9;
+    result.m_latencies  = std::move(latencies);
+    return result;
+}
+
+Result
+benchTree(Uint32 threads, Uint64 rounds)
+{
+    return runRounds<TreeBarrier>(
+        "barrier/tree",
+        threads,
+        rounds,
+        [](std::vector<ThreadAffinity> const& affinity) {
+            return std::make_unique<TreeBarrier>(affinity);
+        },
+        [](TreeBarrier& barrier, Uint32 t) { barrier.arriveAndWait(t); });
+}
+
+Result
+benchTreeReduce(Uint32 threads, Uint64 rounds)
+{
+    return runRounds<TreeBarrier>(
+        "reduce/tree",
+        threads,
+        rounds,
+        [](std::vector<ThreadAffinity> const& affinity) {
+            return std::make_unique<TreeBarrier>(affinity);
+        },
+        [](TreeBarrier& barrier, Uint32 t) {
+            barrier.reduce(t, 1.0 * t, TreeBarrier::ReduceOp::eSum);
+        });
+}
+
+template<typename Barrier>
+Result
+benchCentral(const std::string& name, Uint32 threads, Uint64 rounds)
+{
+    return runRounds<Barrier>(
+        name,
+        threads,
+        rounds,
+        [threads](std::vector<ThreadAffinity> const&) {
+            return std::make_unique<Barrier>(threads);
+        },
+        [](Barrier& barrier, Uint32) { barrier.arriveAndWait(); });
+}
+
+#if defined(__cpp_lib_barrier)
+Result
+benchStd(Uint32 threads, Uint64 rounds)
+{
+    return runRounds<std::barrier<>>(
+        "barrier/std",
+        threads,
+        rounds,
+        [threads](std::vector<ThreadAffinity> const&) {
+            return std::make_unique<std::barrier<>>(threads);
+        },
+        [](std::barrier<>& barrier, Uint32) { barrier.arrive_and_wait(); });
+}
+#endif
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    Options opt;
+    opt.m_iterations = 100000;
+    opt.parse(argc, argv);
+
+    Report report("barrier");
+    for (Uint32 threads : opt.threadCounts()) {
+        report.add(benchTree(threads, opt.m_iterations));
+        report.add(benchTreeReduce(threads, opt.m_iterations));
+        report.add(benchCentral<CentralBarrier>(
+            "barrier/central", threads, opt.m_iterations));
+        report.add(benchCentral<CondvarBarrier>(
+            "barrier/condvar", threads, opt.m_iterations));
+#if defined(__cpp_lib_barrier)
+        report.add(benchStd(threads, opt.m_iterations));
+#endif
+    }
+
+    return report.write(opt.m_output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -30,6 +30,32 @@
 #include "Au/Logger/LogManager.hh"
 #include "Au/Logger/LoggerCtx.hh"
 
+namespace {
+
+Au::Logger::Priority::PriorityLevel
+toPriorityLevel(log_level_t level)
+{
+    using PriorityLevel = Au::Logger::Priority::PriorityLevel;
+    switch (level) {
+        case AUD_LOG_LEVEL_TRACE:
+            return PriorityLevel::eTrace;
+        case AUD_LOG_LEVEL_DEBUG:
+            return PriorityLevel::eDebug;
+        case AUD_LOG_LEVEL_INFO:
+            return PriorityLevel::eInfo;
+        case AUD_LOG_LEVEL_WARN:
+            return PriorityLevel::eWarning;
+        case AUD_LOG_LEVEL_ERROR:
+            return PriorityLevel::eError;
+        case AUD_LOG_LEVEL_FATAL:
+            return PriorityLevel::eFatal;
+        default:
+            return PriorityLevel::eInfo;
+    }
+}
+
+} // namespace
+
 AUD_EXTERN_C_BEGIN
 
 logger_ctx_t*
@@ -41,8 +67,9 @@ au_logger_create()
         return nullptr;
     }
 
-    loggerCtx->logger = std::make_unique<Au::Logger::LogManager>(
-        Au::Logger::LogWriter::getLogWriter());
+    loggerCtx->logWriter = Au::Logger::LogWriter::getLogWriter();
+    loggerCtx->logger =
+        std::make_unique<Au::Logger::LogManager>(loggerCtx->logWriter);
     // Check if memory allocation is successful
     if (loggerCtx->logger == nullptr) {
         delete loggerCtx;
@@ -55,36 +82,31 @@ au_logger_create()
 void
 au_logger_log(logger_ctx_t* logger, const char* message, log_level_t level)
 {
-    LoggerCtx* loggerCtx = reinterpret_cast<LoggerCtx*>(logger);
-    Au::Logger::Priority::PriorityLevel priority;
-    switch (level) {
-        case AUD_LOG_LEVEL_TRACE:
-            priority = Au::Logger::Priority::PriorityLevel::eTrace;
-            break;
-        case AUD_LOG_LEVEL_DEBUG:
-            priority = Au::Logger::Priority::PriorityLevel::eDebug;
-            break;
-        case AUD_LOG_LEVEL_INFO:
-            priority = Au::Logger::Priority::PriorityLevel::eInfo;
-            break;
-        case AUD_LOG_LEVEL_WARN:
-            priority = Au::Logger::Priority::PriorityLevel::eWarning;
-            break;
-        case AUD_LOG_LEVEL_ERROR:
-            priority = Au::Logger::Priority::PriorityLevel::eError;
-            break;
-        case AUD_LOG_LEVEL_FATAL:
-            priority = Au::Logger::Priority::PriorityLevel::eFatal;
-            break;
-        default:
-            priority = Au::Logger::Priority::PriorityLevel::eInfo;
-            break;
-    }
-    Au::Logger::Priority p(priority);
+    LoggerCtx*           loggerCtx = reinterpret_cast<LoggerCtx*>(logger);
+    Au::Logger::Priority p(toPriorityLevel(level));
     Au::Logger::Message  msg(message, p);
     loggerCtx->logger->log(msg);
 }
 
+void
+au_logger_logf(logger_ctx_t* logger, log_level_t level, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    au_logger_vlogf(logger, level, fmt, args);
+    va_end(args);
+}
+
+void
+au_logger_vlogf(logger_ctx_t* logger,
+                log_level_t   level,
+                const char*   fmt,
+                va_list       args)
+{
+    LoggerCtx* loggerCtx = reinterpret_cast<LoggerCtx*>(logger);
+    loggerCtx->logWriter->vlogf(toPriorityLevel(level), fmt, args);
+}
+
 void
 au_logger_flush(logger_ctx_t* logger)
 {
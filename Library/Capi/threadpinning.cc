@@ -75,6 +75,36 @@ au_pin_threads_spread(pthread_t* threadList, size_t threadListSize)
     tp.pinThreads(threadListVec, 0); // spread
 }
 
+AUD_API_EXPORT
+void
+au_pin_threads_numa_spread(pthread_t* threadList, size_t threadListSize)
+{
+    AUD_ASSERT(threadList != nullptr, "Thread list is null");
+    AUD_ASSERT(threadListSize > 0, "Thread list size is 0");
+
+    ThreadPinning          tp;
+    std::vector<pthread_t> threadListVec;
+    for (size_t i = 0; i < threadListSize; i++) {
+        threadListVec.push_back(threadList[i]);
+    }
+    tp.pinThreads(threadListVec, pinStrategy::NUMA_SPREAD);
+}
+
+AUD_API_EXPORT
+void
+au_pin_threads_numa_compact(pthread_t* threadList, size_t threadListSize)
+{
+    AUD_ASSERT(threadList != nullptr, "Thread list is null");
+    AUD_ASSERT(threadListSize > 0, "Thread list size is 0");
+
+    ThreadPinning          tp;
+    std::vector<pthread_t> threadListVec;
+    for (size_t i = 0; i < threadListSize; i++) {
+        threadListVec.push_back(threadList[i]);
+    }
+    tp.pinThreads(threadListVec, pinStrategy::NUMA_COMPACT);
+}
+
 AUD_API_EXPORT
 void
 au_pin_threads_custom(pthread_t* threadList,
@@ -101,4 +131,112 @@ au_pin_threads_custom(pthread_t* threadList,
     }
     tp.pinThreads(threadListVec, affinityVectorVec);
 }
+
+AUD_API_EXPORT
+int
+au_pin_threads_custom_report(pthread_t*            threadList,
+                             size_t                threadListSize,
+                             int*                  affinityVector,
+                             size_t                affinityVectorSize,
+                             au_thread_affinity_t* report)
+{
+    AUD_ASSERT(threadList != nullptr, "Thread list is null");
+    AUD_ASSERT(affinityVector != nullptr, "Affinity vector is null");
+    AUD_ASSERT(affinityVectorSize == threadListSize,
+               "Affinity vector size is not equal to thread list size");
+    if (threadList == nullptr || affinityVector == nullptr)
+        return -1;
+
+    ThreadPinning               tp;
+    std::vector<ThreadAffinity> affinities;
+    std::vector<pthread_t>      threadListVec(threadList,
+                                         threadList + threadListSize);
+    std::vector<int>            affinityVectorVec(
+        affinityVector, affinityVector + affinityVectorSize);
+    Status status = tp.pinThreads(threadListVec, affinityVectorVec, affinities);
+    for (size_t i = 0; report != nullptr && i < affinities.size(); i++) {
+        report[i].thread      = affinities[i].thread;
+        report[i].requested   = affinities[i].requested;
+        report[i].actualCount = affinities[i].actual.size();
+        report[i].actual =
+            affinities[i].actual.size() == 1 ? affinities[i].actual[0] : -1;
+        report[i].status = affinities[i].status.ok() ? 0 : -1;
+    }
+    return status.ok() ? 0 : -1;
+}
+
+AUD_API_EXPORT
+size_t
+au_get_thread_affinity(pthread_t thread,
+                       int*      processors,
+                       size_t    processorsSize)
+{
+    ThreadPinning    tp;
+    std::vector<int> affinity = tp.getThreadAffinity(thread);
+    for (size_t i = 0;
+         processors != nullptr && i < processorsSize && i < affinity.size();
+         i++) {
+        processors[i] = affinity[i];
+    }
+    return affinity.size();
+}
+
+AUD_API_EXPORT
+int
+au_place_threads(pthread_t*  threadList,
+                 size_t      threadListSize,
+                 const char* placement)
+{
+    AUD_ASSERT(threadList != nullptr, "Thread list is null");
+    AUD_ASSERT(threadListSize > 0, "Thread list size is 0");
+    AUD_ASSERT(placement != nullptr, "Placement is null");
+    if (threadList == nullptr || placement == nullptr)
+        return -1;
+
+    ThreadPinning          tp;
+    std::vector<pthread_t> threadListVec(threadList,
+                                         threadList + threadListSize);
+    return tp.placeThreads(threadListVec, placement) ? 0 : -1;
+}
+
+AUD_API_EXPORT
+size_t
+au_get_available_processors(int* processors, size_t processorsSize)
+{
+    ThreadPinning    tp;
+    std::vector<int> available = tp.getAvailableProcessors();
+    for (size_t i = 0; processors != nullptr && i < processorsSize
+                       && i < available.size();
+         i++) {
+        processors[i] = available[i];
+    }
+    return available.size();
+}
+
+AUD_API_EXPORT
+int
+au_set_cpu_partition(size_t index, size_t count)
+{
+    return ThreadPinning::setPartition(index, count).ok() ? 0 : -1;
+}
+
+AUD_API_EXPORT
+void
+au_get_cpu_partition(size_t* index, size_t* count)
+{
+    size_t i = 0, n = 1;
+    ThreadPinning::getPartition(i, n);
+    if (index != nullptr)
+        *index = i;
+    if (count != nullptr)
+        *count = n;
+}
+
+AUD_API_EXPORT
+double
+au_get_cpu_quota(void)
+{
+    ThreadPinning tp;
+    return tp.getCpuQuota();
+}
 AUD_EXTERN_C_END
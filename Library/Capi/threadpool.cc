@@ -0,0 +1,94 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Au/ThreadPool.hh"
+#include "Au/Assert.hh"
+#include "Capi/au/macros.h"
+#include "Capi/au/threadpool.h"
+
+AUD_EXTERN_C_BEGIN
+
+using namespace Au;
+
+AUD_API_EXPORT
+au_thread_pool_t*
+au_thread_pool_create(size_t threadCount, int pinStrategy)
+{
+    return new ThreadPool(threadCount, pinStrategy);
+}
+
+AUD_API_EXPORT
+void
+au_thread_pool_destroy(au_thread_pool_t* pool)
+{
+    delete static_cast<ThreadPool*>(pool);
+}
+
+AUD_API_EXPORT
+size_t
+au_thread_pool_size(au_thread_pool_t* pool)
+{
+    AUD_ASSERT(pool != nullptr, "Pool is null");
+    return pool == nullptr ? 0 : static_cast<ThreadPool*>(pool)->size();
+}
+
+AUD_API_EXPORT
+void
+au_thread_pool_submit(au_thread_pool_t* pool, au_task_fn_t task, void* arg)
+{
+    AUD_ASSERT(pool != nullptr, "Pool is null");
+    AUD_ASSERT(task != nullptr, "Task is null");
+    if (pool == nullptr || task == nullptr)
+        return;
+    static_cast<ThreadPool*>(pool)->submit([task, arg] { task(arg); });
+}
+
+AUD_API_EXPORT
+void
+au_thread_pool_wait(au_thread_pool_t* pool)
+{
+    AUD_ASSERT(pool != nullptr, "Pool is null");
+    if (pool != nullptr)
+        static_cast<ThreadPool*>(pool)->wait();
+}
+
+AUD_API_EXPORT
+void
+au_parallel_for(au_thread_pool_t* pool,
+                size_t            begin,
+                size_t            end,
+                size_t            grain,
+                au_range_fn_t     body,
+                void*             arg)
+{
+    AUD_ASSERT(pool != nullptr, "Pool is null");
+    AUD_ASSERT(body != nullptr, "Body is null");
+    if (pool == nullptr || body == nullptr)
+        return;
+    static_cast<ThreadPool*>(pool)->parallelFor(
+        begin,
+        end,
+        [body, arg](size_t first, size_t last) { body(first, last, arg); },
+        grain);
+}
+
+AUD_EXTERN_C_END
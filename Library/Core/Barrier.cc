@@ -0,0 +1,133 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Au/Barrier.hh"
+#include "Au/ThreadPool/CombiningTree.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Au {
+
+namespace {
+
+    template<typename T>
+    Uint64 toBits(T value)
+    {
+        static_assert(sizeof(T) == sizeof(Uint64), "64 bit values only");
+        Uint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    template<typename T>
+    T fromBits(Uint64 bits)
+    {
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template<typename T>
+    T reduceValue(CombiningTree&        tree,
+                  size_t                participant,
+                  T                     value,
+                  TreeBarrier::ReduceOp op)
+    {
+        auto combine = [op](Uint64 a, Uint64 b) {
+            T x = fromBits<T>(a), y = fromBits<T>(b);
+            switch (op) {
+                case TreeBarrier::ReduceOp::eMin:
+                    return toBits(std::min(x, y));
+                case TreeBarrier::ReduceOp::eMax:
+                    return toBits(std::max(x, y));
+                default:
+                    return toBits(x + y);
+            }
+        };
+        return fromBits<T>(tree.arrive(participant, toBits(value), combine));
+    }
+
+    std::vector<int> requested(std::vector<ThreadAffinity> const& affinity)
+    {
+        std::vector<int> processors;
+        for (auto& thread : affinity)
+            processors.push_back(thread.requested);
+        return processors;
+    }
+
+} // namespace
+
+TreeBarrier::TreeBarrier(std::vector<int> const& processors)
+    : m_tree{ new CombiningTree{ processors } }
+{
+}
+
+TreeBarrier::TreeBarrier(std::vector<ThreadAffinity> const& affinity)
+    : TreeBarrier{ requested(affinity) }
+{
+}
+
+TreeBarrier::TreeBarrier(size_t participants)
+    : TreeBarrier{ std::vector<int>(participants, -1) }
+{
+}
+
+TreeBarrier::~TreeBarrier() {}
+
+size_t
+TreeBarrier::size() const
+{
+    return m_tree->size();
+}
+
+size_t
+TreeBarrier::depth() const
+{
+    return m_tree->depth();
+}
+
+void
+TreeBarrier::arriveAndWait(size_t participant)
+{
+    m_tree->arrive(participant, 0, [](Uint64, Uint64) { return Uint64{ 0 }; });
+}
+
+double
+TreeBarrier::reduce(size_t participant, double value, ReduceOp op)
+{
+    return reduceValue(*m_tree, participant, value, op);
+}
+
+Int64
+TreeBarrier::reduce(size_t participant, Int64 value, ReduceOp op)
+{
+    if (op == ReduceOp::eSum) {
+        // Signed overflow is undefined, add as unsigned
+        return fromBits<Int64>(m_tree->arrive(
+            participant, toBits(value), [](Uint64 a, Uint64 b) {
+                return a + b;
+            }));
+    }
+    return reduceValue(*m_tree, participant, value, op);
+}
+
+} // namespace Au
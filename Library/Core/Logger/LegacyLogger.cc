@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/Logger.hh"
+#include "Au/Logger/Logger.hh"
+
+namespace Au::Logger {
+
+namespace {
+    /// Field tagging the messages sent by LegacyLogger
+    constexpr std::string_view cSourceKey    = "source";
+    constexpr std::string_view cLegacySource = "legacy";
+
+    bool isLegacy(const Message& msg)
+    {
+        bool legacy = false;
+        msg.forEachField([&legacy](const MessageField& field) {
+            legacy = legacy
+                     || (field.m_key == cSourceKey
+                         && field.m_type == MessageField::Type::eString
+                         && field.m_string == cLegacySource);
+        });
+        return legacy;
+    }
+
+    /**
+     * @brief Writes to the logger installed on the LogWriter and the
+     * messages of LegacyLogger to cpuidlog.txt as well, until
+     * LegacyLogger::setLevel() puts the former back.
+     */
+    class CpuidFileLogger : public GenericLogger
+    {
+      private:
+        std::unique_ptr<ILogger> m_logger; ///< Logger it was added to
+        std::unique_ptr<ILogger> m_file;
+
+      public:
+        explicit CpuidFileLogger(std::unique_ptr<ILogger> logger)
+            : GenericLogger()
+            , m_logger{ std::move(logger) }
+            , m_file{ LoggerFactory::createLogger("FileLogger",
+                                                  "cpuidlog.txt") }
+        {
+        }
+
+        void write(const Message& msg) override
+        {
+            m_logger->write(msg);
+            // Application messages only go to the application's logger
+            if (isLegacy(msg)) {
+                m_file->write(msg);
+            }
+        }
+
+        void flush() override
+        {
+            m_logger->flush();
+            m_file->flush();
+        }
+
+        String getLoggerType() const override { return "CpuidFileLogger"; }
+
+        void forkPrepare() override
+        {
+            m_logger->forkPrepare();
+            m_file->forkPrepare();
+        }
+
+        void forkParent() override
+        {
+            m_logger->forkParent();
+            m_file->forkParent();
+        }
+
+        void forkChild() override
+        {
+            m_logger->forkChild();
+            m_file->forkChild();
+        }
+
+        /// Gives back the logger the file was added to
+        std::unique_ptr<ILogger> release() { return std::move(m_logger); }
+    };
+} // namespace
+
+// Class LegacyLogger begins
+LegacyLogger::LegacyLogger(LogLevel level)
+    : m_logLevel{ level }
+    , m_logToFile{ false }
+{
+    if (level < LogLevel::CRITICAL) {
+        return;
+    }
+    if (AU_BUILD_TYPE_RELEASE)
+        m_logLevel = LogLevel::CRITICAL;
+    else if (AU_BUILD_TYPE_DEBUG)
+        m_logLevel = LogLevel::INFO;
+    else if (AU_BUILD_TYPE_DEVELOPER)
+        m_logLevel = LogLevel::DEBUG;
+}
+
+LegacyLogger&
+LegacyLogger::getInstance()
+{
+    static LegacyLogger instance;
+    return instance;
+}
+
+Priority::PriorityLevel
+LegacyLogger::toPriority(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::DEBUG:
+            return Priority::PriorityLevel::eDebug;
+        case LogLevel::INFO:
+            return Priority::PriorityLevel::eInfo;
+        case LogLevel::WARNING:
+            return Priority::PriorityLevel::eWarning;
+        case LogLevel::ERROR:
+            return Priority::PriorityLevel::eError;
+        case LogLevel::CRITICAL:
+            break;
+    }
+    return Priority::PriorityLevel::ePanic;
+}
+
+void
+LegacyLogger::setLevel(LogLevel level, bool logToFile)
+{
+    m_logLevel = level;
+    // Leave the logging thread alone when there is no file to remove
+    if (!m_logToFile.exchange(logToFile) && !logToFile) {
+        return;
+    }
+
+    // The installed logger tells whether the file is on, so that it stays
+    // right when the application replaces the logger in between
+    LogWriter::replaceLogger([logToFile](std::unique_ptr<ILogger> current) {
+        auto file = dynamic_cast<CpuidFileLogger*>(current.get());
+        if (logToFile && file == nullptr) {
+            return std::unique_ptr<ILogger>(
+                std::make_unique<CpuidFileLogger>(std::move(current)));
+        }
+        if (!logToFile && file != nullptr) {
+            current->flush();
+            return file->release();
+        }
+        return current;
+    });
+}
+
+void
+LegacyLogger::submit(LogLevel level, const String& text)
+{
+    Priority priority(toPriority(level));
+    Message  msg(text, priority);
+    msg.addField(cSourceKey, cLegacySource);
+    LogWriter::current().log(msg);
+}
+// Class LegacyLogger ends
+
+} // namespace Au::Logger
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/Logger/LogSite.hh"
+
+namespace Au::Logger {
+
+std::atomic<LogSite*> LogSite::s_head{ nullptr };
+
+// Class LogSite begins
+LogSite::LogSite(const char* file, int line, Priority::PriorityLevel level)
+    : m_file{ file }
+    , m_line{ line }
+    , m_level{ level }
+    , m_calls{ 0 }
+    , m_windowStart{ 0 }
+    , m_windowCount{ 0 }
+    , m_suppressed{ 0 }
+    , m_next{ nullptr }
+{
+    // Sites are never unregistered, they are static objects
+    m_next = s_head.load(std::memory_order_relaxed);
+    while (!s_head.compare_exchange_weak(
+        m_next, this, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+bool
+LogSite::allowRate(Uint64 perSecond)
+{
+    constexpr Uint64 cWindow = 1000000000ULL; // 1 second in nanoseconds
+
+    Uint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+    Uint64 start = m_windowStart.load(std::memory_order_relaxed);
+    if (now - start >= cWindow
+        && m_windowStart.compare_exchange_strong(
+            start, now, std::memory_order_relaxed)) {
+        // Only the thread which moved the window resets it; calls racing
+        // with the reset may be counted against either window
+        m_windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (m_windowCount.fetch_add(1, std::memory_order_relaxed) < perSecond) {
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void
+LogSite::reportSuppressed(const std::function<void(Message&)>& emit)
+{
+    for (LogSite* site = s_head.load(std::memory_order_acquire);
+         site != nullptr;
+         site = site->m_next) {
+        Uint64 count = site->takeSuppressed();
+        if (count == 0) {
+            continue;
+        }
+        Priority priority(site->m_level);
+        Message  summary(String(site->m_file) + ":"
+                             + std::to_string(site->m_line) + ": suppressed "
+                             + std::to_string(count) + " messages",
+                         priority);
+        emit(summary);
+    }
+}
+// Class LogSite ends
+
+} // namespace Au::Logger
@@ -27,32 +27,394 @@
  */
 
 #include "Au/Logger/LogWriter.hh"
+#include "Au/Logger/LogSite.hh"
+#include "Au/Memory/ObjectPool.hh"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
 #include <iostream>
 #include <mutex>
 
+#if defined(__linux__)
+#include "Au/ThreadPinning/Linux/CpuTopology.hh"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #define USE_NO_LOCK 0
 
 namespace Au::Logger {
 
+namespace {
+
+    constexpr size_t cRingCapacity = 1024; ///< Messages per producer thread
+    constexpr size_t cRingBurst    = 64;   ///< Messages taken per ring a round
+    constexpr Uint32 cPoolCapacity = 8192; ///< Records shared by all threads
+
+    /// How often suppressed sampled / rate limited messages are summarised
+    constexpr auto cSummaryInterval = std::chrono::seconds(1);
+
+    /**
+     * @brief Records travelling through the rings, recycled by the logging
+     * thread once written.
+     *
+     * Never destroyed, so that rings released during static destruction can
+     * still hand their records back.
+     */
+    Au::Memory::ObjectPool<Message>& recordPool()
+    {
+        static auto* pool = new Au::Memory::ObjectPool<Message>(cPoolCapacity);
+        return *pool;
+    }
+
+    /**
+     * @brief Lock-free buffer owned by one producer thread.
+     *
+     * Rings live in a process wide registry rather than in a LogWriter, so
+     * messages pushed while the writer is being restarted are picked up by the
+     * next instance.
+     */
+    struct ProducerRing
+    {
+        SpscRing<Message*> m_ring{ cRingCapacity };
+        std::atomic<bool>  m_detached{ false }; ///< Owning thread has exited
+
+        /// A record overflowed to the shared queue. Later records follow it
+        /// there until the collector has emptied the ring, so that none of
+        /// them is written before the older records still in the ring.
+        std::atomic<bool> m_spilled{ false };
+
+        /// Owning thread is between its check of the writer state and the
+        /// end of its push, shutdown() waits for it before its last sweep
+        std::atomic<bool> m_submitting{ false };
+
+        ~ProducerRing()
+        {
+            Message* rec = nullptr;
+            while (m_ring.tryPop(rec)) {
+                recordPool().release(rec);
+            }
+        }
+    };
+
+    std::mutex                                 ringMutex;
+    std::vector<std::shared_ptr<ProducerRing>> rings;
+    std::atomic<Uint64>                        ringGeneration{ 0 };
+
+    /// Ring of the calling thread, readable without taking ringMutex
+    thread_local ProducerRing* currentRing = nullptr;
+
+    /// Logging thread was running when fork() was called
+    bool restartAfterFork = false;
+
+    /**
+     * @brief Registers the calling thread's ring on first use and marks it
+     * detached on thread exit, the collector frees it once drained.
+     */
+    class ThreadRing
+    {
+      public:
+        std::shared_ptr<ProducerRing> m_ring;
+
+        ThreadRing()
+            : m_ring{ std::make_shared<ProducerRing>() }
+        {
+            std::lock_guard<std::mutex> lock(ringMutex);
+            rings.push_back(m_ring);
+            ringGeneration.fetch_add(1, std::memory_order_release);
+            currentRing = m_ring.get();
+        }
+
+        ThreadRing(const ThreadRing&)            = delete;
+        ThreadRing& operator=(const ThreadRing&) = delete;
+
+        ~ThreadRing()
+        {
+            currentRing = nullptr;
+            m_ring->m_detached.store(true, std::memory_order_release);
+            ringGeneration.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    ProducerRing& threadRing()
+    {
+        thread_local ThreadRing ring;
+        return *ring.m_ring;
+    }
+
+    /**
+     * @brief Refreshes the collector's private copy of the registry when a
+     * thread registered or exited, dropping detached rings that are empty.
+     */
+    void refreshRings(std::vector<std::shared_ptr<ProducerRing>>& local,
+                      Uint64&                                     seen)
+    {
+        Uint64 gen = ringGeneration.load(std::memory_order_acquire);
+        if (gen == seen) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(ringMutex);
+        rings.erase(std::remove_if(rings.begin(),
+                                   rings.end(),
+                                   [](const auto& r) {
+                                       return r->m_detached.load(
+                                                  std::memory_order_acquire)
+                                              && r->m_ring.empty();
+                                   }),
+                    rings.end());
+        local = rings;
+        seen  = gen;
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief Logical CPUs of the physical cores known to CpuTopology.
+     *
+     * Each core is described by its thread_siblings mask as CpuSet::cWordBits
+     * wide words paired with their position, which CpuSet::fromCoreMasks()
+     * turns back into the list of CPUs.
+     */
+    std::vector<std::vector<int>> physicalCores()
+    {
+        std::vector<std::vector<int>> cores;
+        for (const auto& masks : CpuTopology::get().processorMap) {
+            std::vector<int> cpus = CpuSet::fromCoreMasks(masks).toList();
+            if (!cpus.empty()) {
+                cores.push_back(std::move(cpus));
+            }
+        }
+        return cores;
+    }
+
+    /**
+     * @brief Logical CPUs of the last core of a package.
+     *
+     * @param cpu A CPU of the package, the first package is used when the CPU
+     * is negative or unknown.
+     */
+    std::vector<int> lastCoreOfPackage(int cpu)
+    {
+        const CpuDomain& machine = CpuTopology::get().domainTree;
+        if (machine.children.empty()) {
+            return {};
+        }
+        const CpuDomain* domain = &machine.children.front();
+        for (const auto& package : machine.children) {
+            if (cpu >= 0 && package.cpus.test(cpu)) {
+                domain = &package;
+                break;
+            }
+        }
+        while (domain->level != DomainLevel::eCore
+               && !domain->children.empty()) {
+            domain = &domain->children.back();
+        }
+        return domain->cpus.toList();
+    }
+
+    /**
+     * @brief Nice value of the calling thread, Linux keeps one per thread.
+     */
+    int threadNice()
+    {
+        id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+        errno    = 0;
+        int nice = getpriority(PRIO_PROCESS, tid);
+        return errno == 0 ? nice : 0;
+    }
+
+    /**
+     * @brief Affinity and scheduling the logging thread started with, which
+     * the default placement restores.
+     */
+    struct InheritedPlacement
+    {
+        CpuSet      cpus;
+        int         policy;
+        sched_param param;
+        int         nice;
+
+        static InheritedPlacement ofThisThread()
+        {
+            InheritedPlacement inherited{
+                CpuSet::ofThread(pthread_self()), SCHED_OTHER, {}, threadNice()
+            };
+            pthread_getschedparam(
+                pthread_self(), &inherited.policy, &inherited.param);
+            return inherited;
+        }
+    };
+
+    /**
+     * @brief CPUs the logging thread should be restricted to, empty to leave
+     * the affinity alone.
+     */
+    std::vector<int> placementCpus(const ThreadPlacement& placement)
+    {
+        using Affinity = ThreadPlacement::Affinity;
+
+        std::vector<int> cpus;
+        switch (placement.m_affinity) {
+            case Affinity::eNone:
+                break;
+            case Affinity::eCpus:
+                cpus = placement.m_cpus;
+                break;
+            case Affinity::eLastCore:
+                // The package of the given CPU, or the one we are running on
+                cpus = lastCoreOfPackage(placement.m_cpus.empty()
+                                             ? sched_getcpu()
+                                             : placement.m_cpus.front());
+                break;
+            case Affinity::eSmtSiblings: {
+                auto& housekeeping   = placement.m_cpus;
+                auto  isHousekeeping = [&housekeeping](int cpu) {
+                    return std::find(housekeeping.begin(),
+                                     housekeeping.end(),
+                                     cpu)
+                           != housekeeping.end();
+                };
+                for (const auto& core : physicalCores()) {
+                    if (std::any_of(core.begin(), core.end(), isHousekeeping)) {
+                        for (int cpu : core) {
+                            if (!isHousekeeping(cpu)) {
+                                cpus.push_back(cpu);
+                            }
+                        }
+                    }
+                }
+                // Without SMT share the housekeeping CPUs themselves
+                if (cpus.empty()) {
+                    cpus = housekeeping;
+                }
+                break;
+            }
+        }
+        return cpus;
+    }
+#endif
+
+} // namespace
+
 std::shared_ptr<LogWriter> LogWriter::instance = nullptr;
 std::mutex                 LogWriter::instanceMutex;
+// All levels are enabled by default
+std::atomic<Uint32> LogWriter::s_levelMask{ ~0U };
+// The overflow queue is unbounded by default
+size_t                  LogWriter::s_queueCapacity  = 0;
+OverflowPolicy          LogWriter::s_overflowPolicy = OverflowPolicy::eBlock;
+Priority::PriorityLevel LogWriter::s_overflowThreshold =
+    Priority::PriorityLevel::eWarning;
+std::atomic<Uint64> LogWriter::s_dropped{ 0 };
+std::atomic<Uint64> LogWriter::s_blocked{ 0 };
+// The logging thread is placed like any other thread by default
+std::mutex      LogWriter::s_placementMutex;
+ThreadPlacement LogWriter::s_placement{};
 
 // Class LogWriter begins
 void
 LogWriter::loggerThread()
 {
-    while (m_running) {
-        if (!m_queue.empty()) {
-            Message msg = m_queue.dequeue();
+    using Entry = std::tuple<Uint64, size_t, Message*>; // (time, order, msg)
+
+    std::vector<std::shared_ptr<ProducerRing>> local;
+    std::vector<ProducerRing*>                 spilled;
+    std::vector<Entry>                         batch;
+    Uint64                                     seen  = ~0ULL;
+    size_t                                     first = 0;
+    Message*                                   rec   = nullptr;
+    auto&                                      pool  = recordPool();
+
+    batch.reserve(cRingBurst * 16);
+
+    auto lastSummary = std::chrono::steady_clock::now();
+    auto summarise   = [this](Message& summary) { m_logger->write(summary); };
+
+    auto pending = [&] {
+        for (auto& r : local) {
+            if (!r->m_ring.empty())
+                return true;
+        }
+        return !m_queue.empty();
+    };
+
+    // Keep draining after stop() so that nothing queued before it is lost
+    while (true) {
+        if (m_placementChanged.exchange(false)) {
+            applyPlacement();
+        }
+
+        // The queue first: a ring whose thread spilled a record into it is
+        // then seen as spilled below, and emptied so that the spilled record
+        // does not overtake the older ones left in the ring
+        batch.clear();
+        while (!m_queue.empty()) {
+            rec = pool.acquire(m_queue.dequeue());
+            batch.emplace_back(
+                rec->getTimestamp().getNanosecond(), batch.size(), rec);
+        }
+        refreshRings(local, seen);
+
+        // Poll the rings round-robin, starting one further each round so that
+        // no producer is always served last
+        spilled.clear();
+        for (size_t n = 0; n < local.size(); n++) {
+            auto& producer = *local[(first + n) % local.size()];
+            bool  all      = producer.m_spilled.load(std::memory_order_acquire);
+            for (size_t i = 0;
+                 (all || i < cRingBurst) && producer.m_ring.tryPop(rec);
+                 i++) {
+                batch.emplace_back(
+                    rec->getTimestamp().getNanosecond(), batch.size(), rec);
+            }
+            if (all) {
+                spilled.push_back(&producer);
+            }
+        }
+        first++;
+        // The thread stopped pushing to these rings, they are empty now
+        for (auto* producer : spilled) {
+            producer->m_spilled.store(false, std::memory_order_release);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSummary >= cSummaryInterval) {
+            LogSite::reportSuppressed(summarise);
+            lastSummary = now;
+        }
 
-            // FIXME: Find better way, move to assert
-            /*
-            if (msg.getMsg().find("Empty Queue") != String::npos) {
-                continue;
+        if (batch.empty()) {
+            if (m_state.load(std::memory_order_acquire) != State::eRunning) {
+                LogSite::reportSuppressed(summarise);
+                break;
             }
-            */
-            m_logger->write(msg);
+            // Sleep until a producer wakes us up, the timeout covers a
+            // notification that raced with the emptiness check and threads
+            // which exited since the last registry refresh
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_waitCond.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                return m_state.load(std::memory_order_acquire)
+                           != State::eRunning
+                       || pending()
+                       || ringGeneration.load(std::memory_order_acquire)
+                              != seen;
+            });
+            continue;
+        }
+
+        // Each ring is already in order, merge the threads by timestamp.
+        // Sorting on (timestamp, collection order) keeps equal timestamps in
+        // order without the scratch buffer std::stable_sort would allocate.
+        std::sort(batch.begin(), batch.end());
+        for (auto& entry : batch) {
+            m_logger->write(*std::get<2>(entry));
+            pool.release(std::get<2>(entry));
         }
     }
 }
@@ -60,77 +422,492 @@ LogWriter::loggerThread()
 LogWriter::LogWriter()
     : m_thread{}
     , m_logger{ std::make_unique<ConsoleLogger>() } // Default to ConsoleLogger
-    , m_running{ false }
+    , m_state{ State::eIdle }
+    , m_lifecycleMutex{}
     , m_queue{}
+    , m_waitMutex{}
+    , m_waitCond{}
+    , m_placementChanged{ true }
+{
+    // Called with instanceMutex held
+    m_queue.configure(s_queueCapacity, s_overflowPolicy, s_overflowThreshold);
+}
+
+void
+LogWriter::applyPlacement()
+{
+#if defined(__linux__)
+    // Captured on the first call, before the thread is placed. A restarted
+    // logging thread is a new thread and captures its own.
+    thread_local const InheritedPlacement inherited =
+        InheritedPlacement::ofThisThread();
+    ThreadPlacement placement = getPlacement();
+
+    // The default placement undoes an earlier one on a running thread
+    std::vector<int> cpus = placementCpus(placement);
+    CpuSet           cpuset;
+    for (int cpu : cpus) {
+        if (cpu >= 0) {
+            cpuset.set(cpu);
+        }
+    }
+    if (cpuset.empty()) {
+        cpuset = inherited.cpus;
+    }
+    if (!cpuset.empty() && !(cpuset == CpuSet::ofThread(pthread_self()))) {
+        int err = cpuset.applyTo(pthread_self());
+        if (err != 0) {
+            std::cerr << "LogWriter: cannot set affinity: " << strerror(err)
+                      << std::endl;
+        }
+    }
+
+    // Leaving SCHED_IDLE comes first, the nice value of a SCHED_IDLE thread
+    // has no effect
+    int         policy = SCHED_OTHER;
+    sched_param param{};
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    if (placement.m_scheduling != ThreadPlacement::Scheduling::eIdle
+        && policy != inherited.policy) {
+        int err = pthread_setschedparam(
+            pthread_self(), inherited.policy, &inherited.param);
+        if (err != 0) {
+            std::cerr << "LogWriter: cannot restore the scheduling policy: "
+                      << strerror(err) << std::endl;
+        }
+    }
+
+    switch (placement.m_scheduling) {
+        case ThreadPlacement::Scheduling::eDefault:
+            if (threadNice() != inherited.nice
+                && setpriority(PRIO_PROCESS,
+                               static_cast<id_t>(syscall(SYS_gettid)),
+                               inherited.nice)
+                       != 0) {
+                std::cerr << "LogWriter: cannot restore the nice value: "
+                          << strerror(errno) << std::endl;
+            }
+            break;
+        case ThreadPlacement::Scheduling::eNice:
+            // Linux applies the nice value to the thread given by its id
+            if (setpriority(PRIO_PROCESS,
+                            static_cast<id_t>(syscall(SYS_gettid)),
+                            placement.m_nice)
+                != 0) {
+                std::cerr << "LogWriter: cannot set nice value: "
+                          << strerror(errno) << std::endl;
+            }
+            break;
+        case ThreadPlacement::Scheduling::eIdle: {
+            sched_param param{};
+            int         err =
+                pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+            if (err != 0) {
+                std::cerr << "LogWriter: cannot set SCHED_IDLE: "
+                          << strerror(err) << std::endl;
+            }
+            break;
+        }
+    }
+#endif
+}
+
+void
+LogWriter::drainAtExit()
 {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (instance) {
+        instance->shutdown();
+    }
 }
 
 std::shared_ptr<LogWriter>
 LogWriter::getLogWriter()
 {
+    static std::once_flag atExitFlag;
+    // Registered after all static objects are constructed, so it runs before
+    // any of them (Priority strings, std::cout users) are destroyed.
+    std::call_once(atExitFlag, [] {
+        std::atexit(&LogWriter::drainAtExit);
+#if defined(__linux__)
+        pthread_atfork(&LogWriter::forkPrepare,
+                       &LogWriter::forkParent,
+                       &LogWriter::forkChild);
+#endif
+    });
+
     std::lock_guard<std::mutex> lock(instanceMutex);
     if (!instance) {
         instance = std::shared_ptr<LogWriter>(new LogWriter());
     }
-    if (instance->m_running == false)
+    if (instance->m_state.load() == State::eIdle) {
         instance->start();
+    }
     return instance;
 }
 
+LogWriter&
+LogWriter::current()
+{
+    // Only a stopped, paused or closed writer goes through instanceMutex
+    thread_local std::shared_ptr<LogWriter> cached;
+    if (!cached
+        || cached->m_state.load(std::memory_order_acquire) != State::eRunning) {
+        cached = getLogWriter();
+    }
+    return *cached;
+}
+
 void
 LogWriter::setLogger(std::unique_ptr<ILogger> logger)
+{
+    // The logging thread may be writing to the current logger
+    replaceLogger([&](std::unique_ptr<ILogger>) { return std::move(logger); });
+}
+
+void
+LogWriter::replaceLogger(
+    const std::function<std::unique_ptr<ILogger>(std::unique_ptr<ILogger>)>&
+        replace)
 {
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    if (!instance) {
+        instance = std::shared_ptr<LogWriter>(new LogWriter());
+    }
+
+    // A closed instance writes synchronously under m_lifecycleMutex
+    std::unique_lock<std::mutex> lifecycle(instance->m_lifecycleMutex);
+    bool restart = instance->m_state.load() == State::eRunning;
+    instance->stopThread();
+    instance->m_logger = replace(std::move(instance->m_logger));
+    lifecycle.unlock();
+    if (restart) {
+        instance->start();
+    }
+}
+
+void
+LogWriter::setLevel(Priority::PriorityLevel level)
+{
+    s_levelMask.store(Priority::maskUpTo(level), std::memory_order_relaxed);
+}
+
+void
+LogWriter::setLevelMask(Uint32 mask)
+{
+    s_levelMask.store(mask, std::memory_order_relaxed);
+}
+
+Uint32
+LogWriter::getLevelMask()
+{
+    return s_levelMask.load(std::memory_order_relaxed);
+}
+
+void
+LogWriter::setOverflowPolicy(OverflowPolicy          policy,
+                             size_t                  capacity,
+                             Priority::PriorityLevel threshold)
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    s_queueCapacity     = capacity;
+    s_overflowPolicy    = policy;
+    s_overflowThreshold = threshold;
+    if (instance) {
+        instance->m_queue.configure(capacity, policy, threshold);
+    }
+}
+
+void
+LogWriter::setPlacement(const ThreadPlacement& placement)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_placementMutex);
+        s_placement = placement;
+    }
     std::lock_guard<std::mutex> lock(instanceMutex);
     if (instance) {
-        instance->m_logger = std::move(logger);
-    } else {
-        instance           = std::shared_ptr<LogWriter>(new LogWriter());
-        instance->m_logger = std::move(logger);
+        instance->m_placementChanged = true;
+        instance->m_waitCond.notify_one();
     }
 }
 
+ThreadPlacement
+LogWriter::getPlacement()
+{
+    std::lock_guard<std::mutex> lock(s_placementMutex);
+    return s_placement;
+}
+
+Uint64
+LogWriter::getDroppedCount()
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    return s_dropped.load() + (instance ? instance->m_queue.getDropped() : 0);
+}
+
+Uint64
+LogWriter::getBlockedCount()
+{
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    return s_blocked.load() + (instance ? instance->m_queue.getBlocked() : 0);
+}
+
+LogWriter::State
+LogWriter::getState() const
+{
+    return m_state.load(std::memory_order_acquire);
+}
+
 void
 LogWriter::start()
 {
-    if (m_running) {
+    std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+    if (m_state.load() != State::eIdle) {
         return;
     }
-    m_running = true;
-    m_thread  = std::thread(&LogWriter::loggerThread, this);
+    m_state            = State::eRunning;
+    m_placementChanged = true;
+    m_thread           = std::thread(&LogWriter::loggerThread, this);
 }
 
 void
-LogWriter::stop()
+LogWriter::stopThread()
 {
-    if (!m_running) {
+    if (m_state.load() != State::eRunning) {
         return;
     }
 
-    // Wait for queue to be empty
-    while (!m_queue.empty()) {
-        // Sleep for 0.01 seconds
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // The logging thread drains the rings and the queue before it exits
+    m_state = State::eStopping;
+    m_waitCond.notify_one();
+    m_thread.join();
+    m_logger->flush();
+    m_state = State::eIdle;
+}
+
+void
+LogWriter::shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+    if (m_state.load() == State::eClosed) {
+        return;
     }
+    stopThread();
+    m_state = State::eClosed;
 
-    m_running = false;
-    m_logger->flush();
-    m_thread.join();
+    // Pick up whatever producers pushed while the logging thread exited,
+    // later messages are written synchronously by submit(). A producer which
+    // still saw the writer open may be pushing, sweep again until none is.
+    std::vector<std::shared_ptr<ProducerRing>> local;
+    Uint64                                     seen = ~0ULL;
+    refreshRings(local, seen);
+    auto&    pool  = recordPool();
+    Message* rec   = nullptr;
+    bool     wrote = false;
+    bool     busy  = true;
+    while (busy) {
+        busy = false;
+        for (auto& ring : local) {
+            busy = busy || ring->m_submitting.load();
+        }
+        for (auto& ring : local) {
+            while (ring->m_ring.tryPop(rec)) {
+                m_logger->write(*rec);
+                pool.release(rec);
+                wrote = true;
+            }
+        }
+        while (!m_queue.empty()) {
+            m_logger->write(m_queue.dequeue());
+            wrote = true;
+        }
+        if (busy) {
+            std::this_thread::yield();
+        }
+    }
+    if (wrote) {
+        m_logger->flush();
+    }
 
-    instance.reset();
+    // Nobody drains the queue any more, do not let producers wait on it
+    m_queue.close();
+}
+
+void
+LogWriter::stop()
+{
+    shutdown();
+
+    // Only drop the singleton if it is still this instance, and release it
+    // after instanceMutex is unlocked. Nothing touches this object once the
+    // reference is gone, the caller may hold the last other one.
+    std::shared_ptr<LogWriter> self;
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex);
+        if (instance.get() == this) {
+            self = std::move(instance);
+        }
+    }
+}
+
+void
+LogWriter::forkPrepare()
+{
+    // Held across fork(), so that neither the instance nor the ring registry
+    // is halfway through a change when the address space is copied
+    instanceMutex.lock();
+    restartAfterFork = false;
+    if (instance) {
+        std::lock_guard<std::mutex> lock(instance->m_lifecycleMutex);
+        restartAfterFork = instance->m_state.load() == State::eRunning;
+        instance->stopThread();
+        // Loggers pause threads of their own and flush buffered output, so
+        // that it is not written by both processes
+        instance->m_logger->forkPrepare();
+    }
+    ringMutex.lock();
+}
+
+void
+LogWriter::forkParent()
+{
+    ringMutex.unlock();
+    if (instance) {
+        instance->m_logger->forkParent();
+        if (restartAfterFork) {
+            instance->start();
+        }
+    }
+    instanceMutex.unlock();
+}
+
+void
+LogWriter::forkChild()
+{
+    // Only the forking thread exists in the child. Messages still in the
+    // rings were logged by the parent, which writes them itself, and the
+    // rings of the other threads will never be detached by their owners.
+    auto&    pool = recordPool();
+    Message* rec  = nullptr;
+    for (auto& ring : rings) {
+        while (ring->m_ring.tryPop(rec)) {
+            pool.release(rec);
+        }
+        // A thread interrupted in submit() by the fork does not exist here
+        ring->m_spilled.store(false, std::memory_order_relaxed);
+        ring->m_submitting.store(false, std::memory_order_relaxed);
+        if (ring.get() != currentRing) {
+            ring->m_detached.store(true, std::memory_order_release);
+        }
+    }
+    ringGeneration.fetch_add(1, std::memory_order_release);
+    ringMutex.unlock();
+
+    if (instance) {
+        // The inherited instance's mutexes may be owned by threads which do
+        // not exist here, so it is leaked rather than destroyed; the fresh
+        // one takes over the logger.
+        auto fresh      = std::shared_ptr<LogWriter>(new LogWriter());
+        fresh->m_logger = std::move(instance->m_logger);
+        fresh->m_logger->forkChild();
+        new std::shared_ptr<LogWriter>(std::move(instance));
+        instance = std::move(fresh);
+        if (restartAfterFork) {
+            instance->start();
+        }
+    }
+    instanceMutex.unlock();
 }
 
 LogWriter::~LogWriter()
 {
-    stop();
+    // Called from the static destructor of 'instance' as well, so it must not
+    // reset the singleton itself.
+    shutdown();
+
+    // Keep the counters across instances
+    s_dropped += m_queue.getDropped();
+    s_blocked += m_queue.getBlocked();
 }
 
 void
 LogWriter::log(std::vector<Message>& msgs)
 {
+    auto& pool = recordPool();
     for (auto& msg : msgs) {
-        m_queue.enqueue(msg);
+        submit(pool.acquire(msg));
     }
 }
 
+void
+LogWriter::submit(Message* rec)
+{
+    // Logged after the exit drain or stop(), nothing collects the rings any
+    // more
+    auto writeNow = [this](Message* closed) {
+        std::lock_guard<std::mutex> lock(m_lifecycleMutex);
+        m_logger->write(*closed);
+        recordPool().release(closed);
+    };
+    if (m_state.load(std::memory_order_acquire) == State::eClosed) {
+        writeNow(rec);
+        return;
+    }
+
+    // Announced before the state is checked again: either shutdown() sees
+    // the flag and sweeps after the push, or this thread sees it closed
+    auto& producer = threadRing();
+    producer.m_submitting.store(true);
+    if (m_state.load() == State::eClosed) {
+        producer.m_submitting.store(false, std::memory_order_release);
+        writeNow(rec);
+        return;
+    }
+
+    bool wasEmpty = producer.m_ring.empty();
+    if (producer.m_spilled.load(std::memory_order_acquire)
+        || !producer.m_ring.tryPush(rec)) {
+        // Set before the record is queued, so that the collector finding it
+        // in the queue also finds the ring spilled
+        producer.m_spilled.store(true, std::memory_order_release);
+        m_queue.enqueue(*rec);
+        recordPool().release(rec);
+    }
+    producer.m_submitting.store(false, std::memory_order_release);
+
+    // The collector only sleeps once every ring is empty
+    if (wasEmpty) {
+        m_waitCond.notify_one();
+    }
+}
+
+void
+LogWriter::log(const Message& msg)
+{
+    submit(recordPool().acquire(msg));
+}
+
+void
+LogWriter::vlogf(Priority::PriorityLevel level, const char* fmt, va_list args)
+{
+    if (!isEnabled(level)) {
+        return;
+    }
+    Priority priority(level);
+    Message* rec = recordPool().acquire(std::string_view(), priority);
+    rec->vformat(fmt, args);
+    submit(rec);
+}
+
+void
+LogWriter::logf(Priority::PriorityLevel level, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vlogf(level, fmt, args);
+    va_end(args);
+}
+
 // Class LogWriter ends
 } // namespace Au::Logger
@@ -27,11 +27,84 @@
  */
 
 #include "Au/Logger/Logger.hh"
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace Au::Logger {
 
+namespace {
+
+    // On-disk layout of an MmapRingLogger file: a RingHeader followed by
+    // 'capacity' bytes of records. head and tail are byte offsets which only
+    // grow, their position in the ring is (offset & (capacity - 1)).
+    constexpr char   cRingMagic[8] = { 'A', 'U', 'L', 'O', 'G', 'R', 'N', 'G' };
+    constexpr Uint32 cRingVersion  = 2;
+    constexpr Uint32 cRingPadding  = 0xFFFFFFFF; ///< Skip to the ring start
+
+    struct RingHeader
+    {
+        char   magic[8];
+        Uint32 version;
+        Uint32 headerSize;
+        Uint64 capacity;
+        Uint64 head; ///< End of the newest committed record
+        Uint64 tail; ///< Start of the oldest record
+        Uint64 reserved[3];
+    };
+
+    struct RecordHeader
+    {
+        Uint32 length;    ///< Payload bytes or cRingPadding
+        Uint32 level;     ///< Priority::PriorityLevel of the message
+        Uint64 timestamp; ///< Nanoseconds since the epoch
+    };
+
+    static_assert(sizeof(RingHeader) == 64, "RingHeader must be 64 bytes");
+
+    // Records are padded to the record header size, so the space left before
+    // the end of the ring can always hold at least a padding header
+    constexpr Uint64 cRecordAlign = sizeof(RecordHeader);
+
+    Uint64 recordSize(Uint64 length)
+    {
+        return (sizeof(RecordHeader) + length + cRecordAlign - 1)
+               & ~(cRecordAlign - 1);
+    }
+
+    /**
+     * @brief Offset of the record following the one at 'offset'.
+     */
+    Uint64 nextRecord(const unsigned char* data, Uint64 capacity, Uint64 offset)
+    {
+        Uint64       pos = offset & (capacity - 1);
+        RecordHeader rec;
+        std::memcpy(&rec, data + pos, sizeof(rec));
+        if (rec.length == cRingPadding) {
+            return offset + (capacity - pos);
+        }
+        return offset + recordSize(rec.length);
+    }
+
+} // namespace
+
 // Class GenericLogger begins
 void
 GenericLogger::write(const Message& msg)
@@ -147,6 +220,879 @@ FileLogger::~FileLogger()
 
 // Class FileLogger ends
 
+// Class RotatingFileLogger begins
+RotatingFileLogger::RotatingFileLogger(const String&        filename,
+                                       Uint64               maxBytes,
+                                       std::chrono::seconds maxAge,
+                                       Uint32               maxFiles,
+                                       PostProcessHook      hook)
+    : m_filename{ filename }
+    , m_maxBytes{ maxBytes }
+    , m_maxAge{ maxAge }
+    , m_maxFiles{ maxFiles }
+    , m_hook{ std::move(hook) }
+    , m_file{ nullptr }
+    , m_bytes{ 0 }
+    , m_opened{}
+    , m_sequence{ 1 }
+    , m_workMutex{}
+    , m_workCond{}
+    , m_pending{}
+    , m_segments{}
+    , m_stopping{ false }
+    , m_pausing{ false }
+    , m_worker{}
+{
+    adoptSegments();
+    open();
+    m_worker = std::thread(&RotatingFileLogger::postProcessThread, this);
+}
+
+void
+RotatingFileLogger::adoptSegments()
+{
+    // Segments of earlier runs are "<filename>.<n>", possibly with a suffix
+    // added by the post-processing hook
+    namespace fs = std::filesystem;
+    fs::path        active(m_filename);
+    fs::path        dir = active.has_parent_path() ? active.parent_path() : ".";
+    String          prefix = active.filename().string() + ".";
+    std::error_code ec;
+
+    std::vector<std::pair<Uint64, String>> found;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        String name = it->path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        Uint64      number = 0;
+        const char* first  = name.data() + prefix.size();
+        const char* last   = name.data() + name.size();
+        auto [next, err]   = std::from_chars(first, last, number);
+        if (err != std::errc() || (next != last && *next != '.')) {
+            continue;
+        }
+        found.emplace_back(number, it->path().string());
+    }
+    std::sort(found.begin(), found.end());
+
+    for (auto& [number, path] : found) {
+        m_sequence = std::max(m_sequence, number + 1);
+        m_segments.push_back(path);
+    }
+    while (m_segments.size() > m_maxFiles) {
+        std::remove(m_segments.front().c_str());
+        m_segments.pop_front();
+    }
+}
+
+void
+RotatingFileLogger::open()
+{
+    m_file   = fopen(m_filename.c_str(), "a");
+    m_bytes  = 0;
+    m_opened = std::chrono::steady_clock::now();
+    if (m_file == nullptr) {
+        std::cerr << "Error opening file: " << m_filename << std::endl;
+        return;
+    }
+    // Appending to a file left by an earlier run counts towards the limit
+    fseek(m_file, 0, SEEK_END);
+    long size = ftell(m_file);
+    m_bytes   = size > 0 ? static_cast<Uint64>(size) : 0;
+}
+
+void
+RotatingFileLogger::rotate()
+{
+    if (m_file != nullptr) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+
+    // Segment names only grow, so a segment is never renamed again while the
+    // background thread may still be working on it
+    String          segment;
+    std::error_code ec;
+    do {
+        segment = m_filename + "." + std::to_string(m_sequence++);
+    } while (std::filesystem::exists(segment, ec));
+
+    if (std::rename(m_filename.c_str(), segment.c_str()) == 0) {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_pending.push_back(segment);
+        m_workCond.notify_all();
+    } else {
+        std::cerr << "Error rotating file: " << m_filename << std::endl;
+    }
+
+    open();
+}
+
+void
+RotatingFileLogger::postProcessThread()
+{
+    std::unique_lock<std::mutex> lock(m_workMutex);
+    while (true) {
+        m_workCond.wait(lock, [this] {
+            return m_stopping || m_pausing || !m_pending.empty();
+        });
+        if (m_pausing || m_pending.empty()) {
+            break;
+        }
+
+        // Leave the segment queued while it is processed so that
+        // waitForPostProcessing() also covers the one in flight
+        String segment = m_pending.front();
+        lock.unlock();
+
+        String result = segment;
+        if (m_hook) {
+            try {
+                result = m_hook(segment);
+            } catch (const std::exception& e) {
+                std::cerr << "Error post-processing " << segment << ": "
+                          << e.what() << std::endl;
+            }
+        }
+
+        std::vector<String> expired;
+        lock.lock();
+        m_pending.pop_front();
+        m_segments.push_back(result);
+        while (m_segments.size() > m_maxFiles) {
+            expired.push_back(m_segments.front());
+            m_segments.pop_front();
+        }
+        m_workCond.notify_all();
+
+        lock.unlock();
+        for (auto& path : expired) {
+            std::remove(path.c_str());
+        }
+        lock.lock();
+    }
+}
+
+void
+RotatingFileLogger::write(const Message& msg)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (m_file == nullptr) {
+        // The last open failed, the directory may be back by now
+        if (now - m_opened >= cReopenInterval) {
+            open();
+        }
+    } else if ((m_maxBytes != 0 && m_bytes >= m_maxBytes)
+               || (m_maxAge.count() != 0 && now - m_opened >= m_maxAge)) {
+        rotate();
+    }
+
+    if (m_file != nullptr) {
+        int written = fprintf(m_file, "%s\n", msg.getMsg().c_str());
+        if (written > 0) {
+            m_bytes += static_cast<Uint64>(written);
+        }
+    }
+}
+
+void
+RotatingFileLogger::flush()
+{
+    if (m_file != nullptr) {
+        fflush(m_file);
+    }
+}
+
+String
+RotatingFileLogger::getLoggerType() const
+{
+    return "RotatingFileLogger";
+}
+
+void
+RotatingFileLogger::waitForPostProcessing()
+{
+    std::unique_lock<std::mutex> lock(m_workMutex);
+    m_workCond.wait(lock, [this] { return m_pending.empty(); });
+}
+
+void
+RotatingFileLogger::forkPrepare()
+{
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_pausing = true;
+    }
+    m_workCond.notify_all();
+    // Finishes the segment in flight, the others stay queued
+    m_worker.join();
+    m_pausing = false;
+}
+
+void
+RotatingFileLogger::forkParent()
+{
+    m_worker = std::thread(&RotatingFileLogger::postProcessThread, this);
+}
+
+void
+RotatingFileLogger::forkChild()
+{
+    // The parent post-processes the segments it rotated
+    m_pending.clear();
+    m_worker = std::thread(&RotatingFileLogger::postProcessThread, this);
+}
+
+RotatingFileLogger::~RotatingFileLogger()
+{
+    if (m_file != nullptr) {
+        fclose(m_file);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_stopping = true;
+    }
+    m_workCond.notify_all();
+    // Segments already handed off are still processed before returning
+    m_worker.join();
+}
+
+// Class RotatingFileLogger ends
+
+// Class MmapRingLogger begins
+MmapRingLogger::MmapRingLogger(const String& filename, Uint64 capacity)
+    : m_filename{ filename }
+    , m_size{ 0 }
+    , m_map{ nullptr }
+{
+#if defined(__linux__)
+    Uint64 cap = cRecordAlign * 2;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    m_size = sizeof(RingHeader) + cap;
+    mapRing();
+#else
+    std::cerr << "MmapRingLogger is not supported on this platform"
+              << std::endl;
+#endif
+}
+
+void
+MmapRingLogger::mapRing()
+{
+#if defined(__linux__)
+    Uint64 cap = m_size - sizeof(RingHeader);
+    int    fd  = ::open(m_filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error opening file: " << m_filename << std::endl;
+        return;
+    }
+
+    struct stat st = {};
+    bool        reuse =
+        fstat(fd, &st) == 0 && static_cast<Uint64>(st.st_size) == m_size;
+    if (!reuse && ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+        std::cerr << "Error resizing file: " << m_filename << std::endl;
+        ::close(fd);
+        return;
+    }
+
+    void* map =
+        mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << m_filename << std::endl;
+        return;
+    }
+    m_map = static_cast<unsigned char*>(map);
+
+    auto hdr = reinterpret_cast<RingHeader*>(m_map);
+    reuse    = reuse && std::memcmp(hdr->magic, cRingMagic, 8) == 0
+            && hdr->version == cRingVersion && hdr->capacity == cap
+            && hdr->head - hdr->tail <= cap;
+    if (!reuse) {
+        std::memset(hdr, 0, sizeof(RingHeader));
+        hdr->version    = cRingVersion;
+        hdr->headerSize = sizeof(RingHeader);
+        hdr->capacity   = cap;
+        // The magic goes last, a half initialized file is never reused
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        std::memcpy(hdr->magic, cRingMagic, 8);
+    }
+#endif
+}
+
+void
+MmapRingLogger::write(const Message& msg)
+{
+    if (m_map == nullptr) {
+        return;
+    }
+
+    auto           hdr  = reinterpret_cast<RingHeader*>(m_map);
+    unsigned char* data = m_map + sizeof(RingHeader);
+    Uint64         cap  = hdr->capacity;
+    Uint64         head = hdr->head;
+    Uint64         tail = hdr->tail;
+
+    // Level and timestamp are in the record header, only the text is copied
+    std::string_view text = msg.getText();
+
+    Uint64 length = std::min<Uint64>(text.size(), cap - sizeof(RecordHeader));
+    Uint64 size   = recordSize(length);
+
+    // Evict the oldest records until 'bytes' more fit, tail is published
+    // before the space is reused so a reader never decodes torn records
+    auto makeRoom = [&](Uint64 bytes) {
+        if (head + bytes - tail <= cap) {
+            return;
+        }
+        while (head + bytes - tail > cap) {
+            tail = nextRecord(data, cap, tail);
+        }
+        __atomic_store_n(&hdr->tail, tail, __ATOMIC_RELEASE);
+    };
+
+    Uint64 pos = head & (cap - 1);
+    if (cap - pos < size) {
+        // The record would wrap, pad out the end of the ring instead
+        makeRoom(cap - pos);
+        RecordHeader pad = { cRingPadding, 0, 0 };
+        std::memcpy(data + pos, &pad, sizeof(pad));
+        head += cap - pos;
+        __atomic_store_n(&hdr->head, head, __ATOMIC_RELEASE);
+        pos = 0;
+    }
+
+    makeRoom(size);
+    RecordHeader rec = {
+        static_cast<Uint32>(length),
+        static_cast<Uint32>(msg.getPriority().getLevel()),
+        msg.getTimestamp().getNanosecond(),
+    };
+    std::memcpy(data + pos, &rec, sizeof(rec));
+    std::memcpy(data + pos + sizeof(rec), text.data(), length);
+    __atomic_store_n(&hdr->head, head + size, __ATOMIC_RELEASE);
+}
+
+void
+MmapRingLogger::flush()
+{
+    // The page cache already holds every record, only schedule writeback
+#if defined(__linux__)
+    if (m_map != nullptr) {
+        msync(m_map, m_size, MS_ASYNC);
+    }
+#endif
+}
+
+String
+MmapRingLogger::getLoggerType() const
+{
+    return "MmapRingLogger";
+}
+
+String
+MmapRingLogger::getFilename() const
+{
+    return m_filename;
+}
+
+void
+MmapRingLogger::forkChild()
+{
+#if defined(__linux__)
+    // The parent keeps writing to the shared mapping, two unsynchronised
+    // writers would corrupt the ring
+    if (m_map != nullptr) {
+        munmap(m_map, m_size);
+        m_map = nullptr;
+    }
+    if (m_size != 0) {
+        m_filename += "." + std::to_string(getpid());
+        mapRing();
+    }
+#endif
+}
+
+std::vector<MmapRingLogger::Record>
+MmapRingLogger::readRing(const String& filename)
+{
+    std::vector<Record> lines;
+    std::ifstream       in(filename, std::ios::binary);
+    if (!in) {
+        return lines;
+    }
+    std::vector<unsigned char> file((std::istreambuf_iterator<char>(in)),
+                                    std::istreambuf_iterator<char>());
+
+    RingHeader hdr;
+    if (file.size() < sizeof(hdr)) {
+        return lines;
+    }
+    std::memcpy(&hdr, file.data(), sizeof(hdr));
+    Uint64 cap = hdr.capacity;
+    if (std::memcmp(hdr.magic, cRingMagic, 8) != 0
+        || hdr.version != cRingVersion || hdr.headerSize != sizeof(RingHeader)
+        || cap < cRecordAlign || (cap & (cap - 1)) != 0
+        || file.size() != sizeof(RingHeader) + cap
+        || hdr.head - hdr.tail > cap) {
+        return lines;
+    }
+
+    const unsigned char* data = file.data() + sizeof(RingHeader);
+    for (Uint64 offset = hdr.tail; offset < hdr.head;) {
+        Uint64       pos = offset & (cap - 1);
+        RecordHeader rec;
+        std::memcpy(&rec, data + pos, sizeof(rec));
+        if (rec.length != cRingPadding) {
+            if (pos + sizeof(rec) + rec.length > cap) {
+                break; // Corrupt record
+            }
+            auto text = reinterpret_cast<const char*>(data + pos + sizeof(rec));
+            lines.push_back({ rec.timestamp,
+                              static_cast<Priority::PriorityLevel>(rec.level),
+                              String(text, rec.length) });
+        }
+        offset = nextRecord(data, cap, offset);
+    }
+    return lines;
+}
+
+MmapRingLogger::~MmapRingLogger()
+{
+#if defined(__linux__)
+    if (m_map != nullptr) {
+        munmap(m_map, m_size);
+    }
+#endif
+}
+
+// Class MmapRingLogger ends
+
+// Class CompositeLogger begins
+
+/**
+ * @brief One output of a CompositeLogger, with its level mask and, when
+ * asynchronous, its own queue and worker thread.
+ */
+class CompositeLogger::Sink
+{
+  public:
+    std::unique_ptr<ILogger> m_logger;
+    Uint32                   m_levelMask;
+    bool                     m_async;
+    LockingQueue             m_queue;
+    std::mutex               m_mutex;     ///< Serializes calls into m_logger
+    std::mutex               m_waitMutex; ///< Guards the flags below
+    std::condition_variable  m_waitCond;
+    bool                     m_busy;      ///< Worker is writing a message
+    bool                     m_stopping;
+    bool                     m_pausing;   ///< Exit, keeping the queue
+    std::thread              m_worker;
+
+    Sink(std::unique_ptr<ILogger> logger,
+         Uint32                   levelMask,
+         bool                     async,
+         size_t                   queueCapacity,
+         OverflowPolicy           policy)
+        : m_logger{ std::move(logger) }
+        , m_levelMask{ levelMask }
+        , m_async{ async }
+        , m_queue{}
+        , m_mutex{}
+        , m_waitMutex{}
+        , m_waitCond{}
+        , m_busy{ false }
+        , m_stopping{ false }
+        , m_pausing{ false }
+        , m_worker{}
+    {
+        if (m_async) {
+            m_queue.configure(queueCapacity, policy);
+            m_worker = std::thread(&Sink::run, this);
+        }
+    }
+
+    Sink(const Sink&)            = delete;
+    Sink& operator=(const Sink&) = delete;
+
+    void write(const Message& msg)
+    {
+        if (!m_async) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_logger->write(msg);
+            return;
+        }
+        // May block or drop according to the overflow policy, either way the
+        // caller only waits on this sink's own queue
+        if (m_queue.enqueue(msg)) {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_waitCond.notify_all();
+        }
+    }
+
+    void flush()
+    {
+        if (m_async) {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_waitCond.wait(lock,
+                            [this] { return !m_busy && m_queue.empty(); });
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_logger->flush();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        while (true) {
+            m_waitCond.wait(lock, [this] {
+                return m_stopping || m_pausing || !m_queue.empty();
+            });
+            if (m_pausing || m_queue.empty()) {
+                break;
+            }
+            m_busy = true;
+            lock.unlock();
+
+            Message msg = m_queue.dequeue();
+            {
+                std::lock_guard<std::mutex> sinkLock(m_mutex);
+                m_logger->write(msg);
+            }
+
+            lock.lock();
+            m_busy = false;
+            m_waitCond.notify_all();
+        }
+    }
+
+    /// Stops the worker around fork(), it finishes the message in flight
+    void pause()
+    {
+        if (m_async) {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_pausing = true;
+            }
+            m_waitCond.notify_all();
+            m_worker.join();
+            m_pausing = false;
+        }
+        m_logger->forkPrepare();
+    }
+
+    void resume(bool child)
+    {
+        if (child) {
+            m_logger->forkChild();
+        } else {
+            m_logger->forkParent();
+        }
+        if (m_async) {
+            // The parent writes what it had queued
+            while (child && !m_queue.empty()) {
+                m_queue.dequeue();
+            }
+            m_worker = std::thread(&Sink::run, this);
+        }
+    }
+
+    ~Sink()
+    {
+        if (m_async) {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+                m_stopping = true;
+            }
+            m_waitCond.notify_all();
+            // The worker drains its queue before exiting
+            m_worker.join();
+        }
+        m_logger->flush();
+    }
+};
+
+CompositeLogger::CompositeLogger()
+    : GenericLogger()
+    , m_sinks{}
+{
+}
+
+void
+CompositeLogger::addLogger(std::unique_ptr<ILogger> logger,
+                           Uint32                   levelMask,
+                           bool                     async,
+                           size_t                   queueCapacity,
+                           OverflowPolicy           policy)
+{
+    if (logger == nullptr) {
+        throw std::invalid_argument("CompositeLogger: null logger");
+    }
+    m_sinks.push_back(std::make_unique<Sink>(
+        std::move(logger), levelMask, async, queueCapacity, policy));
+}
+
+size_t
+CompositeLogger::getLoggerCount() const
+{
+    return m_sinks.size();
+}
+
+ILogger&
+CompositeLogger::getLogger(size_t index)
+{
+    return *m_sinks.at(index)->m_logger;
+}
+
+Uint64
+CompositeLogger::getDroppedCount(size_t index) const
+{
+    return m_sinks.at(index)->m_queue.getDropped();
+}
+
+void
+CompositeLogger::write(const Message& msg)
+{
+    Uint32 level = static_cast<Uint32>(msg.getPriority().getLevel());
+    for (auto& sink : m_sinks) {
+        if (sink->m_levelMask & level) {
+            sink->write(msg);
+        }
+    }
+}
+
+String
+CompositeLogger::getLoggerType() const
+{
+    return "CompositeLogger";
+}
+
+void
+CompositeLogger::flush()
+{
+    for (auto& sink : m_sinks) {
+        sink->flush();
+    }
+}
+
+void
+CompositeLogger::forkPrepare()
+{
+    for (auto& sink : m_sinks) {
+        sink->pause();
+    }
+}
+
+void
+CompositeLogger::forkParent()
+{
+    for (auto& sink : m_sinks) {
+        sink->resume(false);
+    }
+}
+
+void
+CompositeLogger::forkChild()
+{
+    for (auto& sink : m_sinks) {
+        sink->resume(true);
+    }
+}
+
+CompositeLogger::~CompositeLogger() = default;
+
+// Class CompositeLogger ends
+
+// Class JsonLogger begins
+JsonLogger::JsonLogger(const String& filename)
+    : m_filename{ filename == "-" ? String() : filename }
+    , m_file{ m_filename.empty() ? stdout : fopen(m_filename.c_str(), "a") }
+    , m_buffer{}
+{
+    if (m_file == nullptr) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+    }
+    m_buffer.reserve(512);
+}
+
+namespace {
+
+    void appendEscapedScalar(String& out, const char* p, const char* end)
+    {
+        static constexpr char cHex[] = "0123456789abcdef";
+
+        const char* run = p;
+        for (; p < end; ++p) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(run, p - run);
+            run = p + 1;
+            switch (c) {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                case '\b':
+                    out.append("\\b");
+                    break;
+                case '\f':
+                    out.append("\\f");
+                    break;
+                default: {
+                    char u[6] = { '\\',         'u', '0', '0',
+                                  cHex[c >> 4], cHex[c & 0xF] };
+                    out.append(u, sizeof(u));
+                    break;
+                }
+            }
+        }
+        out.append(run, end - run);
+    }
+
+    template<typename T>
+    void appendNumber(String& out, T value)
+    {
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, res.ptr - buf);
+    }
+
+} // namespace
+
+void
+JsonLogger::appendEscaped(String& out, std::string_view text)
+{
+    const char* p   = text.data();
+    const char* end = p + text.size();
+
+#if defined(__SSE2__)
+    // Copy 16 byte blocks which need no escaping straight through, only the
+    // block holding a special character goes through the scalar path
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control   = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i special =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                      _mm_cmpeq_epi8(v, backslash)),
+                         _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        int mask = _mm_movemask_epi8(special);
+        if (mask == 0) {
+            out.append(p, 16);
+            p += 16;
+            continue;
+        }
+        int first = __builtin_ctz(static_cast<unsigned>(mask));
+        out.append(p, first);
+        appendEscapedScalar(out, p + first, p + first + 1);
+        p += first + 1;
+    }
+#endif
+
+    appendEscapedScalar(out, p, end);
+}
+
+void
+JsonLogger::formatJson(const Message& msg, String& out)
+{
+    out.append("{\"ts\":");
+    appendNumber(out, msg.getTimestamp().getNanosecond());
+    out.append(",\"level\":\"");
+    out.append(msg.getPriority().getName());
+    out.append("\",\"msg\":\"");
+    appendEscaped(out, msg.getText());
+    out.push_back('"');
+
+    msg.forEachField([&out](const MessageField& field) {
+        out.append(",\"");
+        appendEscaped(out, field.m_key);
+        out.append("\":");
+        switch (field.m_type) {
+            case MessageField::Type::eInt:
+                appendNumber(out, field.m_int);
+                break;
+            case MessageField::Type::eUint:
+                appendNumber(out, field.m_uint);
+                break;
+            case MessageField::Type::eDouble:
+                if (std::isfinite(field.m_double)) {
+                    // Round trips exactly, to_chars for doubles needs GCC 11
+                    char buf[32];
+                    int  len =
+                        snprintf(buf, sizeof(buf), "%.17g", field.m_double);
+                    out.append(buf, len);
+                } else {
+                    out.append("null"); // JSON has no NaN or infinity
+                }
+                break;
+            case MessageField::Type::eBool:
+                out.append(field.m_bool ? "true" : "false");
+                break;
+            case MessageField::Type::eString:
+                out.push_back('"');
+                appendEscaped(out, field.m_string);
+                out.push_back('"');
+                break;
+        }
+    });
+    out.append("}\n");
+}
+
+void
+JsonLogger::write(const Message& msg)
+{
+    if (m_file != nullptr) {
+        m_buffer.clear();
+        formatJson(msg, m_buffer);
+        fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+    }
+}
+
+void
+JsonLogger::flush()
+{
+    if (m_file != nullptr) {
+        fflush(m_file);
+    }
+}
+
+String
+JsonLogger::getLoggerType() const
+{
+    return "JsonLogger";
+}
+
+JsonLogger::~JsonLogger()
+{
+    if (m_file != nullptr && m_file != stdout) {
+        fclose(m_file);
+    } else if (m_file != nullptr) {
+        fflush(m_file);
+    }
+}
+
+// Class JsonLogger ends
+
 // Class LoggerFactory begins
 std::unique_ptr<ILogger>
 LoggerFactory::createLogger(const String& loggerType, const String& loggerName)
@@ -157,6 +1103,12 @@ LoggerFactory::createLogger(const String& loggerType, const String& loggerName)
         return std::make_unique<DummyLogger>();
     } else if (loggerType == "FileLogger") {
         return std::make_unique<FileLogger>(loggerName);
+    } else if (loggerType == "RotatingFileLogger") {
+        return std::make_unique<RotatingFileLogger>(loggerName);
+    } else if (loggerType == "MmapRingLogger") {
+        return std::make_unique<MmapRingLogger>(loggerName);
+    } else if (loggerType == "JsonLogger") {
+        return std::make_unique<JsonLogger>(loggerName);
     } else {
         return nullptr;
     }
@@ -167,7 +1119,9 @@ void
 LoggerFactory::validateLoggerType(const String& loggerType)
 {
     if (loggerType != "ConsoleLogger" && loggerType != "DummyLogger"
-        && loggerType != "FileLogger") {
+        && loggerType != "FileLogger"
+        && loggerType != "RotatingFileLogger"
+        && loggerType != "MmapRingLogger" && loggerType != "JsonLogger") {
         throw std::invalid_argument("Invalid logger type");
     }
 }
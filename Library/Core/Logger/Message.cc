@@ -27,7 +27,10 @@
  */
 
 // C++ Standard header files
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -139,28 +142,6 @@ Timestamp::getNanosecond() const
 // Class Timestamp ends
 
 // Class Priority begins
-std::unique_ptr<std::map<Priority::PriorityLevel, String>> Priority::m_str_map;
-std::once_flag                                             Priority::initFlag;
-
-std::map<Priority::PriorityLevel, String>*
-Priority::getMap()
-{
-    if (m_str_map.get() == nullptr) {
-        std::call_once(initFlag, []() {
-            m_str_map = std::make_unique<std::map<PriorityLevel, String>>();
-            *(m_str_map.get()) = { { PriorityLevel::eFatal, "Fatal" },
-                                   { PriorityLevel::ePanic, "Panic" },
-                                   { PriorityLevel::eError, "Error" },
-                                   { PriorityLevel::eWarning, "Warning" },
-                                   { PriorityLevel::eInfo, "Info" },
-                                   { PriorityLevel::eNotice, "Notice" },
-                                   { PriorityLevel::eDebug, "Debug" },
-                                   { PriorityLevel::eTrace, "Trace" } };
-        });
-    }
-    return m_str_map.get();
-}
-
 Priority::Priority()
     : m_level{ PriorityLevel::eInfo }
 {
@@ -174,8 +155,22 @@ Priority::Priority(PriorityLevel level)
 String
 Priority::toStr() const
 {
-    auto map = Priority::getMap();
-    return map->at(this->m_level);
+    return String(getName());
+}
+
+Priority::PriorityLevel
+Priority::getLevel() const
+{
+    return m_level;
+}
+
+Uint32
+Priority::maskUpTo(PriorityLevel level)
+{
+    // Levels are powers of two ordered from most to least severe, so every
+    // level up to and including 'level' is the mask of all lower bits.
+    Uint32 bit = static_cast<Uint32>(level);
+    return bit | (bit - 1);
 }
 
 // Operator overloads to compare the priority
@@ -219,18 +214,224 @@ Priority::operator!=(const Priority& rhs) const
 
 // Class Message begins
 
-Message::Message(const String& msg)
-    : m_msg{ msg }
+Message::Message(std::string_view msg)
+    : m_heap{}
+    , m_heapCapacity{ 0 }
+    , m_length{ 0 }
+    , m_fieldBytes{ 0 }
     , m_priority{ Priority() }
     , m_timestamp{ Timestamp() }
 {
+    assign(msg);
 }
 
-Message::Message(const String& msg, Priority& priority)
-    : m_msg(msg)
+Message::Message(std::string_view msg, Priority& priority)
+    : m_heap{}
+    , m_heapCapacity{ 0 }
+    , m_length{ 0 }
+    , m_fieldBytes{ 0 }
     , m_priority{ priority }
     , m_timestamp{ Timestamp() }
 {
+    assign(msg);
+}
+
+Message::Message(const Message& other)
+    : m_heap{}
+    , m_heapCapacity{ 0 }
+    , m_length{ 0 }
+    , m_fieldBytes{ 0 }
+    , m_priority{ other.m_priority }
+    , m_timestamp{ other.m_timestamp }
+{
+    copyFrom(other);
+}
+
+Message::Message(Message&& other) noexcept
+    : m_heap{}
+    , m_heapCapacity{ 0 }
+    , m_length{ 0 }
+    , m_fieldBytes{ 0 }
+    , m_priority{ other.m_priority }
+    , m_timestamp{ other.m_timestamp }
+{
+    moveFrom(other);
+}
+
+Message&
+Message::operator=(const Message& other)
+{
+    if (this != &other) {
+        copyFrom(other);
+        m_priority  = other.m_priority;
+        m_timestamp = other.m_timestamp;
+    }
+    return *this;
+}
+
+Message&
+Message::operator=(Message&& other) noexcept
+{
+    if (this != &other) {
+        moveFrom(other);
+        m_priority  = other.m_priority;
+        m_timestamp = other.m_timestamp;
+    }
+    return *this;
+}
+
+void
+Message::assign(std::string_view text)
+{
+    m_length     = 0;
+    m_fieldBytes = 0;
+    std::memcpy(grow(text.size()), text.data(), text.size());
+    m_length = static_cast<Uint32>(text.size());
+}
+
+void
+Message::copyFrom(const Message& other)
+{
+    size_t used  = other.m_length + other.m_fieldBytes;
+    m_length     = 0;
+    m_fieldBytes = 0;
+    // A copy only needs what is used, drop a heap buffer it does not need
+    if (used <= cInlineCapacity) {
+        m_heap.reset();
+        m_heapCapacity = 0;
+    }
+    std::memcpy(grow(used), other.data(), used);
+    m_length     = other.m_length;
+    m_fieldBytes = other.m_fieldBytes;
+}
+
+void
+Message::moveFrom(Message& other)
+{
+    m_length     = other.m_length;
+    m_fieldBytes = other.m_fieldBytes;
+    if (other.m_heap) {
+        m_heap         = std::move(other.m_heap);
+        m_heapCapacity = other.m_heapCapacity;
+    } else {
+        m_heap.reset();
+        m_heapCapacity = 0;
+        std::memcpy(m_inline, other.m_inline, m_length + m_fieldBytes);
+    }
+    other.m_heapCapacity = 0;
+    other.m_length       = 0;
+    other.m_fieldBytes   = 0;
+}
+
+void
+Message::vformat(const char* fmt, va_list args)
+{
+    m_length     = 0;
+    m_fieldBytes = 0;
+
+    // Try the buffer at hand first, vsnprintf reports the full length
+    size_t  capacity = m_heap ? m_heapCapacity : cInlineCapacity;
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(data(), capacity, fmt, copy);
+    va_end(copy);
+    if (length < 0) {
+        return; // Encoding error, leave the text empty
+    }
+    if (static_cast<size_t>(length) >= capacity) {
+        vsnprintf(grow(length + 1), length + 1, fmt, args);
+    }
+    m_length = static_cast<Uint32>(length);
+}
+
+char*
+Message::grow(size_t bytes)
+{
+    size_t used     = m_length + m_fieldBytes;
+    size_t capacity = m_heap ? m_heapCapacity : cInlineCapacity;
+    if (used + bytes > capacity) {
+        size_t newCapacity = std::max(used + bytes, capacity * 2);
+        auto   heap        = std::make_unique<char[]>(newCapacity);
+        std::memcpy(heap.get(), data(), used);
+        m_heap         = std::move(heap);
+        m_heapCapacity = static_cast<Uint32>(newCapacity);
+    }
+    return data() + used;
+}
+
+// Field encoding: type (1 byte), key length (1 byte), key, then 8 bytes for
+// numbers, 1 byte for bools or a 4 byte length followed by the bytes for
+// strings. Values are copied unaligned with memcpy.
+Message&
+Message::appendField(MessageField::Type type,
+                     std::string_view   key,
+                     const void*        value,
+                     size_t             size)
+{
+    key          = key.substr(0, 255);
+    bool   isStr = type == MessageField::Type::eString;
+    Uint32 len   = static_cast<Uint32>(size);
+    size_t total = 2 + key.size() + (isStr ? sizeof(len) : 0) + size;
+
+    char* out = grow(total);
+    *out++    = static_cast<char>(type);
+    *out++    = static_cast<char>(key.size());
+    std::memcpy(out, key.data(), key.size());
+    out += key.size();
+    if (isStr) {
+        std::memcpy(out, &len, sizeof(len));
+        out += sizeof(len);
+    }
+    std::memcpy(out, value, size);
+
+    m_fieldBytes += static_cast<Uint32>(total);
+    return *this;
+}
+
+bool
+Message::nextField(size_t& offset, MessageField& field) const
+{
+    if (offset >= m_fieldBytes) {
+        return false;
+    }
+    const char* in = data() + m_length + offset;
+
+    field.m_type     = static_cast<MessageField::Type>(in[0]);
+    size_t keyLength = static_cast<unsigned char>(in[1]);
+    field.m_key      = std::string_view(in + 2, keyLength);
+    in += 2 + keyLength;
+
+    size_t size = 8;
+    switch (field.m_type) {
+        case MessageField::Type::eInt:
+            std::memcpy(&field.m_int, in, size);
+            break;
+        case MessageField::Type::eUint:
+            std::memcpy(&field.m_uint, in, size);
+            break;
+        case MessageField::Type::eDouble:
+            std::memcpy(&field.m_double, in, size);
+            break;
+        case MessageField::Type::eBool:
+            size         = 1;
+            field.m_bool = in[0] != 0;
+            break;
+        case MessageField::Type::eString: {
+            Uint32 len;
+            std::memcpy(&len, in, sizeof(len));
+            field.m_string = std::string_view(in + sizeof(len), len);
+            size           = sizeof(len) + len;
+            break;
+        }
+    }
+    offset += 2 + keyLength + size;
+    return true;
+}
+
+std::string_view
+Message::getText() const
+{
+    return std::string_view(data(), m_length);
 }
 
 String
@@ -238,8 +439,8 @@ Message::getMsg() const
 {
     // Example "Mon Sep 02 2024 11:31:36  : Info : This is a message"
     std::ostringstream oss;
-    oss << m_timestamp.getTimestamp() << " : " << std::left << std::setw(7)
-        << m_priority.toStr() << " : " << m_msg;
+    oss << m_timestamp.getTimestamp() << " : " << m_priority.getLabel()
+        << " : " << getText();
     return oss.str();
 }
 
@@ -28,20 +28,88 @@
 
 #include "Au/Logger/Queue.hh"
 
+#include <algorithm>
+
 namespace Au::Logger {
 
 // Class LockingQueue begins
 LockingQueue::LockingQueue()
     : m_mutex{}
+    , m_notFull{}
     , m_queue{}
+    , m_capacity{ 0 }
+    , m_policy{ OverflowPolicy::eBlock }
+    , m_threshold{ Priority::PriorityLevel::eWarning }
+    , m_closed{ false }
+    , m_dropped{ 0 }
+    , m_blocked{ 0 }
 {
 }
 
 void
-LockingQueue::enqueue(const Message& msg)
+LockingQueue::configure(size_t                  capacity,
+                        OverflowPolicy          policy,
+                        Priority::PriorityLevel threshold)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity  = capacity;
+    m_policy    = policy;
+    m_threshold = Priority(threshold);
+    // A larger (or no) bound may let blocked producers through
+    m_notFull.notify_all();
+}
+
+bool
+LockingQueue::enqueue(const Message& msg)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (full()) {
+        OverflowPolicy policy = m_policy;
+        if (policy == OverflowPolicy::eDropBelowPriority) {
+            // Priorities compare by level value, less severe is greater
+            if (msg.getPriority() > m_threshold) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            auto victim = std::find_if(
+                m_queue.begin(), m_queue.end(), [this](const Message& m) {
+                    return m.getPriority() > m_threshold;
+                });
+            if (victim != m_queue.end()) {
+                m_queue.erase(victim);
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                policy = OverflowPolicy::eBlock;
+            }
+        }
+
+        switch (policy) {
+            case OverflowPolicy::eBlock:
+                if (full()) {
+                    m_blocked.fetch_add(1, std::memory_order_relaxed);
+                    m_notFull.wait(lock,
+                                   [this] { return m_closed || !full(); });
+                    if (full()) {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+                break;
+            case OverflowPolicy::eDropNewest:
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case OverflowPolicy::eDropOldest:
+                m_queue.pop_front();
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case OverflowPolicy::eDropBelowPriority:
+                break;
+        }
+    }
+
     m_queue.push_back(msg);
+    return true;
 }
 
 Message
@@ -53,6 +121,9 @@ LockingQueue::dequeue()
     }
     Message msg = std::move(m_queue.front());
     m_queue.pop_front();
+    if (m_capacity != 0) {
+        m_notFull.notify_one();
+    }
     return msg;
 }
 
@@ -69,5 +140,25 @@ LockingQueue::getCount()
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_queue.size();
 }
+
+void
+LockingQueue::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_notFull.notify_all();
+}
+
+Uint64
+LockingQueue::getDropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+Uint64
+LockingQueue::getBlocked() const
+{
+    return m_blocked.load(std::memory_order_relaxed);
+}
 // Class LockingQueue ends
 } // namespace Au::Logger
@@ -34,14 +34,78 @@ void
 ThreadPinning::pinThreads(std::vector<pthread_t> const& threadList,
                           int                           pinStrategyIndex)
 {
-    pImpl()->pinThreads(threadList, pinStrategyIndex);
+    std::vector<ThreadAffinity> report;
+    pImpl()->pinThreads(threadList, pinStrategyIndex, report);
 }
 
 void
 ThreadPinning::pinThreads(std::vector<pthread_t> const& threadList,
                           std::vector<int> const&       processPinGroup)
 {
-    pImpl()->pinThreads(threadList, processPinGroup);
+    std::vector<ThreadAffinity> report;
+    pImpl()->pinThreads(threadList, processPinGroup, report);
+}
+
+Status
+ThreadPinning::pinThreads(std::vector<pthread_t> const& threadList,
+                          int                           pinStrategyIndex,
+                          std::vector<ThreadAffinity>&  report)
+{
+    return pImpl()->pinThreads(threadList, pinStrategyIndex, report);
+}
+
+Status
+ThreadPinning::pinThreads(std::vector<pthread_t> const& threadList,
+                          std::vector<int> const&       processPinGroup,
+                          std::vector<ThreadAffinity>&  report)
+{
+    return pImpl()->pinThreads(threadList, processPinGroup, report);
+}
+
+bool
+ThreadPinning::placeThreads(std::vector<pthread_t> const& threadList,
+                            std::string const&            placement)
+{
+    std::vector<ThreadAffinity> report;
+    return pImpl()->placeThreads(threadList, placement, report).ok();
+}
+
+Status
+ThreadPinning::placeThreads(std::vector<pthread_t> const& threadList,
+                            std::string const&            placement,
+                            std::vector<ThreadAffinity>&  report)
+{
+    return pImpl()->placeThreads(threadList, placement, report);
+}
+
+std::vector<int>
+ThreadPinning::getThreadAffinity(pthread_t thread) const
+{
+    return pImpl()->getThreadAffinity(thread);
+}
+
+std::vector<int>
+ThreadPinning::getAvailableProcessors() const
+{
+    return pImpl()->getAvailableProcessors();
+}
+
+Status
+ThreadPinning::setPartition(size_t index, size_t count)
+{
+    return Impl::setPartition(index, count);
+}
+
+void
+ThreadPinning::getPartition(size_t& index, size_t& count)
+{
+    Impl::getPartition(index, count);
+}
+
+double
+ThreadPinning::getCpuQuota() const
+{
+    return pImpl()->getCpuQuota();
 }
 
 } // namespace Au
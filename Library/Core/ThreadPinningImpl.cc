@@ -23,43 +23,117 @@
 #include "Au/Assert.hh"
 namespace Au {
 
-void
-ThreadPinning::Impl::pinThreads(std::vector<pthread_t> threadList,
-                                int                    pinStrategyIndex)
+Status
+ThreadPinning::Impl::pinThreads(std::vector<pthread_t>       threadList,
+                                int                          pinStrategyIndex,
+                                std::vector<ThreadAffinity>& report)
 {
+    report.clear();
     AUD_ASSERT(threadList.size() > 0, "Thread list is empty");
     if (threadList.size() == 0) {
-        return;
+        return Status{ InvalidArgumentError(), "Thread list is empty" };
     }
-    AUD_ASSERT(pinStrategyIndex >= 0 && pinStrategyIndex < 3,
+    AUD_ASSERT(pinStrategyIndex >= 0
+                   && pinStrategyIndex <= pinStrategy::NUMA_COMPACT,
                "Invalid pin strategy index");
-    std::vector<int> processPinGroup(threadList.size());
-    if (threadList.size() == 0) {
-        return;
+    if (pinStrategyIndex < 0 || pinStrategyIndex > pinStrategy::NUMA_COMPACT) {
+        return Status{ InvalidArgumentError(), "Invalid pin strategy index" };
     }
-    processPinGroup.reserve(threadList.size());
+    std::vector<int> processPinGroup(threadList.size());
     // Get the processor group to pin the threads
     getAffinityVector(processPinGroup, pinStrategyIndex);
     // Pin the threads to the processor group in the processPinGroup
-    if (processPinGroup.size() == 0) {
-        return;
-    }
-    pinThreads(threadList, processPinGroup);
+    return pinThreads(threadList, processPinGroup, report);
 }
 
-void
-ThreadPinning::Impl::pinThreads(std::vector<pthread_t>  threadList,
-                                std::vector<int> const& processPinGroup)
+Status
+ThreadPinning::Impl::pinThreads(std::vector<pthread_t>       threadList,
+                                std::vector<int> const&      processPinGroup,
+                                std::vector<ThreadAffinity>& report)
 {
+    report.clear();
     AUD_ASSERT(threadList.size() > 0, "Thread list is empty");
     AUD_ASSERT(processPinGroup.size() > 0, "Processor group is empty");
     AUD_ASSERT(threadList.size() == processPinGroup.size(),
                "Thread list and processor group size mismatch");
     if (threadList.size() == 0 || threadList.size() != processPinGroup.size()) {
-        return;
+        return Status{ InvalidArgumentError(),
+                       "Thread list and processor group size mismatch" };
     }
     // Pin the threads to the processor group in the processPinGroup
-    setAffinity(threadList, processPinGroup);
+    return setAffinity(threadList, processPinGroup, report);
+}
+
+Status
+ThreadPinning::Impl::placeThreads(std::vector<pthread_t>       threadList,
+                                  const std::string&           placement,
+                                  std::vector<ThreadAffinity>& report)
+{
+    report.clear();
+    AUD_ASSERT(threadList.size() > 0, "Thread list is empty");
+    PlacementSpec spec;
+    if (!PlacementSpec::parse(placement, spec)) {
+        return Status{ InvalidArgumentError(),
+                       "Malformed placement \"" + placement + "\"" };
+    }
+    if (threadList.size() == 0) {
+        return Status{ InvalidArgumentError(), "Thread list is empty" };
+    }
+    std::vector<int> processPinGroup(threadList.size());
+    getPlacementAffinityVector(processPinGroup, spec);
+    return pinThreads(threadList, processPinGroup, report);
+}
+
+std::vector<int>
+ThreadPinning::Impl::getAvailableProcessors() const
+{
+    if (cpuInfo.availableProcessors.size() != 0)
+        return cpuInfo.availableProcessors;
+    std::vector<int> processors(cpuInfo.active_processors);
+    std::iota(processors.begin(), processors.end(), 0);
+    return processors;
+}
+
+Status
+ThreadPinning::Impl::setPartition(size_t index, size_t count)
+{
+    if (index >= std::max<size_t>(count, 1)) {
+        return Status{ InvalidArgumentError(),
+                       "Partition index is not below the count" };
+    }
+#ifdef __linux__
+    PartitionSpec spec;
+    spec.index = index;
+    spec.count = std::max<size_t>(count, 1);
+    CpuTopology::setPartition(spec);
+    return StatusOk();
+#else
+    return Status{ NotImplementedError(), "Partitions need Linux" };
+#endif
+}
+
+void
+ThreadPinning::Impl::getPartition(size_t& index, size_t& count)
+{
+#ifdef __linux__
+    PartitionSpec spec = CpuTopology::getPartition();
+    index              = spec.index;
+    count              = spec.count;
+#else
+    index = 0;
+    count = 1;
+#endif
+}
+
+double
+ThreadPinning::Impl::getCpuQuota() const
+{
+#ifdef __linux__
+    return Cgroup().cpuQuota();
+#else
+    // Job object CPU rate limits are not read yet
+    return 0;
+#endif
 }
 
 } // namespace Au
@@ -37,11 +37,16 @@ class ThreadPinning::Impl : public AffinityVector
      * @param[in]      threadList        ThreadIds to pin
      *
      * @param[in]      pinStrategyIndex  0 - spread , 1 - Core, 2 - Logical
-     * Processor
+     * Processor, 3 - NUMA spread, 4 - NUMA compact
      *
-     * @return         None
+     * @param[out]     report            Requested and actual affinity of
+     * every thread
+     *
+     * @return         The first error of the report
      */
-    void pinThreads(std::vector<pthread_t> threadList, int pinStrategyIndex);
+    Status pinThreads(std::vector<pthread_t>       threadList,
+                      int                          pinStrategyIndex,
+                      std::vector<ThreadAffinity>& report);
     /**
      * @brief          pinThreads
      *
@@ -51,8 +56,66 @@ class ThreadPinning::Impl : public AffinityVector
      *
      * @param[in]      processPinGroup   Processor Group to pin the threads
      *
+     * @param[out]     report            Requested and actual affinity of
+     * every thread
+     *
+     * @return         The first error of the report
+     */
+    Status pinThreads(std::vector<pthread_t>       threadList,
+                      std::vector<int> const&      processPinGroup,
+                      std::vector<ThreadAffinity>& report);
+
+    /**
+     * @brief          placeThreads
+     *
+     * @details        Pin Threads following a placement specification.
+     *
+     * @param[in]      threadList        ThreadIds to pin
+     *
+     * @param[in]      placement         Specification, see PlacementSpec
+     *
+     * @param[out]     report            Requested and actual affinity of
+     * every thread
+     *
+     * @return         InvalidArgumentError if the specification is malformed,
+     * otherwise the first error of the report
+     */
+    Status placeThreads(std::vector<pthread_t>       threadList,
+                        const std::string&           placement,
+                        std::vector<ThreadAffinity>& report);
+
+    /**
+     * @brief          getAvailableProcessors
+     *
+     * @details        Logical processors the threads can be pinned to.
+     *
+     * @return         Processor numbers in ascending order
+     */
+    std::vector<int> getAvailableProcessors() const;
+
+    /**
+     * @brief          setPartition
+     *
+     * @details        Selects the slice of the machine of the process.
+     *
+     * @return         InvalidArgumentError if index is not below count
+     */
+    static Status setPartition(size_t index, size_t count);
+
+    /**
+     * @brief          getPartition
+     *
+     * @details        Slice of the machine of the process.
+     */
+    static void getPartition(size_t& index, size_t& count);
+
+    /**
+     * @brief          getCpuQuota
+     *
+     * @details        CPU bandwidth quota of the process, in processors.
+     *
+     * @return         The quota, 0 if the CPU time is not limited
      */
-    void pinThreads(std::vector<pthread_t>  threadList,
-                    std::vector<int> const& processPinGroup);
+    double getCpuQuota() const;
 };
 } // namespace Au
@@ -0,0 +1,78 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Au/ThreadPool.hh"
+#include "ThreadPoolImpl.hh"
+
+namespace Au {
+ThreadPool::ThreadPool(size_t threadCount, int pinStrategyIndex)
+    : m_pimpl{ new ThreadPool::Impl{ threadCount, pinStrategyIndex } }
+{
+}
+
+ThreadPool::~ThreadPool() {}
+
+size_t
+ThreadPool::size() const
+{
+    return pImpl()->size();
+}
+
+int
+ThreadPool::workerIndex() const
+{
+    return pImpl()->workerIndex();
+}
+
+std::vector<ThreadAffinity> const&
+ThreadPool::getAffinity() const
+{
+    return pImpl()->getAffinity();
+}
+
+Status
+ThreadPool::getStatus() const
+{
+    return pImpl()->getStatus();
+}
+
+void
+ThreadPool::submit(Task task)
+{
+    pImpl()->submit(std::move(task));
+}
+
+void
+ThreadPool::wait()
+{
+    pImpl()->wait();
+}
+
+void
+ThreadPool::parallelFor(size_t           begin,
+                        size_t           end,
+                        RangeTask const& body,
+                        size_t           grain)
+{
+    pImpl()->parallelFor(begin, end, body, grain);
+}
+
+} // namespace Au
@@ -0,0 +1,296 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ThreadPoolImpl.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace Au {
+
+namespace {
+    // Pool and index of the worker running on this thread
+    thread_local const void* tlsPool  = nullptr;
+    thread_local size_t      tlsIndex = 0;
+} // namespace
+
+size_t
+ThreadPool::Impl::defaultThreadCount()
+{
+    ThreadPinning tp;
+    size_t        count = tp.getAvailableProcessors().size();
+    double        quota = tp.getCpuQuota();
+    if (quota > 0)
+        count = std::min(count, static_cast<size_t>(std::ceil(quota)));
+    return std::max<size_t>(count, 1);
+}
+
+ThreadPool::Impl::Impl(size_t threadCount, int pinStrategyIndex)
+    : m_workers{}
+    , m_mutex{}
+    , m_wake{}
+    , m_done{}
+    , m_injectMutex{}
+    , m_injected{}
+    , m_queued{ 0 }
+    , m_sleeping{ 0 }
+    , m_stop{ false }
+    , m_started{ false }
+    , m_submitted{}
+    , m_affinity{}
+    , m_status{}
+{
+    if (threadCount == 0)
+        threadCount = defaultThreadCount();
+    bool pin = pinStrategyIndex >= pinStrategy::SPREAD
+               && pinStrategyIndex <= pinStrategy::NUMA_COMPACT;
+    if (!pin && pinStrategyIndex != cNoPinning) {
+        m_status = Status{ InvalidArgumentError(),
+                           "Invalid pin strategy index, workers not pinned" };
+    }
+
+    AffinityVector   av;
+    std::vector<int> processors(threadCount, -1);
+    if (pin)
+        av.getAffinityVector(processors, pinStrategyIndex);
+    std::vector<AffinityVector::CpuLabel> labels;
+    av.getCpuLabels(labels);
+
+    for (size_t i = 0; i < threadCount; i++)
+        m_workers.push_back(std::make_unique<Worker>(i));
+    buildVictims(labels, processors);
+    for (size_t i = 0; i < threadCount; i++)
+        m_workers[i]->thread = std::thread(&Impl::workerLoop, this, i);
+
+    if (pin) {
+        std::vector<pthread_t> threads;
+        for (auto& worker : m_workers)
+            threads.push_back(worker->thread.native_handle());
+        m_status = av.setAffinity(threads, processors, m_affinity);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_started = true;
+    }
+    m_wake.notify_all();
+}
+
+ThreadPool::Impl::~Impl()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true);
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers)
+        worker->thread.join();
+}
+
+void
+ThreadPool::Impl::buildVictims(
+    std::vector<AffinityVector::CpuLabel> const& labels,
+    std::vector<int> const&                      processors)
+{
+    auto victims = VictimOrder::build(labels, processors);
+    for (size_t i = 0; i < m_workers.size(); i++)
+        m_workers[i]->victims = std::move(victims[i]);
+}
+
+int
+ThreadPool::Impl::workerIndex() const
+{
+    return tlsPool == this ? static_cast<int>(tlsIndex) : -1;
+}
+
+void
+ThreadPool::Impl::spawn(Group& group, Task task)
+{
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    WorkItem* item = new WorkItem{ std::move(task), &group };
+    // Counted before it is visible so that a worker taking it cannot make
+    // the count negative
+    m_queued.fetch_add(1);
+    if (tlsPool == this) {
+        m_workers[tlsIndex]->deque.push(item);
+    } else {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        m_injected.push_back(item);
+    }
+    // Pairs with the increment of m_sleeping in workerLoop: either the
+    // worker sees m_queued or this thread sees it sleeping
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+ThreadPool::Impl::WorkItem*
+ThreadPool::Impl::take(size_t self)
+{
+    if (m_queued.load(std::memory_order_relaxed) <= 0)
+        return nullptr;
+
+    WorkItem* item = nullptr;
+    if (self < m_workers.size()) {
+        Worker& worker = *m_workers[self];
+        item           = worker.deque.pop();
+        for (size_t level = 0; item == nullptr && level < cLevels; level++) {
+            auto& victims = worker.victims[level];
+            if (victims.empty())
+                continue;
+            // xorshift, spreads the thieves of a level over their victims
+            worker.seed ^= worker.seed << 13;
+            worker.seed ^= worker.seed >> 7;
+            worker.seed ^= worker.seed << 17;
+            size_t start = worker.seed % victims.size();
+            for (size_t i = 0; item == nullptr && i < victims.size(); i++) {
+                item = m_workers[victims[(start + i) % victims.size()]]
+                           ->deque.steal();
+            }
+        }
+    } else {
+        for (size_t i = 0; item == nullptr && i < m_workers.size(); i++)
+            item = m_workers[i]->deque.steal();
+    }
+    if (item == nullptr) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        if (!m_injected.empty()) {
+            item = m_injected.front();
+            m_injected.pop_front();
+        }
+    }
+    if (item != nullptr)
+        m_queued.fetch_sub(1);
+    return item;
+}
+
+void
+ThreadPool::Impl::run(WorkItem* item)
+{
+    item->task();
+    Group* group = item->group;
+    delete item;
+    if (group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.notify_all();
+    }
+}
+
+void
+ThreadPool::Impl::waitFor(Group& group)
+{
+    bool   worker = tlsPool == this;
+    size_t self   = worker ? tlsIndex : m_workers.size();
+    int    idle   = 0;
+    while (group.pending.load(std::memory_order_acquire) != 0) {
+        if (WorkItem* item = take(self)) {
+            run(item);
+            idle = 0;
+        } else if (worker || ++idle < cSpins) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [&group] {
+                return group.pending.load(std::memory_order_acquire) == 0;
+            });
+        }
+    }
+}
+
+void
+ThreadPool::Impl::workerLoop(size_t self)
+{
+    tlsPool  = this;
+    tlsIndex = self;
+    {
+        // Tasks submitted right away must not run before the worker is
+        // pinned
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_started; });
+    }
+    int idle = 0;
+    while (true) {
+        if (WorkItem* item = take(self)) {
+            run(item);
+            idle = 0;
+            continue;
+        }
+        if (++idle < cSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [this] { return m_stop.load() || m_queued > 0; });
+        m_sleeping.fetch_sub(1);
+        if (m_stop.load() && m_queued.load() <= 0)
+            break;
+    }
+    tlsPool = nullptr;
+}
+
+void
+ThreadPool::Impl::submit(Task task)
+{
+    spawn(m_submitted, std::move(task));
+}
+
+void
+ThreadPool::Impl::wait()
+{
+    waitFor(m_submitted);
+}
+
+void
+ThreadPool::Impl::split(Group&           group,
+                        size_t           begin,
+                        size_t           end,
+                        size_t           grain,
+                        RangeTask const& body)
+{
+    // Keep the lower half, the upper one is the first to be stolen
+    while (end - begin > grain) {
+        size_t middle = begin + (end - begin) / 2;
+        spawn(group, [this, &group, middle, end, grain, &body] {
+            split(group, middle, end, grain, body);
+        });
+        end = middle;
+    }
+    body(begin, end);
+}
+
+void
+ThreadPool::Impl::parallelFor(size_t           begin,
+                              size_t           end,
+                              RangeTask const& body,
+                              size_t           grain)
+{
+    if (end <= begin)
+        return;
+    if (grain == 0)
+        grain = std::max<size_t>((end - begin) / (size() * 8), 1);
+    Group group;
+    split(group, begin, end, grain, body);
+    waitFor(group);
+}
+
+} // namespace Au
@@ -0,0 +1,181 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include "Au/ThreadPinning/ThreadPinning.hh"
+#include "Au/ThreadPool.hh"
+#include "Au/ThreadPool/VictimOrder.hh"
+#include "Au/ThreadPool/WorkStealingDeque.hh"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Au {
+class ThreadPool::Impl
+{
+  public:
+    /// Steal levels: SMT sibling, same cache, same NUMA node, remote
+    static constexpr size_t cLevels = VictimOrder::cLevels;
+
+    /// Failed attempts to find a task before an idle thread blocks
+    static constexpr int cSpins = 64;
+
+  private:
+    /// Tasks a thread waits for, counted down as they complete
+    struct Group
+    {
+        std::atomic<size_t> pending;
+
+        Group()
+            : pending{ 0 }
+        {
+        }
+    };
+
+    /// Queued task with the group it belongs to
+    struct WorkItem
+    {
+        Task   task;
+        Group* group;
+    };
+
+    struct Worker
+    {
+        WorkStealingDeque<WorkItem*> deque;
+        /// Other workers, by distance
+        VictimOrder::Levels victims;
+        /// Picks the first victim tried on every level
+        Uint64      seed;
+        std::thread thread;
+
+        explicit Worker(size_t index)
+            : deque{}
+            , victims{}
+            , seed{ (index + 1) * 0x9E3779B97F4A7C15ULL }
+            , thread{}
+        {
+        }
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex                           m_mutex; ///< Guards sleeping
+    std::condition_variable              m_wake;  ///< Idle workers wait here
+    std::condition_variable              m_done;  ///< Other threads wait here
+    std::mutex                           m_injectMutex;
+    std::deque<WorkItem*>                m_injected; ///< Submitted from outside
+    std::atomic<int64_t>                 m_queued;   ///< Tasks not yet taken
+    std::atomic<size_t>                  m_sleeping; ///< Workers in m_wake
+    std::atomic<bool>                    m_stop;
+    bool m_started; ///< Set once pinned, guarded by m_mutex
+    Group                                m_submitted; ///< Tasks of submit()
+    std::vector<ThreadAffinity>          m_affinity;
+    Status                               m_status;
+
+    /**
+     * @brief          defaultThreadCount
+     *
+     * @return         Available processors, capped by the CPU quota
+     */
+    static size_t defaultThreadCount();
+
+    /**
+     * @brief          buildVictims
+     *
+     * @details        Give every worker its VictimOrder.
+     *
+     * @param[in]      labels            Topology labels of the processors
+     *
+     * @param[in]      processors        Processor of every worker, -1 if it
+     * is not pinned
+     */
+    void buildVictims(std::vector<AffinityVector::CpuLabel> const& labels,
+                      std::vector<int> const&                      processors);
+
+    /**
+     * @brief          spawn
+     *
+     * @details        Queue a task on the deque of the calling worker, or on
+     * the shared queue from other threads, and wake an idle worker.
+     */
+    void spawn(Group& group, Task task);
+
+    /**
+     * @brief          take
+     *
+     * @details        Own deque first, then the victims level by level, then
+     * the shared queue.
+     *
+     * @param[in]      self              Index of the calling worker, size()
+     * for other threads
+     *
+     * @return         A task, nullptr if none was found
+     */
+    WorkItem* take(size_t self);
+
+    /**
+     * @brief          run
+     *
+     * @details        Run and free a task, wake the waiters of its group
+     * once it was the last one.
+     */
+    void run(WorkItem* item);
+
+    /**
+     * @brief          waitFor
+     *
+     * @details        Run tasks until the group completes. Workers never
+     * block here so that nested waits cannot run out of threads, other
+     * threads block once no task is left to take.
+     */
+    void waitFor(Group& group);
+
+    void workerLoop(size_t self);
+
+    void split(Group&           group,
+               size_t           begin,
+               size_t           end,
+               size_t           grain,
+               RangeTask const& body);
+
+  public:
+    Impl(size_t threadCount, int pinStrategyIndex);
+    ~Impl();
+
+    size_t                             size() const { return m_workers.size(); }
+    int                                workerIndex() const;
+    std::vector<ThreadAffinity> const& getAffinity() const
+    {
+        return m_affinity;
+    }
+    Status getStatus() const { return m_status; }
+
+    void submit(Task task);
+    void wait();
+    void parallelFor(size_t           begin,
+                     size_t           end,
+                     RangeTask const& body,
+                     size_t           grain);
+};
+} // namespace Au
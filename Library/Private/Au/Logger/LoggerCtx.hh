@@ -32,7 +32,7 @@
 
 struct LoggerCtx
 {
-    std::unique_ptr<Au::Logger::LogWriter>  logWriter;
+    std::shared_ptr<Au::Logger::LogWriter>  logWriter;
     std::unique_ptr<Au::Logger::LogManager> logger;
     LoggerCtx()
         : logWriter(nullptr)
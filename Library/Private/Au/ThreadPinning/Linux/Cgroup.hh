@@ -0,0 +1,226 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include "Au/ThreadPinning/Linux/CpuSet.hh"
+#include "Au/ThreadPinning/Linux/SysfsDir.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @brief       CPU limits of the cgroup the process runs in.
+ *
+ * @details     Supports the unified (v2) hierarchy and the cpuset and cpu
+ * controllers of v1, including hybrid setups where v1 controllers are mounted
+ * next to the unified tree. The cgroup path in /proc/self/cgroup is relative
+ * to the root of the hierarchy; without a cgroup namespace a container only
+ * sees its own cgroup mounted as the root, so the path is shortened until an
+ * existing directory is found.
+ */
+class Cgroup
+{
+  private:
+    std::string m_root;
+    std::string m_unified; // Path of the v2 cgroup, empty if none
+    std::string m_cpuset;  // Path in the v1 cpuset hierarchy, empty if none
+    std::string m_cpu;     // Path in the v1 cpu hierarchy, empty if none
+    bool        m_hasUnified;
+    bool        m_hasCpuset;
+    bool        m_hasCpu;
+
+    /**
+     * @brief       Directories from a cgroup to the root of its hierarchy.
+     *
+     * @param[in]   mount   Mount point of the hierarchy.
+     *
+     * @param[in]   path    Path of the cgroup, relative to the mount point.
+     *
+     * @return      std::vector<std::string>, the existing directories, the
+     * innermost first
+     */
+    static std::vector<std::string> ancestors(const std::string& mount,
+                                              std::string        path)
+    {
+        std::vector<std::string> dirs;
+        while (true) {
+            if (SysfsDir(mount + path).isOpen())
+                dirs.push_back(mount + path);
+            if (path.empty() || path == "/")
+                break;
+            size_t slash = path.find_last_of('/');
+            path = path.substr(0, slash == std::string::npos ? 0 : slash);
+        }
+        return dirs;
+    }
+
+    /**
+     * @brief       Read the bandwidth limit of one cgroup.
+     *
+     * @param[in]   dir         Directory of the cgroup.
+     *
+     * @param[in]   unified     true for cpu.max, false for the v1 cfs files.
+     *
+     * @return      double, CPUs worth of run time, 0 if unlimited
+     */
+    static double readQuota(const std::string& dir, bool unified)
+    {
+        SysfsDir cgroup(dir);
+        char     buffer[64];
+        if (unified) {
+            ssize_t length =
+                cgroup.read("cpu.max", buffer, sizeof(buffer) - 1);
+            if (length <= 0)
+                return 0;
+            buffer[length] = '\0';
+            long long quota, period;
+            // "max <period>" is unlimited
+            if (sscanf(buffer, "%lld %lld", &quota, &period) != 2
+                || period <= 0)
+                return 0;
+            return quota > 0 ? double(quota) / period : 0;
+        }
+        int quota = 0, period = 0;
+        if (!cgroup.readInt("cpu.cfs_quota_us", quota)
+            || !cgroup.readInt("cpu.cfs_period_us", period) || quota <= 0
+            || period <= 0)
+            return 0; // -1 is unlimited
+        return double(quota) / period;
+    }
+
+  public:
+    /**
+     * @brief       Find the cgroup of the process.
+     *
+     * @param[in]   root        Mount point of the cgroup file systems.
+     *
+     * @param[in]   procCgroup  Membership file, a synthetic one can be given
+     * for testing.
+     */
+    explicit Cgroup(const std::string& root       = "/sys/fs/cgroup",
+                    const std::string& procCgroup = "/proc/self/cgroup")
+        : m_root(root)
+        , m_unified()
+        , m_cpuset()
+        , m_cpu()
+        , m_hasUnified(false)
+        , m_hasCpuset(false)
+        , m_hasCpu(false)
+    {
+        // Lines are <hierarchy id>:<controllers>:<path>, v2 has id 0 and no
+        // controllers
+        std::ifstream file(procCgroup);
+        std::string   line;
+        while (getline(file, line)) {
+            size_t first = line.find(':');
+            size_t last  = first == std::string::npos
+                               ? std::string::npos
+                               : line.find(':', first + 1);
+            if (last == std::string::npos)
+                continue;
+            std::string controllers =
+                "," + line.substr(first + 1, last - first - 1) + ",";
+            std::string path = line.substr(last + 1);
+            if (controllers == ",,") {
+                m_unified    = path;
+                m_hasUnified = true;
+            }
+            if (controllers.find(",cpuset,") != std::string::npos) {
+                m_cpuset    = path;
+                m_hasCpuset = true;
+            }
+            if (controllers.find(",cpu,") != std::string::npos) {
+                m_cpu    = path;
+                m_hasCpu = true;
+            }
+        }
+    }
+
+    /**
+     * @brief       Get the CPUs the cgroup may run on.
+     *
+     * @details     Reads the effective cpuset, which is already restricted by
+     * the parent cgroups.
+     *
+     * @param[out]  cpus    The CPUs of the cpuset.
+     *
+     * @return      bool, false if no cpuset applies
+     */
+    bool cpuset(CpuSet& cpus) const
+    {
+        auto find = [&cpus](const std::vector<std::string>& dirs,
+                            const std::vector<const char*>& names) {
+            for (auto& dir : dirs) {
+                SysfsDir cgroup(dir);
+                for (const char* name : names) {
+                    if (cgroup.readList(name, cpus) && !cpus.empty())
+                        return true;
+                }
+            }
+            return false;
+        };
+        if (m_hasCpuset
+            && find(ancestors(m_root + "/cpuset", m_cpuset),
+                    { "cpuset.effective_cpus", "cpuset.cpus" }))
+            return true;
+        return m_hasUnified
+               && find(ancestors(m_root, m_unified),
+                       { "cpuset.cpus.effective" });
+    }
+
+    /**
+     * @brief       Get the CPU bandwidth quota.
+     *
+     * @details     The quota is the run time the cgroup may use per period,
+     * in CPUs: a cpu.max of "150000 100000" is 1.5 CPUs. Limits of the parent
+     * cgroups apply too, the smallest one is returned.
+     *
+     * @return      double, 0 if the run time is not limited
+     */
+    double cpuQuota() const
+    {
+        std::vector<std::string> dirs;
+        bool                     unified = false;
+        if (m_hasCpu) {
+            dirs = ancestors(m_root + "/cpu,cpuacct", m_cpu);
+            if (dirs.empty())
+                dirs = ancestors(m_root + "/cpu", m_cpu);
+        }
+        if (dirs.empty() && m_hasUnified) {
+            dirs    = ancestors(m_root, m_unified);
+            unified = true;
+        }
+
+        double quota = 0;
+        for (auto& dir : dirs) {
+            double limit = readQuota(dir, unified);
+            if (limit > 0 && (quota == 0 || limit < quota))
+                quota = limit;
+        }
+        return quota;
+    }
+};
+
+} // namespace Au
@@ -0,0 +1,447 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace Au {
+typedef unsigned long             KAFFINITY;
+typedef std::pair<KAFFINITY, int> CoreMask;
+
+/**
+ * @brief       Dynamically sized set of logical CPUs.
+ *
+ * @details     Unlike cpu_set_t the set is not limited to CPU_SETSIZE CPUs.
+ * Affinity calls allocate their masks with CPU_ALLOC for the highest CPU
+ * involved, so machines with more than 1024 logical CPUs are supported.
+ */
+class CpuSet
+{
+  private:
+    std::vector<KAFFINITY> m_words; // No trailing zero words
+
+    void trim()
+    {
+        while (!m_words.empty() && m_words.back() == 0)
+            m_words.pop_back();
+    }
+
+  public:
+    static constexpr int cWordBits = sizeof(KAFFINITY) * CHAR_BIT;
+
+    CpuSet()
+        : m_words{}
+    {
+    }
+
+    /**
+     * @brief       Add a CPU to the set.
+     *
+     * @param[in]   cpu     Logical CPU number.
+     *
+     * @return      void
+     */
+    void set(int cpu)
+    {
+        size_t word = cpu / cWordBits;
+        if (word >= m_words.size())
+            m_words.resize(word + 1, 0);
+        m_words[word] |= 1UL << (cpu % cWordBits);
+    }
+
+    /**
+     * @brief       Add the CPUs first to last, both included.
+     *
+     * @param[in]   first   Lowest logical CPU number.
+     *
+     * @param[in]   last    Highest logical CPU number.
+     *
+     * @return      void
+     */
+    void setRange(int first, int last)
+    {
+        if (first > last)
+            return;
+        size_t firstWord = first / cWordBits, lastWord = last / cWordBits;
+        if (lastWord >= m_words.size())
+            m_words.resize(lastWord + 1, 0);
+        KAFFINITY low  = ~0UL << (first % cWordBits);
+        KAFFINITY high = ~0UL >> (cWordBits - 1 - last % cWordBits);
+        if (firstWord == lastWord) {
+            m_words[firstWord] |= low & high;
+            return;
+        }
+        m_words[firstWord] |= low;
+        for (size_t word = firstWord + 1; word < lastWord; word++)
+            m_words[word] = ~0UL;
+        m_words[lastWord] |= high;
+    }
+
+    /**
+     * @brief       Remove a CPU from the set.
+     *
+     * @param[in]   cpu     Logical CPU number.
+     *
+     * @return      void
+     */
+    void reset(int cpu)
+    {
+        size_t word = cpu / cWordBits;
+        if (word < m_words.size()) {
+            m_words[word] &= ~(1UL << (cpu % cWordBits));
+            trim();
+        }
+    }
+
+    /**
+     * @brief       Check whether a CPU is in the set.
+     *
+     * @param[in]   cpu     Logical CPU number.
+     *
+     * @return      bool
+     */
+    bool test(int cpu) const
+    {
+        size_t word = cpu / cWordBits;
+        return word < m_words.size()
+               && (m_words[word] & (1UL << (cpu % cWordBits))) != 0;
+    }
+
+    /**
+     * @brief       Number of CPUs in the set.
+     *
+     * @return      size_t
+     */
+    size_t count() const
+    {
+        size_t total = 0;
+        for (auto word : m_words)
+            total += __builtin_popcountl(word);
+        return total;
+    }
+
+    /**
+     * @brief       One past the highest CPU in the set, 0 if empty.
+     *
+     * @return      int
+     */
+    int size() const
+    {
+        if (m_words.empty())
+            return 0;
+        return m_words.size() * cWordBits - __builtin_clzl(m_words.back());
+    }
+
+    bool empty() const { return m_words.empty(); }
+
+    /**
+     * @brief       Lowest CPU in the set, -1 if empty.
+     *
+     * @return      int
+     */
+    int first() const
+    {
+        for (size_t word = 0; word < m_words.size(); word++) {
+            if (m_words[word] != 0)
+                return word * cWordBits + __builtin_ctzl(m_words[word]);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief       List the CPUs in the set in ascending order.
+     *
+     * @return      std::vector<int>
+     */
+    std::vector<int> toList() const
+    {
+        std::vector<int> cpus;
+        for (size_t word = 0; word < m_words.size(); word++) {
+            for (KAFFINITY bits = m_words[word]; bits != 0; bits &= bits - 1)
+                cpus.push_back(word * cWordBits + __builtin_ctzl(bits));
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief       Convert the set to masks paired with their position.
+     *
+     * @details     Mask n covers the CPUs n * cWordBits to
+     * (n + 1) * cWordBits - 1. Masks without CPUs are skipped.
+     *
+     * @return      std::vector<CoreMask>
+     */
+    std::vector<CoreMask> toCoreMasks() const
+    {
+        std::vector<CoreMask> masks;
+        for (size_t word = 0; word < m_words.size(); word++) {
+            if (m_words[word] != 0)
+                masks.push_back(std::make_pair(m_words[word], int(word)));
+        }
+        return masks;
+    }
+
+    CpuSet& operator|=(const CpuSet& other)
+    {
+        if (other.m_words.size() > m_words.size())
+            m_words.resize(other.m_words.size(), 0);
+        for (size_t word = 0; word < other.m_words.size(); word++)
+            m_words[word] |= other.m_words[word];
+        return *this;
+    }
+
+    CpuSet& operator&=(const CpuSet& other)
+    {
+        if (m_words.size() > other.m_words.size())
+            m_words.resize(other.m_words.size());
+        for (size_t word = 0; word < m_words.size(); word++)
+            m_words[word] &= other.m_words[word];
+        trim();
+        return *this;
+    }
+
+    bool operator==(const CpuSet& other) const
+    {
+        return m_words == other.m_words;
+    }
+
+    bool operator<(const CpuSet& other) const
+    {
+        return m_words < other.m_words;
+    }
+
+    /**
+     * @brief       Create a set from masks paired with their position.
+     *
+     * @param[in]   masks   Masks in the format of toCoreMasks().
+     *
+     * @return      CpuSet
+     */
+    static CpuSet fromCoreMasks(const std::vector<CoreMask>& masks)
+    {
+        CpuSet cpus;
+        for (auto& mask : masks) {
+            if (mask.second < 0)
+                continue;
+            if (size_t(mask.second) >= cpus.m_words.size())
+                cpus.m_words.resize(mask.second + 1, 0);
+            cpus.m_words[mask.second] |= mask.first;
+        }
+        cpus.trim();
+        return cpus;
+    }
+
+    /**
+     * @brief       Parse a sysfs cpumap such as "000000ff,ffffffff".
+     *
+     * @details     The map is a comma separated list of 32 bit hexadecimal
+     * chunks, the most significant first, as in thread_siblings or
+     * shared_cpu_map.
+     *
+     * @param[in]   line    The cpumap.
+     *
+     * @return      CpuSet
+     */
+    static CpuSet fromMask(const std::string& line)
+    {
+        std::vector<std::string> chunks;
+        std::stringstream        ss(line);
+        std::string              chunk;
+        while (std::getline(ss, chunk, ','))
+            chunks.push_back(chunk);
+
+        CpuSet cpus;
+        int    position = 0;
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it, position++) {
+            unsigned long bits = std::strtoul(it->c_str(), nullptr, 16);
+            for (; bits != 0; bits &= bits - 1)
+                cpus.set(position * 32 + __builtin_ctzl(bits));
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief       Parse a sysfs cpulist such as "0-7,64-71".
+     *
+     * @details     Hand-written so that a buffer read from sysfs can be parsed
+     * in place, without copies or locale aware conversions. The list ends at
+     * the end of the buffer or at a newline or NUL.
+     *
+     * @param[in]   text    The cpulist, not necessarily NUL terminated.
+     *
+     * @param[in]   length  Length of the text.
+     *
+     * @param[out]  cpus    The CPUs listed are added to the set.
+     *
+     * @return      bool, false if the list is malformed
+     */
+    static bool parseList(const char* text, size_t length, CpuSet& cpus)
+    {
+        const char* pos = text;
+        const char* end = text + length;
+        auto        number = [&pos, end](int& value) {
+            if (pos == end || *pos < '0' || *pos > '9')
+                return false;
+            long parsed = 0;
+            for (; pos != end && *pos >= '0' && *pos <= '9'; pos++) {
+                parsed = parsed * 10 + (*pos - '0');
+                if (parsed > INT_MAX)
+                    return false;
+            }
+            value = int(parsed);
+            return true;
+        };
+
+        while (pos != end && *pos != '\n' && *pos != '\0') {
+            int first, last;
+            if (!number(first))
+                return false;
+            last = first;
+            if (pos != end && *pos == '-') {
+                pos++;
+                if (!number(last) || last < first)
+                    return false;
+            }
+            cpus.setRange(first, last);
+            if (pos != end && *pos == ',')
+                pos++;
+            else if (pos != end && *pos != '\n' && *pos != '\0')
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief       Parse a sysfs cpulist such as "0-7,64-71".
+     *
+     * @param[in]   line    The cpulist.
+     *
+     * @return      CpuSet, empty if the list is malformed
+     */
+    static CpuSet fromList(const std::string& line)
+    {
+        CpuSet cpus;
+        if (!parseList(line.data(), line.size(), cpus))
+            return CpuSet();
+        return cpus;
+    }
+
+    /**
+     * @brief       Restrict a thread to the CPUs in the set.
+     *
+     * @param[in]   thread  Thread to pin.
+     *
+     * @return      0 on success, the error returned by pthread_setaffinity_np
+     * otherwise.
+     */
+    int applyTo(pthread_t thread) const
+    {
+        int        cpuCount = std::max(size(), 1);
+        cpu_set_t* mask     = CPU_ALLOC(cpuCount);
+        if (mask == nullptr)
+            return ENOMEM;
+        size_t bytes = CPU_ALLOC_SIZE(cpuCount);
+        CPU_ZERO_S(bytes, mask);
+        for (int cpu : toList())
+            CPU_SET_S(cpu, bytes, mask);
+        int err = pthread_setaffinity_np(thread, bytes, mask);
+        CPU_FREE(mask);
+        return err;
+    }
+
+    /**
+     * @brief       Get the CPUs a thread may run on.
+     *
+     * @details     The mask is grown until the kernel accepts its size, which
+     * depends on the number of CPUs the kernel was configured for.
+     *
+     * @param[in]   thread  Thread to query.
+     *
+     * @return      CpuSet, empty if the affinity cannot be read.
+     */
+    static CpuSet ofThread(pthread_t thread)
+    {
+        CpuSet cpus;
+        for (int cpuCount = CPU_SETSIZE; cpuCount <= (1 << 20);
+             cpuCount *= 2) {
+            cpu_set_t* mask = CPU_ALLOC(cpuCount);
+            if (mask == nullptr)
+                break;
+            size_t bytes = CPU_ALLOC_SIZE(cpuCount);
+            CPU_ZERO_S(bytes, mask);
+            int err = pthread_getaffinity_np(thread, bytes, mask);
+            if (err == 0) {
+                for (int cpu = 0; cpu < cpuCount; cpu++) {
+                    if (CPU_ISSET_S(cpu, bytes, mask))
+                        cpus.set(cpu);
+                }
+            }
+            CPU_FREE(mask);
+            if (err != EINVAL)
+                break;
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief       Get the CPUs the process may run on.
+     *
+     * @details     This is the affinity of the main thread, as set by taskset,
+     * numactl or a container runtime, and not the one of the calling thread,
+     * which may already have been pinned.
+     *
+     * @return      CpuSet, empty if the affinity cannot be read.
+     */
+    static CpuSet ofProcess()
+    {
+        CpuSet cpus;
+        for (int cpuCount = CPU_SETSIZE; cpuCount <= (1 << 20);
+             cpuCount *= 2) {
+            cpu_set_t* mask = CPU_ALLOC(cpuCount);
+            if (mask == nullptr)
+                break;
+            size_t bytes = CPU_ALLOC_SIZE(cpuCount);
+            CPU_ZERO_S(bytes, mask);
+            int err = sched_getaffinity(getpid(), bytes, mask) ? errno : 0;
+            if (err == 0) {
+                for (int cpu = 0; cpu < cpuCount; cpu++) {
+                    if (CPU_ISSET_S(cpu, bytes, mask))
+                        cpus.set(cpu);
+                }
+            }
+            CPU_FREE(mask);
+            if (err != EINVAL)
+                break;
+        }
+        return cpus;
+    }
+};
+} // namespace Au
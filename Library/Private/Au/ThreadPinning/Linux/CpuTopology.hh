@@ -20,12 +20,22 @@
  * THE SOFTWARE.
  */
 #pragma once
+#include "Au/Logger.hh"
+#include "Au/ThreadPinning/Linux/Cgroup.hh"
+#include "Au/ThreadPinning/Linux/CpuSet.hh"
+#include "Au/ThreadPinning/Linux/SysfsDir.hh"
+#include "Au/ThreadPinning/Partition.hh"
+
 #include <algorithm>
-#include <bitset>
+#include <atomic>
 #include <cmath>
 #include <dirent.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdint.h>
 #include <string>
@@ -34,252 +44,740 @@
 #include <vector>
 
 namespace Au {
-typedef unsigned long             DWORD;
-typedef unsigned long             KAFFINITY;
-typedef std::pair<KAFFINITY, int> CoreMask;
+typedef unsigned long DWORD;
 
-class LogicalProcessorInformation
+/**
+ * @brief       Levels of the CPU domain tree, outermost first.
+ */
+enum class DomainLevel
 {
+    eMachine,
+    ePackage,
+    eNuma,
+    eL3,
+    eL2,
+    eCore,
+    eThread
+};
 
-  public:
-    std::string    filename;
-    int            cpuId;
-    DIR*           dirp;
-    struct dirent* dp; // Pointer to the directory entry
-
-    explicit LogicalProcessorInformation(const std::string& filename)
-        : filename(filename)
-        , cpuId(0)
-        , dirp(opendir("/sys/devices/system/cpu/"))
-        , dp(NULL)
+/**
+ * @brief       Node of the CPU domain tree.
+ *
+ * @details     Every node holds the online CPUs of one domain and its
+ * children split them at the next level: machine -> package -> NUMA node ->
+ * L3 cache (CCX) -> L2 cache -> core -> SMT thread. A domain which does not
+ * nest in its parent (a NUMA node spanning two packages) appears once under
+ * every parent it overlaps. Levels the platform does not report have a single
+ * node holding all the CPUs of the parent.
+ */
+struct CpuDomain
+{
+    DomainLevel            level;
+    CpuSet                 cpus;
+    std::vector<CpuDomain> children;
+};
+
+class CpuTopology
+{
+  private:
+    /**
+     * @brief            Eliminate duplicates from the Map.
+     *
+     * @details          This function eliminates duplicates from the Map.
+     *
+     * @param[in/out]    std::vector<CpuSet>&
+     * Map A vector of unique CPU sets.
+     * @return      void
+     */
+    void eliminateDuplicates(std::vector<CpuSet>& Map)
     {
+        std::sort(Map.begin(), Map.end());
+        auto newMap = std::unique(Map.begin(), Map.end());
+        Map.erase(newMap, Map.end());
     }
-    // Copy constructor
-    LogicalProcessorInformation(LogicalProcessorInformation& other)
-        : filename(other.filename)
-        , cpuId(other.cpuId)
-        , dirp(other.dirp)
-        , dp(other.dp)
+
+    /**
+     * @brief            Compare two vectors.
+     *
+     * @details          Used to reorder the vector after eliminating
+     * duplicates.
+     *
+     * @param[in]        const std::vector<CoreMask>& a
+     *                   A vector of pairs.
+     * @param[in]        const std::vector<CoreMask>& b
+     *                   A vector of pairs.
+     *
+     * @return           bool
+     */
+    static bool compareVectors(const std::vector<CoreMask>& a,
+                               const std::vector<CoreMask>& b)
     {
-        other.dp   = NULL;
-        other.dirp = NULL;
+        if (a[0].second == b[0].second)
+            return a[0].first < b[0].first;
+        else
+            return a[0].second < b[0].second;
     }
-    // = operator
-    LogicalProcessorInformation& operator=(LogicalProcessorInformation& other)
+
+    /**
+     * @brief            Eliminate duplicates and order by the lowest CPU.
+     *
+     * @param[in/out]    std::vector<CpuSet>& sets
+     *
+     * @return      void
+     */
+    static void sortByFirstCpu(std::vector<CpuSet>& sets)
     {
-        if (this != &other) {
-            filename   = other.filename;
-            cpuId      = other.cpuId;
-            dirp       = other.dirp;
-            dp         = other.dp;
-            other.dp   = NULL;
-            other.dirp = NULL;
-        }
-        return *this;
+        std::sort(sets.begin(), sets.end());
+        sets.erase(std::unique(sets.begin(), sets.end()), sets.end());
+        std::sort(sets.begin(), sets.end(), [](auto& a, auto& b) {
+            return a.first() < b.first();
+        });
     }
-    ~LogicalProcessorInformation() { closedir(dirp); }
+
+    /// Domains of every level below the machine, outermost first
+    using DomainLevels =
+        std::vector<std::pair<DomainLevel, std::vector<CpuSet>>>;
+
     /**
-     * @brief       Move to the next directory entry.
+     * @brief            Build the children of a domain.
+     *
+     * @details          The domains of a level partition the CPUs, owners
+     * gives the domain of every CPU so that only the domains overlapping the
+     * parent are visited.
      *
-     * @details     This function moves to the next directory
-     *              corresponding to cpu<id>, updates cpuid memeber variable
+     * @param[in/out]    parent     Domain to split.
      *
-     * @param[in]   void
+     * @param[in]        depth      Index of the child level in levels.
+     *
+     * @param[in]        levels     Domains of every level below the machine.
+     *
+     * @param[in]        owners     Index of the domain of every CPU, by level.
      *
      * @return      void
      */
-    void MoveNext()
+    static void buildDomains(CpuDomain&                           parent,
+                             size_t                               depth,
+                             const DomainLevels&                  levels,
+                             const std::vector<std::vector<int>>& owners)
     {
-        // Move to the next directory entry
-        while ((dp = readdir(dirp)) != NULL) {
-            std::string dirName(dp->d_name);
-            if (dirName.find("cpu") == 0 && isdigit(dirName[3])) {
-                cpuId = std::stoi(dirName.substr(3));
-                break;
-            }
+        if (depth == levels.size())
+            return;
+        std::vector<int> indexes;
+        for (int cpu : parent.cpus.toList()) {
+            if (owners[depth][cpu] >= 0)
+                indexes.push_back(owners[depth][cpu]);
         }
+        std::sort(indexes.begin(), indexes.end());
+        indexes.erase(std::unique(indexes.begin(), indexes.end()),
+                      indexes.end());
+        for (int index : indexes) {
+            CpuDomain child{ levels[depth].first,
+                             levels[depth].second[index],
+                             {} };
+            child.cpus &= parent.cpus;
+            buildDomains(child, depth + 1, levels, owners);
+            parent.children.push_back(std::move(child));
+        }
+    }
+
+    /**
+     * @brief            Collect the domains of one level, in tree order.
+     *
+     * @return      void
+     */
+    static void collectDomains(const CpuDomain&     domain,
+                               DomainLevel          level,
+                               std::vector<CpuSet>& sets)
+    {
+        if (domain.level == level) {
+            sets.push_back(domain.cpus);
+            return;
+        }
+        for (auto& child : domain.children)
+            collectDomains(child, level, sets);
     }
 
     /**
-     * @brief       Parse the line and store the information.
+     * @brief            Convert CPU sets to the mask format.
      *
-     * @details     This function parses the line and stores the information in
-     * the Map. The line is a comma separated string of hexadecimal values.
+     * @details          Removes duplicates and orders the result by the lowest
+     * CPU of every set.
      *
-     * @param[out]   std::vector<CoreMask>& Map
-     *               A vector of pairs that stores the mask and the position of
-     * the mask. obtained from parsing the line.
+     * @param[in]        std::vector<CpuSet>& sets
      *
-     * @param[in]   std::string line
+     * @param[out]       std::vector<std::vector<CoreMask>>& Map
      *
      * @return      void
      */
-    void parseLine(std::vector<CoreMask>& Map, std::string line)
+    void toMap(std::vector<CpuSet>&                sets,
+               std::vector<std::vector<CoreMask>>& Map)
     {
-        std::reverse(line.begin(), line.end());
-        std::stringstream ss(line);
-        int               position = 0;
-        std::string       chunk;
-        int               nonZeroMask = 0;
-
-        while (std::getline(ss, chunk, ',')) {
-            if (std::stoull(chunk, nullptr, 16)) {
-                std::reverse(chunk.begin(), chunk.end());
-
-                Map.resize(nonZeroMask + 1);
-                Map[nonZeroMask].first  = std::stoull(chunk, nullptr, 16);
-                Map[nonZeroMask].second = position;
-
-                nonZeroMask++;
-            }
-            position++;
-        }
+        eliminateDuplicates(sets);
+        for (auto& cpus : sets)
+            Map.push_back(cpus.toCoreMasks());
+        std::sort(Map.begin(), Map.end(), compareVectors);
     }
 
     /**
-     * @brief       Process the file and store the information.
+     * @brief            Keep the usable CPUs of every set.
      *
-     * @details     This function processes the file and stores the information
-     * in the Map. The file is a comma separated string of hexadecimal values.
+     * @details          Sets left without CPUs are removed.
      *
-     * @param[out]   std::vector<CoreMask>& Map
-     *               A vector of pairs that stores the mask and the position of
-     * the mask. obtained from parsing the line.
+     * @param[in/out]    sets       CPU sets to restrict.
      *
-     * @param[in]   std::ifstream& file
+     * @param[in]        usable     CPUs the process may use.
      *
      * @return      void
      */
-    void processFile(std::vector<CoreMask>& Map, std::ifstream& file)
+    static void restrictTo(std::vector<CpuSet>& sets, const CpuSet& usable)
     {
-        std::string line;
-        if (getline(file, line))
-            parseLine(Map, line);
+        for (auto& set : sets)
+            set &= usable;
+        auto empty = [](const CpuSet& set) { return set.empty(); };
+        sets.erase(std::remove_if(sets.begin(), sets.end(), empty), sets.end());
     }
 
     /**
-     * @brief       Get the current directory entry.
+     * @brief            Collect the CPUs of every NUMA node.
      *
-     * @details     This function gets the current directory entry.
+     * @details          Reads <root>/node/node<id>/cpulist for every node with
+     * CPUs, in node id order. Left empty on kernels without NUMA support.
      *
-     * @param[out]   std::vector<CoreMask>& Map
-     *               A vector of pairs that stores the mask and the position of
-     * the mask. obtained from parsing the line.
+     * @param[in]        sysfsRoot  Usually /sys/devices/system
+     *
+     * @param[out]       numaNodes  The CPUs of every node
      *
      * @return      void
      */
-    void Current(std::vector<CoreMask>& Map)
+    static void readNumaNodes(const std::string&   sysfsRoot,
+                              std::vector<CpuSet>& numaNodes)
     {
-        if (dp) {
-            std::string   dirName(dp->d_name);
-            std::ifstream file("/sys/devices/system/cpu/" + dirName + filename);
-            // check if file is open, for offline cpus the file will not be
-            // present.
-            //  Hence will fail to open.
-            if (file.is_open()) {
-                processFile(Map, file);
-            }
+        SysfsDir         nodeRoot(sysfsRoot + "/node");
+        std::vector<int> ids = nodeRoot.list("node");
+        std::sort(ids.begin(), ids.end());
+        for (int id : ids) {
+            SysfsDir node(nodeRoot, ("node" + std::to_string(id)).c_str());
+            CpuSet   cpus;
+            // Memory only nodes (CXL expanders, HBM) have no CPUs to pin to
+            if (!node.readList("cpulist", cpus) || cpus.empty())
+                continue;
+            numaNodes.push_back(cpus);
         }
     }
-};
 
-class CpuTopology
-{
-  private:
+    /// Topology read from sysfs, before any restriction
+    struct SysfsScan
+    {
+        CpuSet                             online;
+        std::vector<CpuSet>                cores;
+        std::map<int, CpuSet>              packages;
+        std::map<int, std::vector<CpuSet>> caches; // By cache level
+        std::vector<CpuSet>                numaNodes;
+    };
+
     /**
-     * @brief            Eliminate duplicates from the Map.
+     * @brief            Read the cores, packages, caches and NUMA nodes.
      *
-     * @details          This function eliminates duplicates from the Map.
+     * @details          Single pass over cpu/cpu<id>. The siblings of a core
+     * share its package and caches, so only the first CPU of every core is
+     * read and a cache shared by CPUs already seen is not read again. Offline
+     * CPUs have no topology and are skipped.
      *
-     * @param[in/out]    std::vector<std::vector<CoreMask>>&
-     * Map A vector of unique pairs from the Map.
-     * @return      void
+     * @param[in]        sysfsRoot  Usually /sys/devices/system
+     *
+     * @return      SysfsScan
      */
-    void eliminateDuplicates(std::vector<std::vector<CoreMask>>& Map)
+    static SysfsScan scan(const std::string& sysfsRoot)
     {
-        std::sort(Map.begin(), Map.end());
-        auto newMap = std::unique(Map.begin(), Map.end());
-        Map.erase(newMap, Map.end());
+        SysfsDir              cpuRoot(sysfsRoot + "/cpu");
+        SysfsScan             sysfs{};
+        std::map<int, CpuSet> cached; // CPUs with a known cache, by level
+        for (int cpuId : cpuRoot.list("cpu")) {
+            if (sysfs.online.test(cpuId))
+                continue;
+            SysfsDir cpu(cpuRoot, ("cpu" + std::to_string(cpuId)).c_str());
+            SysfsDir topology(cpu, "topology");
+            CpuSet   siblings;
+            if (!topology.readList("thread_siblings_list", siblings)
+                || !siblings.test(cpuId))
+                continue;
+            sysfs.cores.push_back(siblings);
+            sysfs.online |= siblings;
+
+            int package = 0;
+            topology.readInt("physical_package_id", package);
+            sysfs.packages[package] |= siblings;
+
+            // Collect the Cache --> Logical core mapping. The index numbering
+            // differs across platforms, the level and type files tell the
+            // caches apart.
+            SysfsDir cache(cpu, "cache");
+            for (int indexId : cache.list("index")) {
+                std::string name = "index" + std::to_string(indexId);
+                SysfsDir    index(cache, name.c_str());
+                int         level = 0;
+                CpuSet      shared;
+                if (!index.readInt("level", level)
+                    || cached[level].test(cpuId)
+                    || index.readEquals("type", "Instruction")
+                    || !index.readList("shared_cpu_list", shared))
+                    continue;
+                cached[level] |= shared;
+                sysfs.caches[level].push_back(shared);
+            }
+        }
+        readNumaNodes(sysfsRoot, sysfs.numaNodes);
+        return sysfs;
     }
 
     /**
-     * @brief            Compare two vectors.
+     * @brief            Build the topology of the allowed CPUs.
      *
-     * @details          Used to reorder the vector after eliminating
-     * duplicates.
-     *
-     * @param[in]        const std::vector<CoreMask>& a
-     *                   A vector of pairs.
-     * @param[in]        const std::vector<CoreMask>& b
-     *                   A vector of pairs.
+     * @param[in]        sysfs      Topology read from sysfs.
      *
-     * @return           bool
+     * @param[in]        allowed    CPUs the process may run on, empty for all
+     * of them.
      */
-    static bool compareVectors(const std::vector<CoreMask>& a,
-                               const std::vector<CoreMask>& b)
+    CpuTopology(const SysfsScan& sysfs, const CpuSet& allowed)
+        : active_processors(0)
+        , max_processors(0)
+        , processorMap{}
+        , cacheMap{}
+        , groupMap{}
+        , numaMap{}
+        , cacheDomains{}
+        , domainTree{ DomainLevel::eMachine, CpuSet(), {} }
+        , availableProcessors{}
     {
-        if (a[0].second == b[0].second)
-            return a[0].first < b[0].first;
-        else
-            return a[0].second < b[0].second;
+        const CpuSet&         online   = sysfs.online;
+        std::vector<CpuSet>   cores    = sysfs.cores;
+        std::map<int, CpuSet> packages = sysfs.packages;
+        cacheDomains                   = sysfs.caches;
+
+        // Pods and taskset limit the CPUs the process may run on, pinning to
+        // any other CPU fails
+        CpuSet usable = online;
+        usable &= allowed;
+        if (allowed.empty() || usable.empty())
+            usable = online;
+        restrictTo(cores, usable);
+        for (auto& package : packages)
+            package.second &= usable;
+        for (auto& level : cacheDomains) {
+            restrictTo(level.second, usable);
+            sortByFirstCpu(level.second);
+        }
+        toMap(cores, processorMap);
+
+        // cacheMap holds the last level cache; without cache information
+        // (some VMs) all CPUs share one cache
+        std::vector<CpuSet> caches;
+        if (!cacheDomains.empty())
+            caches = cacheDomains.rbegin()->second;
+        else if (!usable.empty())
+            caches.push_back(usable);
+        toMap(caches, cacheMap);
+
+        active_processors = usable.count();
+        if (active_processors == 0)
+            active_processors = get_nprocs();
+        max_processors =
+            std::max<uint32_t>(online.size(), active_processors);
+        availableProcessors = usable.toList();
+
+        // Collect the Group --> Logical core mapping
+        for (auto& mask : usable.toCoreMasks()) {
+            groupMap.resize(mask.second + 1,
+                            std::make_pair(0UL, CpuSet::cWordBits));
+            groupMap[mask.second].first = mask.first;
+        }
+
+        // Collect the NUMA node --> Logical core mapping
+        std::vector<CpuSet> numaNodes = sysfs.numaNodes;
+        restrictTo(numaNodes, usable);
+        for (auto& node : numaNodes)
+            numaMap.push_back(node.toCoreMasks());
+
+        // Build the domain tree, a level the platform does not report is a
+        // single domain
+        std::vector<CpuSet> packageSets, threads;
+        for (auto& package : packages) {
+            if (!package.second.empty())
+                packageSets.push_back(package.second);
+        }
+        for (int cpu : availableProcessors) {
+            threads.emplace_back();
+            threads.back().set(cpu);
+        }
+        auto cacheLevel = [this](int level) {
+            auto it = cacheDomains.find(level);
+            return it == cacheDomains.end() ? std::vector<CpuSet>()
+                                            : it->second;
+        };
+        DomainLevels levels = {
+            { DomainLevel::ePackage, packageSets },
+            { DomainLevel::eNuma, numaNodes },
+            { DomainLevel::eL3, cacheLevel(3) },
+            { DomainLevel::eL2, cacheLevel(2) },
+            { DomainLevel::eCore, cores },
+            { DomainLevel::eThread, threads },
+        };
+        std::vector<std::vector<int>> owners;
+        for (auto& level : levels) {
+            if (level.second.empty())
+                level.second.push_back(usable);
+            sortByFirstCpu(level.second);
+            owners.emplace_back(online.size(), -1);
+            for (size_t index = 0; index < level.second.size(); index++) {
+                for (int cpu : level.second[index].toList()) {
+                    if (cpu < online.size())
+                        owners.back()[cpu] = index;
+                }
+            }
+        }
+        domainTree.cpus = usable;
+        buildDomains(domainTree, 0, levels, owners);
     }
 
   public:
     uint32_t                           active_processors;
+    uint32_t                           max_processors;
     std::vector<std::vector<CoreMask>> processorMap;
     std::vector<std::vector<CoreMask>> cacheMap;
     std::vector<CoreMask>              groupMap;
+    std::vector<std::vector<CoreMask>> numaMap;
+    std::map<int, std::vector<CpuSet>> cacheDomains; // By cache level
+    CpuDomain                          domainTree;
+    std::vector<int>                   availableProcessors; // Ascending
 
+    /**
+     * @brief       Get the topology of the process.
+     *
+     * @details     Restricted to the CPUs the process may run on and to the
+     * partition selected with setPartition(), by default the one given by
+     * AU_CPU_PARTITION, see ofProcess(). sysfs is read once.
+     */
     static const CpuTopology& get()
     {
-        static const CpuTopology info;
-        return info;
+        Partitions& state    = partitions();
+        auto        topology = state.current.load(std::memory_order_acquire);
+        if (topology != nullptr)
+            return *topology;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.current.load() == nullptr)
+            select(state, environmentPartition(std::getenv));
+        return *state.current.load();
     }
 
-    CpuTopology()
-        : active_processors(0)
-        , processorMap{}
-        , cacheMap{}
-        , groupMap{}
+    /**
+     * @brief       Select the partition of the process.
+     *
+     * @details     Replaces AU_CPU_PARTITION, for processes which only learn
+     * their rank at run time. get() then returns the topology of the slice,
+     * the topologies it returned before stay valid.
+     *
+     * @param[in]   spec    Slice of the process, index below count.
+     */
+    static void setPartition(const PartitionSpec& spec)
     {
-        active_processors = get_nprocs();
-        LogicalProcessorInformation processorInfo("/topology/thread_siblings");
-        LogicalProcessorInformation cacheInfo("/cache/index3/shared_cpu_map");
-
-        // Collect the physical core -> logical core mapping
-        processorMap.resize(active_processors);
-        processorInfo.MoveNext();
-        while (processorInfo.dp) {
-            processorInfo.Current(processorMap[processorInfo.cpuId]);
-            processorInfo.MoveNext();
-        }
-        eliminateDuplicates(processorMap);
-        std::sort(processorMap.begin(), processorMap.end(), compareVectors);
-
-        // Collect the L3 Cache --> Logical core mapping
-        cacheMap.resize(active_processors);
-        cacheInfo.MoveNext();
-        while (cacheInfo.dp) {
-            cacheInfo.Current(cacheMap[cacheInfo.cpuId]);
-            cacheInfo.MoveNext();
+        Partitions&                 state = partitions();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        select(state, spec);
+    }
+
+    /**
+     * @brief       Get the partition of the process.
+     *
+     * @return      PartitionSpec, from setPartition() or AU_CPU_PARTITION
+     */
+    static PartitionSpec getPartition()
+    {
+        get();
+        Partitions&                 state = partitions();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.spec;
+    }
+
+    /**
+     * @brief       Read the partition from AU_CPU_PARTITION.
+     *
+     * @details     A malformed value is reported on stderr when warnings are
+     * enabled on the LogWriter. Not through the LogWriter itself: its
+     * logging thread may be the first to get the topology while another
+     * thread holds the LogWriter instance lock to join it.
+     *
+     * @param[in]   getenv      Reads the environment.
+     *
+     * @return      PartitionSpec, the whole machine if the variable is not
+     * set or malformed
+     */
+    static PartitionSpec environmentPartition(
+        const PartitionSpec::Getenv& getenv)
+    {
+        PartitionSpec spec;
+        if (PartitionSpec::fromEnvironment(spec, getenv))
+            return spec;
+        using Level       = Logger::Priority::PriorityLevel;
+        const char* value = getenv(PartitionSpec::cVariable);
+        if (Logger::LogWriter::isEnabled(Level::eWarning)) {
+            std::cerr << "Ignoring malformed " << PartitionSpec::cVariable
+                      << "=" << (value ? value : "") << std::endl;
         }
+        return PartitionSpec();
+    }
 
-        eliminateDuplicates(cacheMap);
-        std::sort(cacheMap.begin(), cacheMap.end(), compareVectors);
+    /**
+     * @brief       Get the CPUs the process is allowed to run on.
+     *
+     * @details     The intersection of the process affinity mask and the
+     * cpuset of its cgroup. Either is ignored if it cannot be read.
+     *
+     * @return      CpuSet, empty if neither can be read
+     */
+    static CpuSet allowedCpus()
+    {
+        CpuSet cpus   = CpuSet::ofProcess();
+        CpuSet cpuset = cgroupCpus();
+        if (cpus.empty())
+            cpus = cpuset;
+        else if (!cpuset.empty())
+            cpus &= cpuset;
+        return cpus;
+    }
 
-        // Collect the Group --> Logical core mapping
-        groupMap.resize(active_processors);
-        for (size_t cpuId = 0; cpuId < processorMap.size(); cpuId++) {
-            for (auto processorMask : processorMap[cpuId]) {
-                int groupIndex = processorMask.second;
-                groupMap[groupIndex].first |= processorMask.first;
-                std::bitset<32> bits(processorMask.first);
-                groupMap[groupIndex].second += bits.count();
+    /**
+     * @brief       Get the cpuset of the cgroup of the process.
+     *
+     * @return      CpuSet, empty if it cannot be read
+     */
+    static CpuSet cgroupCpus()
+    {
+        CpuSet cpuset;
+        if (!Cgroup().cpuset(cpuset))
+            return CpuSet();
+        return cpuset;
+    }
+
+    /**
+     * @brief       Read the topology from sysfs.
+     *
+     * @details     Masks are CpuSet::cWordBits wide: mask n of a core, cache
+     * or node covers the CPUs n * cWordBits onwards. groupMap has one entry per
+     * mask position with the allowed CPUs and the mask width, so the offsets
+     * derived from it are exact even when CPUs are offline.
+     *
+     * All the maps, the domains and active_processors only hold the CPUs
+     * which are online and allowed. When none of the online CPUs is allowed
+     * the restriction is ignored.
+     *
+     * @param[in]   sysfsRoot   Directory holding the cpu/ and node/ trees,
+     * a synthetic tree can be given for testing.
+     *
+     * @param[in]   allowed     CPUs the process may run on, empty for all of
+     * them.
+     */
+    explicit CpuTopology(const std::string& sysfsRoot = "/sys/devices/system",
+                         const CpuSet&      allowed   = allowedCpus())
+        : CpuTopology(scan(sysfsRoot), allowed)
+    {
+    }
+
+    /**
+     * @brief       Get the domains of one level of the tree.
+     *
+     * @details     For example getDomains(DomainLevel::eL2) lists the CPUs
+     * sharing every L2 cache, grouped by package, NUMA node and L3 cache.
+     *
+     * @param[in]   level   Level of the tree.
+     *
+     * @return      std::vector<CpuSet>
+     */
+    std::vector<CpuSet> getDomains(DomainLevel level) const
+    {
+        std::vector<CpuSet> sets;
+        collectDomains(domainTree, level, sets);
+        return sets;
+    }
+
+    /**
+     * @brief       Split a domain into balanced slices.
+     *
+     * @details     The CPUs are ordered as in the domain tree. The boundary
+     * between slice i - 1 and slice i is ideally i * N / count CPUs in; it
+     * moves to the start of the outermost domain within a sixteenth of a
+     * slice of it, otherwise to the nearest physical core. Slices are thus
+     * aligned on caches and nodes whenever that keeps them balanced. SMT
+     * siblings are only split with more slices than cores and slices share
+     * CPUs with more slices than CPUs.
+     * Example
+     * 2 packages of 2 L3 caches of 4 SMT2 cores
+     * count 2     = the packages
+     * count 4     = the L3 caches
+     * count 3     = 5, 6 and 5 cores, slice 1 straddles the packages
+     *
+     * @param[in]   domain  Domain to split, usually domainTree.
+     *
+     * @param[in]   count   Number of slices.
+     *
+     * @param[in]   index   Slice to return, below count.
+     *
+     * @return      CpuSet, empty only if the domain is
+     */
+    static CpuSet partition(const CpuDomain& domain, size_t count, size_t index)
+    {
+        // CPUs in tree order and the outermost level starting at each
+        // position
+        std::vector<int>                      order;
+        std::map<size_t, DomainLevel>         starts;
+        std::function<void(const CpuDomain&)> walk =
+            [&](const CpuDomain& node) {
+                auto start = starts.emplace(order.size(), node.level).first;
+                start->second = std::min(start->second, node.level);
+                if (node.children.empty()) {
+                    for (int cpu : node.cpus.toList())
+                        order.push_back(cpu);
+                }
+                for (auto& child : node.children)
+                    walk(child);
+            };
+        walk(domain);
+        starts[order.size()] = DomainLevel::eMachine;
+        if (order.empty() || count <= 1)
+            return domain.cpus;
+
+        // Position within tolerance of target, of the outermost level first
+        // or the nearest one, SIZE_MAX if there is none
+        auto nearest = [&starts](double      target,
+                                 DomainLevel finest,
+                                 double      tolerance,
+                                 bool        outermost) {
+            size_t      best         = SIZE_MAX;
+            double      bestDistance = 0;
+            DomainLevel bestLevel    = DomainLevel::eThread;
+            for (auto& start : starts) {
+                double distance = std::fabs(double(start.first) - target);
+                if (start.second > finest || distance > tolerance)
+                    continue;
+                bool better =
+                    best == SIZE_MAX
+                    || (outermost && start.second != bestLevel
+                            ? start.second < bestLevel
+                            : distance < bestDistance);
+                if (better) {
+                    best         = start.first;
+                    bestDistance = distance;
+                    bestLevel    = start.second;
+                }
             }
-        }
-        while (!groupMap.back().first) {
-            groupMap.pop_back();
-        }
+            return best;
+        };
+        double slice    = double(order.size()) / count;
+        auto   boundary = [&](double target) {
+            size_t pos = nearest(target, DomainLevel::eCore, slice / 16, true);
+            if (pos == SIZE_MAX)
+                pos = nearest(target, DomainLevel::eCore, slice / 2, false);
+            if (pos == SIZE_MAX)
+                pos = nearest(target, DomainLevel::eThread, 1e18, false);
+            return pos;
+        };
+
+        size_t first = index == 0 ? 0 : boundary(index * slice);
+        size_t last =
+            index + 1 == count ? order.size() : boundary((index + 1) * slice);
+        CpuSet cpus;
+        if (last <= first)
+            cpus.set(order[std::min(first, order.size() - 1)]);
+        for (size_t pos = first; pos < last; pos++)
+            cpus.set(order[pos]);
+        return cpus;
+    }
+
+    /**
+     * @brief       Read the topology of the process from sysfs.
+     *
+     * @details     Restricted to the online CPUs of the cgroup cpuset and the
+     * affinity of the process. With more than one slice, see PartitionSpec,
+     * the slice is cut from the online CPUs of the cpuset: all the processes
+     * of a job see the same set, so their slices are disjoint and cover it.
+     * A process whose affinity is narrower than that set was already bound by
+     * its launcher (mpirun, srun) and keeps its CPUs.
+     *
+     * @param[in]   sysfsRoot   Directory holding the cpu/ and node/ trees.
+     *
+     * @param[in]   spec        Slice of the process.
+     *
+     * @param[in]   affinity    CPUs of the affinity, empty for all of them.
+     *
+     * @param[in]   cpuset      CPUs of the cgroup, empty for all of them.
+     *
+     * @return      CpuTopology
+     */
+    static CpuTopology ofProcess(const std::string&   sysfsRoot,
+                                 const PartitionSpec& spec,
+                                 const CpuSet& affinity = CpuSet::ofProcess(),
+                                 const CpuSet& cpuset   = cgroupCpus())
+    {
+        return ofScan(scan(sysfsRoot), spec, affinity, cpuset);
+    }
+
+  private:
+    /// Topologies of the partitions selected so far, see get()
+    struct Partitions
+    {
+        std::mutex                      mutex{};
+        std::atomic<const CpuTopology*> current{ nullptr };
+        PartitionSpec                   spec{};
+        std::unique_ptr<SysfsScan>      sysfs{}; ///< Read on first use
+        std::map<std::pair<size_t, size_t>, std::unique_ptr<CpuTopology>>
+            built{}; ///< By index and count
+    };
+
+    static Partitions& partitions()
+    {
+        static Partitions state;
+        return state;
+    }
+
+    /**
+     * @brief       Make a partition current, building its topology once.
+     *
+     * @details     Called with state.mutex held.
+     */
+    static void select(Partitions& state, const PartitionSpec& spec)
+    {
+        if (!state.sysfs)
+            state.sysfs =
+                std::make_unique<SysfsScan>(scan("/sys/devices/system"));
+        auto& topology = state.built[{ spec.index, spec.count }];
+        if (!topology)
+            topology = std::make_unique<CpuTopology>(ofScan(
+                *state.sysfs, spec, CpuSet::ofProcess(), cgroupCpus()));
+        state.spec = spec;
+        state.current.store(topology.get(), std::memory_order_release);
+    }
+
+    /**
+     * @brief       ofProcess() on a topology already read from sysfs.
+     */
+    static CpuTopology ofScan(const SysfsScan&     sysfs,
+                              const PartitionSpec& spec,
+                              const CpuSet&        affinity,
+                              const CpuSet&        cpuset)
+    {
+        CpuSet shared = sysfs.online;
+        shared &= cpuset;
+        if (cpuset.empty() || shared.empty())
+            shared = sysfs.online;
+        CpuSet allowed = shared;
+        allowed &= affinity;
+        if (affinity.empty() || allowed.empty())
+            allowed = shared;
+
+        CpuTopology topology(sysfs, allowed);
+        if (spec.count <= 1 || !(allowed == shared))
+            return topology;
+        return CpuTopology(
+            sysfs, partition(topology.domainTree, spec.count, spec.index));
     }
 };
 } // namespace Au
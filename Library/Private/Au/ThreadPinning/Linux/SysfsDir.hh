@@ -0,0 +1,233 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include "Au/ThreadPinning/Linux/CpuSet.hh"
+
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @brief       Open sysfs directory, the base of the topology loader.
+ *
+ * @details     Entries are opened relative to the directory with openat and
+ * read with a single pread into a stack buffer, so reading an attribute costs
+ * three system calls and no heap allocation. sysfs attributes are generated
+ * on every read, the whole file is read at once.
+ */
+class SysfsDir
+{
+  private:
+    int m_fd;
+
+    static constexpr int cFlags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+
+  public:
+    /// Attributes fit in a page; longer cpulists are read on the heap
+    static constexpr size_t cBufferSize = 4096;
+
+    /**
+     * @brief       Open a directory.
+     *
+     * @param[in]   path    Absolute path of the directory.
+     */
+    explicit SysfsDir(const std::string& path)
+        : m_fd(open(path.c_str(), cFlags))
+    {
+    }
+
+    /**
+     * @brief       Open a subdirectory of an open directory.
+     *
+     * @param[in]   parent  Open directory, may have failed to open.
+     *
+     * @param[in]   name    Path relative to parent.
+     */
+    SysfsDir(const SysfsDir& parent, const char* name)
+        : m_fd(parent.m_fd < 0 ? -1 : openat(parent.m_fd, name, cFlags))
+    {
+    }
+
+    SysfsDir(const SysfsDir&)            = delete;
+    SysfsDir& operator=(const SysfsDir&) = delete;
+
+    ~SysfsDir()
+    {
+        if (m_fd >= 0)
+            close(m_fd);
+    }
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    /**
+     * @brief       List the entries named <prefix><number>, such as cpu12.
+     *
+     * @param[in]   prefix  Name of the entries without the number.
+     *
+     * @return      std::vector<int>, the numbers in directory order
+     */
+    std::vector<int> list(const char* prefix) const
+    {
+        std::vector<int> ids;
+        // fdopendir takes over the descriptor it is given
+        int fd = m_fd < 0 ? -1 : dup(m_fd);
+        DIR* dirp = fd < 0 ? NULL : fdopendir(fd);
+        if (dirp == NULL) {
+            if (fd >= 0)
+                close(fd);
+            return ids;
+        }
+        rewinddir(dirp);
+
+        size_t         prefixLength = strlen(prefix);
+        struct dirent* dp;
+        while ((dp = readdir(dirp)) != NULL) {
+            const char* name = dp->d_name;
+            if (strncmp(name, prefix, prefixLength) != 0)
+                continue;
+            name += prefixLength;
+            int id = 0;
+            if (*name < '0' || *name > '9')
+                continue;
+            for (; *name >= '0' && *name <= '9'; name++)
+                id = id * 10 + (*name - '0');
+            if (*name == '\0')
+                ids.push_back(id);
+        }
+        closedir(dirp);
+        return ids;
+    }
+
+    /**
+     * @brief       Read an attribute into a buffer.
+     *
+     * @param[in]   name    Path relative to the directory.
+     *
+     * @param[out]  buffer  Receives the contents, not NUL terminated.
+     *
+     * @param[in]   size    Size of the buffer.
+     *
+     * @return      ssize_t, bytes read or -1 if the file cannot be read
+     */
+    ssize_t read(const char* name, char* buffer, size_t size) const
+    {
+        if (m_fd < 0)
+            return -1;
+        int fd = openat(m_fd, name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return -1;
+        ssize_t length = pread(fd, buffer, size, 0);
+        close(fd);
+        return length;
+    }
+
+    /**
+     * @brief       Read a decimal attribute such as a cache level.
+     *
+     * @param[in]   name    Path relative to the directory.
+     *
+     * @param[out]  value   The number.
+     *
+     * @return      bool, false if the file cannot be read or is not a number
+     */
+    bool readInt(const char* name, int& value) const
+    {
+        char    buffer[32];
+        ssize_t length = read(name, buffer, sizeof(buffer));
+        if (length <= 0)
+            return false;
+        char* pos      = buffer;
+        bool  negative = *pos == '-';
+        if (negative)
+            pos++;
+        if (pos == buffer + length || *pos < '0' || *pos > '9')
+            return false;
+        int parsed = 0;
+        for (; pos != buffer + length && *pos >= '0' && *pos <= '9'; pos++)
+            parsed = parsed * 10 + (*pos - '0');
+        value = negative ? -parsed : parsed;
+        return true;
+    }
+
+    /**
+     * @brief       Check the contents of a text attribute.
+     *
+     * @param[in]   name    Path relative to the directory.
+     *
+     * @param[in]   text    Expected contents without the newline.
+     *
+     * @return      bool, false if the file differs or cannot be read
+     */
+    bool readEquals(const char* name, const char* text) const
+    {
+        char    buffer[64];
+        ssize_t length = read(name, buffer, sizeof(buffer));
+        size_t  textLength = strlen(text);
+        if (length < ssize_t(textLength))
+            return false;
+        return memcmp(buffer, text, textLength) == 0
+               && (length == ssize_t(textLength)
+                   || buffer[textLength] == '\n');
+    }
+
+    /**
+     * @brief       Read a cpulist attribute such as shared_cpu_list.
+     *
+     * @param[in]   name    Path relative to the directory.
+     *
+     * @param[out]  cpus    The CPUs listed.
+     *
+     * @return      bool, false if the file cannot be read or is malformed
+     */
+    bool readList(const char* name, CpuSet& cpus) const
+    {
+        char    buffer[cBufferSize];
+        ssize_t length = read(name, buffer, sizeof(buffer));
+        if (length < 0)
+            return false;
+        cpus = CpuSet();
+        if (size_t(length) < sizeof(buffer))
+            return CpuSet::parseList(buffer, length, cpus);
+
+        // Lists of thousands of CPUs can exceed a page on recent kernels
+        std::vector<char> heap(2 * cBufferSize);
+        int               fd = openat(m_fd, name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        size_t total = 0;
+        while ((length = pread(fd, &heap[total], heap.size() - total, total))
+               > 0) {
+            total += length;
+            if (total == heap.size())
+                heap.resize(2 * heap.size());
+        }
+        close(fd);
+        return length == 0 && CpuSet::parseList(heap.data(), total, cpus);
+    }
+};
+
+} // namespace Au
@@ -0,0 +1,154 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+namespace Au {
+
+/**
+ * @brief       Slice of the machine a process pins its threads in.
+ *
+ * @details     Processes sharing a machine, such as the ranks of an MPI job,
+ * each take one of count balanced slices of the CPUs they may run on. Every
+ * pinning strategy then only uses the CPUs of the slice. The slice is read
+ * from the AU_CPU_PARTITION environment variable:
+ *
+ * | Value          | Meaning                                               |
+ * |----------------|-------------------------------------------------------|
+ * | index/count    | Slice index of count, index starting at 0             |
+ * | auto           | Slice of the local rank, as given by the launcher     |
+ * | unset or none  | The whole machine                                     |
+ *
+ * auto reads, in order, the local rank and local size of Open MPI
+ * (OMPI_COMM_WORLD_LOCAL_RANK/SIZE), MPICH and Intel MPI (MPI_LOCALRANKID,
+ * MPI_LOCALNRANKS), MVAPICH (MV2_COMM_WORLD_LOCAL_RANK/SIZE) and Slurm
+ * (SLURM_LOCALID, SLURM_NTASKS_PER_NODE). Without any of them the process
+ * gets the whole machine.
+ */
+class PartitionSpec
+{
+  public:
+    using Getenv = std::function<const char*(const char*)>;
+
+    static constexpr const char* cVariable = "AU_CPU_PARTITION";
+
+    size_t index{ 0 };
+    size_t count{ 1 };
+
+    /**
+     * @brief       Parse a specification such as "3/8" or "auto".
+     *
+     * @param[in]   text    The specification.
+     *
+     * @param[out]  spec    The parsed specification, unchanged on error.
+     *
+     * @param[in]   getenv  Reads the launcher variables for "auto".
+     *
+     * @return      bool, false if the specification is malformed or the
+     *              index is not below the count
+     */
+    static bool parse(const std::string& text,
+                      PartitionSpec&     spec,
+                      const Getenv&      getenv = std::getenv)
+    {
+        std::string token;
+        for (char c : text) {
+            if (!isspace(static_cast<unsigned char>(c)))
+                token += tolower(static_cast<unsigned char>(c));
+        }
+
+        PartitionSpec result;
+        if (token == "auto")
+            return fromLauncher(spec, getenv);
+        if (token.empty() || token == "none") {
+            spec = result;
+            return true;
+        }
+        size_t slash = token.find('/');
+        if (slash == std::string::npos
+            || !toNumber(token.substr(0, slash), result.index)
+            || !toNumber(token.substr(slash + 1), result.count)
+            || result.index >= result.count)
+            return false;
+        spec = result;
+        return true;
+    }
+
+    /**
+     * @brief       Read the specification from AU_CPU_PARTITION.
+     *
+     * @param[out]  spec    The parsed specification, the whole machine if
+     *                      the variable is not set.
+     *
+     * @param[in]   getenv  Reads the environment.
+     *
+     * @return      bool, false if the variable is malformed
+     */
+    static bool fromEnvironment(PartitionSpec& spec,
+                                const Getenv&  getenv = std::getenv)
+    {
+        const char* text = getenv(cVariable);
+        return parse(text ? text : "", spec, getenv);
+    }
+
+  private:
+    static bool toNumber(const std::string& text, size_t& value)
+    {
+        if (text.empty() || text.size() > 9)
+            return false;
+        for (char c : text) {
+            if (!isdigit(static_cast<unsigned char>(c)))
+                return false;
+        }
+        value = std::stoul(text);
+        return true;
+    }
+
+    static bool fromLauncher(PartitionSpec& spec, const Getenv& getenv)
+    {
+        static const char* const cLaunchers[][2] = {
+            { "OMPI_COMM_WORLD_LOCAL_RANK", "OMPI_COMM_WORLD_LOCAL_SIZE" },
+            { "MPI_LOCALRANKID", "MPI_LOCALNRANKS" },
+            { "MV2_COMM_WORLD_LOCAL_RANK", "MV2_COMM_WORLD_LOCAL_SIZE" },
+            { "SLURM_LOCALID", "SLURM_NTASKS_PER_NODE" },
+        };
+        for (auto& launcher : cLaunchers) {
+            const char*   rank = getenv(launcher[0]);
+            const char*   size = getenv(launcher[1]);
+            PartitionSpec result;
+            if (!rank || !size)
+                continue;
+            if (!toNumber(rank, result.index) || !toNumber(size, result.count)
+                || result.index >= result.count)
+                return false;
+            spec = result;
+            return true;
+        }
+        spec = PartitionSpec{};
+        return true;
+    }
+};
+
+} // namespace Au
@@ -0,0 +1,152 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @brief       Placement policies, after KMP_AFFINITY and OMP_PROC_BIND.
+ */
+enum class PlacementPolicy
+{
+    eCompact, ///< Thread n + 1 as close as possible to thread n
+    eScatter, ///< Thread n + 1 as far as possible from thread n
+    eClose,   ///< Consecutive places, one thread per place first
+    eSpread   ///< Places evenly spaced over the machine
+};
+
+/**
+ * @brief       Places of the close and spread policies, as in OMP_PLACES.
+ */
+enum class PlaceKind
+{
+    eThreads,    ///< Every logical processor
+    eCores,      ///< The logical processors of a physical core
+    eCaches,     ///< The logical processors sharing the last level cache
+    eNumaDomains ///< The logical processors of a NUMA node
+};
+
+/**
+ * @brief       Parsed placement specification.
+ *
+ * @details     A specification is a comma separated list starting with the
+ * policy, followed by modifiers:
+ *
+ * | Modifier            | Meaning                                          |
+ * |---------------------|--------------------------------------------------|
+ * | N or permute=N      | compact, scatter: the N innermost levels of the  |
+ * |                     | topology become the most significant ones        |
+ * | places=P            | close, spread: threads, cores, ll_caches or      |
+ * |                     | numa_domains, threads by default                 |
+ * | nosmt               | one thread per physical core, the SMT siblings   |
+ * |                     | are never used                                   |
+ *
+ * The levels of the topology are, outermost first, NUMA node, last level
+ * cache, physical core and SMT thread. For example "compact,1" places
+ * consecutive threads on neighbouring physical cores and only then on their
+ * siblings, "scatter" round robins the NUMA nodes and "spread,places=cores"
+ * gives every thread its own physical core, as far apart as the thread count
+ * allows. Names are case insensitive and blanks are ignored.
+ */
+class PlacementSpec
+{
+  public:
+    static constexpr int cLevels = 4; // node, cache, core, SMT thread
+
+    PlacementPolicy policy{ PlacementPolicy::eCompact };
+    PlaceKind       places{ PlaceKind::eThreads };
+    int             permute{ 0 };
+    bool            noSmt{ false };
+
+    /**
+     * @brief       Parse a specification such as "compact,1,nosmt".
+     *
+     * @param[in]   text    The specification.
+     *
+     * @param[out]  spec    The parsed specification, unchanged on error.
+     *
+     * @return      bool, false if the specification is malformed
+     */
+    static bool parse(const std::string& text, PlacementSpec& spec)
+    {
+        std::vector<std::string> tokens(1);
+        for (char c : text) {
+            if (c == ',')
+                tokens.emplace_back();
+            else if (!isspace(static_cast<unsigned char>(c)))
+                tokens.back() += tolower(static_cast<unsigned char>(c));
+        }
+
+        PlacementSpec result;
+        const auto&   policy = tokens[0];
+        if (policy == "compact")
+            result.policy = PlacementPolicy::eCompact;
+        else if (policy == "scatter")
+            result.policy = PlacementPolicy::eScatter;
+        else if (policy == "close")
+            result.policy = PlacementPolicy::eClose;
+        else if (policy == "spread")
+            result.policy = PlacementPolicy::eSpread;
+        else
+            return false;
+        bool bindsPlaces = result.policy == PlacementPolicy::eClose
+                           || result.policy == PlacementPolicy::eSpread;
+
+        for (size_t i = 1; i < tokens.size(); i++) {
+            std::string token = tokens[i];
+            if (token == "nosmt") {
+                result.noSmt = true;
+                continue;
+            }
+            if (token.compare(0, 8, "permute=") == 0)
+                token = token.substr(8);
+            else if (token.compare(0, 7, "places=") == 0) {
+                std::string place = token.substr(7);
+                if (!bindsPlaces)
+                    return false;
+                if (place == "threads")
+                    result.places = PlaceKind::eThreads;
+                else if (place == "cores")
+                    result.places = PlaceKind::eCores;
+                else if (place == "ll_caches")
+                    result.places = PlaceKind::eCaches;
+                else if (place == "numa_domains")
+                    result.places = PlaceKind::eNumaDomains;
+                else
+                    return false;
+                continue;
+            }
+            // What is left has to be the permute level
+            if (bindsPlaces || token.size() != 1 || token[0] < '0'
+                || token[0] >= '0' + cLevels)
+                return false;
+            result.permute = token[0] - '0';
+        }
+        spec = result;
+        return true;
+    }
+};
+
+} // namespace Au
@@ -21,8 +21,10 @@
  */
 #pragma once
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <numeric>
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -34,7 +36,11 @@
 #endif
 
 #include "Au/Assert.hh"
+#include "Au/Logger.hh"
+#include "Au/Status.hh"
+#include "Au/ThreadPinning/Placement.hh"
 #include <Au/ThreadPinning.hh>
+#include <array>
 namespace Au {
 
 class AffinityVector
@@ -359,7 +365,184 @@ class AffinityVector
         }
     }
 
+    /**
+     * @brief           Get the SMT rank of every logical core
+     *
+     * @details         The lowest numbered logical core of each physical core
+     *                  has rank 0, its SMT siblings 1, 2 ...
+     *
+     * @param[out]      smtRank     Map of core number to SMT rank
+     *
+     * @return          void
+     */
+    void getSmtRank(std::map<int, int>& smtRank)
+    {
+        for (const auto& core : cpuInfo.processorMap) {
+            std::vector<int> siblings;
+            coreMapToCoreList(core, siblings);
+            std::sort(siblings.begin(), siblings.end());
+            for (size_t rank = 0; rank < siblings.size(); rank++)
+                smtRank[siblings[rank]] = rank;
+        }
+    }
+
+    /**
+     * @brief           Get the NUMA domains
+     *
+     * @details         Splits the logical cores of every NUMA node by the L3
+     *                  cache they share. Within a cache, one logical core per
+     *                  physical core is listed first and the SMT siblings
+     *                  after them. Without NUMA information the machine is a
+     *                  single node; cores outside every cache map form a
+     *                  domain of their own.
+     * Example
+     * domains[1][0] = [8, 9, 10, 11, 24, 25, 26, 27]
+     * Implies, the first L3 cache of node 1 holds the physical cores 8 to 11
+     * whose SMT siblings are 24 to 27
+     *
+     * @param[out]      domains     Core lists indexed by node and cache
+     *
+     * @param[in]       smtRank     Map of core number to SMT rank
+     *
+     * @return          void
+     */
+    void getNumaDomains(std::vector<std::vector<std::vector<int>>>& domains,
+                        const std::map<int, int>&                   smtRank)
+    {
+        std::vector<std::vector<int>> nodes;
+        for (const auto& node : cpuInfo.numaMap) {
+            std::vector<int> coreList;
+            coreMapToCoreList(node, coreList);
+            if (coreList.size() != 0)
+                nodes.push_back(coreList);
+        }
+        if (nodes.size() == 0) {
+            std::vector<int> coreList;
+            for (auto& core : smtRank)
+                coreList.push_back(core.first);
+            if (coreList.size() == 0)
+                coreList = cpuInfo.availableProcessors;
+            if (coreList.size() == 0) {
+                coreList.resize(cpuInfo.active_processors);
+                std::iota(coreList.begin(), coreList.end(), 0);
+            }
+            nodes.push_back(coreList);
+        }
+
+        std::vector<std::vector<int>> caches;
+        for (const auto& cache : cpuInfo.cacheMap) {
+            std::vector<int> coreList;
+            coreMapToCoreList(cache, coreList);
+            caches.push_back(coreList);
+        }
+
+        auto byRank = [&smtRank](int a, int b) {
+            auto rankA = smtRank.find(a), rankB = smtRank.find(b);
+            return (rankA == smtRank.end() ? 0 : rankA->second)
+                   < (rankB == smtRank.end() ? 0 : rankB->second);
+        };
+        for (auto& node : nodes) {
+            std::set<int>                 inNode(node.begin(), node.end());
+            std::set<int>                 covered;
+            std::vector<std::vector<int>> nodeDomains;
+            for (auto& cache : caches) {
+                std::vector<int> domain;
+                for (int core : cache) {
+                    if (inNode.count(core) && covered.insert(core).second)
+                        domain.push_back(core);
+                }
+                if (domain.size() != 0)
+                    nodeDomains.push_back(domain);
+            }
+            std::vector<int> rest;
+            for (int core : node) {
+                if (!covered.count(core))
+                    rest.push_back(core);
+            }
+            if (rest.size() != 0)
+                nodeDomains.push_back(rest);
+
+            for (auto& domain : nodeDomains) {
+                std::sort(domain.begin(), domain.end());
+                std::stable_sort(domain.begin(), domain.end(), byRank);
+            }
+            domains.push_back(nodeDomains);
+        }
+    }
+
   public:
+    /// Logical core with its indexes at every level of the topology
+    using CpuLabel = std::pair<int, std::array<int, PlacementSpec::cLevels>>;
+
+    /**
+     * @brief           Label every logical core with its place in the topology
+     *
+     * @details         The levels are NUMA node, last level cache within the
+     *                  node, physical core within the cache and SMT rank
+     *                  within the core. Labels are ordered by logical core of
+     *                  the physical cores. Without a processor map every
+     *                  available logical core is a physical core.
+     * Example
+     * labels[5] = (20, [1, 0, 2, 1])
+     * Implies, logical core 20 is the SMT sibling on the third physical core
+     * of the first cache of node 1
+     *
+     * @param[out]      labels      The labelled logical cores
+     *
+     * @return          void
+     */
+    void getCpuLabels(std::vector<CpuLabel>& labels)
+    {
+        auto owners = [this](const std::vector<std::vector<CoreMask>>& map,
+                             std::map<int, int>&                       owner) {
+            for (size_t index = 0; index < map.size(); index++) {
+                std::vector<int> coreList;
+                coreMapToCoreList(map[index], coreList);
+                for (int core : coreList)
+                    owner.emplace(core, index);
+            }
+        };
+        std::map<int, int> cacheOf, nodeOf;
+        owners(cpuInfo.cacheMap, cacheOf);
+        owners(cpuInfo.numaMap, nodeOf);
+
+        std::vector<std::vector<int>> cores;
+        for (const auto& core : cpuInfo.processorMap) {
+            std::vector<int> siblings;
+            coreMapToCoreList(core, siblings);
+            std::sort(siblings.begin(), siblings.end());
+            if (siblings.size() != 0)
+                cores.push_back(siblings);
+        }
+        if (cores.size() == 0) {
+            std::vector<int> coreList = cpuInfo.availableProcessors;
+            if (coreList.size() == 0) {
+                coreList.resize(cpuInfo.active_processors);
+                std::iota(coreList.begin(), coreList.end(), 0);
+            }
+            for (int core : coreList)
+                cores.push_back({ core });
+        }
+        std::sort(cores.begin(), cores.end());
+
+        auto find = [](const std::map<int, int>& owner, int core) {
+            auto it = owner.find(core);
+            return it == owner.end() ? -1 : it->second;
+        };
+        std::map<int, std::map<int, int>> cacheRank;   // node -> cache -> rank
+        std::map<std::pair<int, int>, int> coreCount; // (node, rank) -> cores
+        for (auto& core : cores) {
+            int   node  = std::max(find(nodeOf, core[0]), 0);
+            auto& ranks = cacheRank[node];
+            int   cache = ranks.emplace(find(cacheOf, core[0]), ranks.size())
+                              .first->second;
+            int physical = coreCount[std::make_pair(node, cache)]++;
+            for (size_t rank = 0; rank < core.size(); rank++)
+                labels.push_back(
+                    { core[rank], { node, cache, physical, int(rank) } });
+        }
+    }
+
     AffinityVector(const CpuTopology& Info = CpuTopology::get())
         : cpuInfo{ Info }
     {
@@ -432,7 +615,7 @@ class AffinityVector
      * @brief           Get the logical core affinity vector
      *
      * @details         This function creates a vector that maps the threads to
-     *                  logical cores.
+     *                  the logical cores the process may run on, round robin.
      *
      * @param[out]      procVect    Vector to store the logical core affinity
      *
@@ -440,11 +623,212 @@ class AffinityVector
      */
     void getLogicalAffinityVector(std::vector<int>& procVect)
     {
-        int threadCount = procVect.size();
+        int         threadCount = procVect.size();
+        const auto& available   = cpuInfo.availableProcessors;
 
         procVect.clear();
         for (int threadId = 0; threadId < threadCount; threadId++) {
-            procVect.push_back(threadId % cpuInfo.active_processors);
+            if (available.size() != 0)
+                procVect.push_back(available[threadId % available.size()]);
+            else
+                procVect.push_back(threadId % cpuInfo.active_processors);
+        }
+    }
+
+    /**
+     * @brief           Get the NUMA spread affinity vector
+     *
+     * @details         This function balances the threads across the NUMA
+     *                  nodes, then across the L3 caches within each node,
+     *                  using one logical core per physical core before any
+     *                  SMT sibling. Consecutive threads share a node.
+     *
+     * @param[out]      procVect    Vector to store the NUMA spread affinity
+     *
+     * @return          void
+     */
+    void getNumaSpreadAffinityVector(std::vector<int>& procVect)
+    {
+        std::map<int, int>                         smtRank;
+        std::vector<std::vector<std::vector<int>>> domains;
+        getSmtRank(smtRank);
+        getNumaDomains(domains, smtRank);
+
+        int threadCount = procVect.size();
+        if (threadCount == 0)
+            return;
+        std::vector<int> nodeVect(threadCount);
+        createVector(nodeVect, 0, threadCount - 1, 0, domains.size() - 1);
+        std::map<int, std::vector<int>> nodeThreads;
+        for (int thread = 0; thread < threadCount; thread++)
+            nodeThreads[nodeVect[thread]].push_back(thread);
+
+        for (auto& node : nodeThreads) {
+            auto& caches = domains[node.first];
+            int   count  = node.second.size();
+            if (caches.size() == 0)
+                continue;
+            std::vector<int>    cacheVect(count);
+            std::vector<size_t> used(caches.size(), 0);
+            createVector(cacheVect, 0, count - 1, 0, caches.size() - 1);
+            for (int i = 0; i < count; i++) {
+                auto& coreList = caches[cacheVect[i]];
+                procVect[node.second[i]] =
+                    coreList[used[cacheVect[i]]++ % coreList.size()];
+            }
+        }
+    }
+
+    /**
+     * @brief           Get the NUMA compact affinity vector
+     *
+     * @details         This function fills the physical cores of one NUMA
+     *                  node, L3 cache by L3 cache, before moving to the next
+     *                  node. SMT siblings are used once every physical core
+     *                  has a thread, in the same order.
+     *
+     * @param[out]      procVect    Vector to store the NUMA compact affinity
+     *
+     * @return          void
+     */
+    void getNumaCompactAffinityVector(std::vector<int>& procVect)
+    {
+        std::map<int, int>                         smtRank;
+        std::vector<std::vector<std::vector<int>>> domains;
+        getSmtRank(smtRank);
+        getNumaDomains(domains, smtRank);
+
+        int maxRank = 0;
+        for (auto& core : smtRank)
+            maxRank = std::max(maxRank, core.second);
+
+        std::vector<int> coreList;
+        for (int rank = 0; rank <= maxRank; rank++) {
+            for (auto& node : domains) {
+                for (auto& cache : node) {
+                    for (int core : cache) {
+                        auto coreRank = smtRank.find(core);
+                        if ((coreRank == smtRank.end() ? 0 : coreRank->second)
+                            == rank)
+                            coreList.push_back(core);
+                    }
+                }
+            }
+        }
+        if (coreList.size() == 0)
+            return;
+        for (size_t thread = 0; thread < procVect.size(); thread++)
+            procVect[thread] = coreList[thread % coreList.size()];
+    }
+
+    /**
+     * @brief           Get the affinity vector of a placement specification
+     *
+     * @details         compact and scatter order the logical cores by their
+     *                  labels, the innermost level varying fastest for
+     *                  compact and the outermost for scatter, after moving
+     *                  the permute innermost levels to the front. Thread n
+     *                  gets the n-th logical core, round robin.
+     *
+     *                  close and spread bind to places, as OpenMP does. With
+     *                  T threads and P places, close gives thread n place n
+     *                  and spread place n * P / T; with more threads than
+     *                  places both give every place T / P consecutive
+     *                  threads. The threads of a place use its physical
+     *                  cores before their SMT siblings.
+     * Example
+     * 2 nodes of 2 caches of 2 cores, the SMT sibling of core n is n + 8
+     * 8 threads, compact           = [0, 8, 1, 9, 2, 10, 3, 11]
+     * 8 threads, compact,1         = [0, 1, 2, 3, 4, 5, 6, 7]
+     * 8 threads, scatter           = [0, 4, 2, 6, 1, 5, 3, 7]
+     * 4 threads, close,places=cores  = [0, 1, 2, 3]
+     * 4 threads, spread,places=cores = [0, 2, 4, 6]
+     *
+     * @param[out]      procVect    Vector to store the affinity
+     *
+     * @param[in]       spec        The placement
+     *
+     * @return          void
+     */
+    void getPlacementAffinityVector(std::vector<int>&    procVect,
+                                    const PlacementSpec& spec)
+    {
+        constexpr int         cLevels = PlacementSpec::cLevels;
+        std::vector<CpuLabel> labels;
+        getCpuLabels(labels);
+        if (spec.noSmt) {
+            labels.erase(std::remove_if(labels.begin(),
+                                        labels.end(),
+                                        [](const CpuLabel& label) {
+                                            return label.second[3] != 0;
+                                        }),
+                         labels.end());
+        }
+        size_t threadCount = procVect.size();
+        if (labels.size() == 0 || threadCount == 0)
+            return;
+
+        if (spec.policy == PlacementPolicy::eCompact
+            || spec.policy == PlacementPolicy::eScatter) {
+            bool scatter = spec.policy == PlacementPolicy::eScatter;
+            auto key     = [&spec, scatter](const CpuLabel& label) {
+                std::array<int, cLevels> levels;
+                for (int i = 0; i < cLevels; i++)
+                    levels[i] =
+                        label.second[(i + cLevels - spec.permute) % cLevels];
+                if (scatter)
+                    std::reverse(levels.begin(), levels.end());
+                return levels;
+            };
+            std::stable_sort(labels.begin(),
+                             labels.end(),
+                             [&key](const CpuLabel& a, const CpuLabel& b) {
+                                 return key(a) < key(b);
+                             });
+            for (size_t thread = 0; thread < threadCount; thread++)
+                procVect[thread] = labels[thread % labels.size()].first;
+            return;
+        }
+
+        // Levels identifying a place
+        int depth = cLevels;
+        if (spec.places == PlaceKind::eCores)
+            depth = 3;
+        else if (spec.places == PlaceKind::eCaches)
+            depth = 2;
+        else if (spec.places == PlaceKind::eNumaDomains)
+            depth = 1;
+        std::sort(labels.begin(),
+                  labels.end(),
+                  [](const CpuLabel& a, const CpuLabel& b) {
+                      return a.second < b.second;
+                  });
+        std::vector<std::vector<CpuLabel>> places;
+        for (auto& label : labels) {
+            if (places.size() == 0
+                || !std::equal(label.second.begin(),
+                               label.second.begin() + depth,
+                               places.back()[0].second.begin()))
+                places.emplace_back();
+            places.back().push_back(label);
+        }
+        for (auto& place : places) {
+            std::stable_sort(place.begin(),
+                             place.end(),
+                             [](const CpuLabel& a, const CpuLabel& b) {
+                                 return a.second[3] < b.second[3];
+                             });
+        }
+
+        size_t              placeCount = places.size();
+        std::vector<size_t> used(placeCount, 0);
+        for (size_t thread = 0; thread < threadCount; thread++) {
+            size_t place = thread * placeCount / threadCount;
+            if (spec.policy == PlacementPolicy::eClose
+                && threadCount <= placeCount)
+                place = thread;
+            auto& cores      = places[place];
+            procVect[thread] = cores[used[place]++ % cores.size()].first;
         }
     }
 
@@ -454,7 +838,7 @@ class AffinityVector
      * @details        Get the affinity vector based on the pinning strategy
      *
      * @param[in]      pinStrategyIndex  0 - spread , 1 - Core, 2 - Logical
-     *                 Processor
+     *                 Processor, 3 - NUMA spread, 4 - NUMA compact
      *
      * @param[out]     processPinGroup   Vector to store the affinity vector
      *
@@ -473,32 +857,100 @@ class AffinityVector
             case pinStrategy::LOGICAL:
                 getLogicalAffinityVector(processPinGroup);
                 break;
+            case pinStrategy::NUMA_SPREAD:
+                getNumaSpreadAffinityVector(processPinGroup);
+                break;
+            case pinStrategy::NUMA_COMPACT:
+                getNumaCompactAffinityVector(processPinGroup);
+                break;
             default:
                 break;
         }
     }
 
+    /** @brief         getThreadAffinity
+     *
+     * @details       Read back the processors a thread may run on.
+     *
+     * @param[in]     thread           Thread to query
+     *
+     * @return        Processor numbers in ascending order, empty if the
+     *                affinity cannot be read
+     */
+    std::vector<int> getThreadAffinity(pthread_t thread) const
+    {
+#ifdef __linux__
+        return CpuSet::ofThread(thread).toList();
+#else
+        std::vector<int> processors;
+        GROUP_AFFINITY   groupAffinity;
+        ZeroMemory(&groupAffinity, sizeof(GROUP_AFFINITY));
+        if (!GetThreadGroupAffinity((HANDLE)thread, &groupAffinity)) {
+            return processors;
+        }
+        int offset = calculateOffset(groupAffinity.Group, cpuInfo.groupMap);
+        for (int bit = 0; bit < 64; bit++) {
+            if (groupAffinity.Mask & (1ull << bit)) {
+                processors.push_back(offset + bit);
+            }
+        }
+        return processors;
+#endif
+    }
+
     /** @brief         setAffinity
      *
-     * @details       Pin Threads to a specific processor group.
+     * @details       Pin Threads to a specific processor group, then read the
+     * affinity of every thread back to check that it only runs on the
+     * requested processor.
      *
      * @param[in]     threadList        ThreadIds to pin
      *
      * @param[in]     processorList    List of processors to pin the threads
+     *
+     * @param[out]    report           Requested and actual affinity of every
+     *                                 thread
+     *
+     * @return        The first error of the report, ok if every thread runs
+     *                on the requested processor
      */
-    void setAffinity(std::vector<pthread_t> const& threadList,
-                     std::vector<int> const&       processorList)
+    Status setAffinity(std::vector<pthread_t> const& threadList,
+                       std::vector<int> const&       processorList,
+                       std::vector<ThreadAffinity>&  report)
     {
+        Status status;
+        report.assign(threadList.size(), ThreadAffinity{});
         for (size_t i = 0; i < threadList.size(); i++) {
+            ThreadAffinity& entry = report[i];
+            entry.thread          = threadList[i];
+            entry.requested       = processorList[i];
             // Pin the thread to the processor
-            AUD_ASSERT(processorList[i] < std::thread::hardware_concurrency(),
-                       "Invalid processor Id");
 #ifdef __linux__
-            cpu_set_t cpuset;
-            CPU_ZERO(&cpuset);
-            CPU_SET(processorList[i], &cpuset);
-            pthread_setaffinity_np(threadList[i], sizeof(cpu_set_t), &cpuset);
+            // CPU numbers may exceed the online count when CPUs are offline
+            AUD_ASSERT(processorList[i] >= 0
+                           && static_cast<uint32_t>(processorList[i])
+                                  < cpuInfo.max_processors,
+                       "Invalid processor Id");
+            if (processorList[i] < 0
+                || static_cast<uint32_t>(processorList[i])
+                       >= cpuInfo.max_processors) {
+                entry.status = Status{ InvalidArgumentError(),
+                                       "Invalid processor Id" };
+            } else {
+                CpuSet cpus;
+                cpus.set(processorList[i]);
+                int err = cpus.applyTo(threadList[i]);
+                if (err != 0) {
+                    entry.status = Status{ err == ESRCH
+                                               ? NotFoundError()
+                                               : InvalidArgumentError(),
+                                           "pthread_setaffinity_np: "
+                                               + String(strerror(err)) };
+                }
+            }
 #else
+            AUD_ASSERT(processorList[i] < std::thread::hardware_concurrency(),
+                       "Invalid processor Id");
             GROUP_AFFINITY groupAffinity;
             ZeroMemory(&groupAffinity, sizeof(GROUP_AFFINITY));
             // calculate the group and mask from the processor number and
@@ -520,13 +972,39 @@ class AffinityVector
             auto   result =
                 SetThreadGroupAffinity(hThread, &groupAffinity, nullptr);
             if (!result) {
-                std::cout << "SetThreadGroupAffinity Failed\n";
+                entry.status =
+                    Status{ InvalidArgumentError(),
+                            "SetThreadGroupAffinity failed with error "
+                                + std::to_string(GetLastError()) };
             }
 #endif
-        std::cout << "Thread " << threadList[i] << " is pinned to processor "
-                  << processorList[i] << std::endl;
+            entry.actual = getThreadAffinity(threadList[i]);
+            if (entry.status.ok()
+                && (entry.actual.size() != 1
+                    || entry.actual[0] != processorList[i])) {
+                entry.status = Status{ InternalError(),
+                                       "Affinity read back does not match "
+                                       "the requested processor" };
+            }
 
+            if (!entry.status.ok()) {
+                Logger::getInstance().log(LogLevel::WARNING,
+                                          "Pinning thread",
+                                          threadList[i],
+                                          "to processor",
+                                          processorList[i],
+                                          "failed:",
+                                          entry.status.message());
+            } else {
+                Logger::getInstance().log(LogLevel::DEBUG,
+                                          "Thread",
+                                          threadList[i],
+                                          "is pinned to processor",
+                                          processorList[i]);
+            }
+            status.update(entry.status);
         }
+        return status;
     }
 };
 } // namespace Au
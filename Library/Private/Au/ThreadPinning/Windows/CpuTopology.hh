@@ -133,6 +133,8 @@ class CpuTopology
     std::vector<std::vector<CoreMask>> processorMap;
     std::vector<std::vector<CoreMask>> cacheMap;
     std::vector<CoreMask>              groupMap;
+    std::vector<std::vector<CoreMask>> numaMap;
+    std::vector<int> availableProcessors; // Not restricted yet, empty
 
     static const CpuTopology& get()
     {
@@ -145,11 +147,14 @@ class CpuTopology
         , processorMap{}
         , cacheMap{}
         , groupMap{}
+        , numaMap{}
+        , availableProcessors{}
     {
         active_processors = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
         LogicalProcessorInformation processorInfo(RelationProcessorCore);
         LogicalProcessorInformation cacheInfo(RelationCache);
         LogicalProcessorInformation groupInfo(RelationGroup);
+        LogicalProcessorInformation numaInfo(RelationNumaNode);
 
 #ifdef AU_COMPILER_IS_MSVC
         for (; auto pInfo = processorInfo.Current(); processorInfo.MoveNext()) {
@@ -180,6 +185,12 @@ class CpuTopology
                     gInfo->u.Group.GroupInfo[i].ActiveProcessorMask,
                     gInfo->u.Group.GroupInfo[i].ActiveProcessorCount));
         }
+        for (; auto nInfo = numaInfo.Current(); numaInfo.MoveNext()) {
+            // Collect the NUMA node --> Logical core mapping
+            numaMap.push_back(
+                { std::make_pair(nInfo->u.NumaNode.GroupMask.Mask,
+                                 nInfo->u.NumaNode.GroupMask.Group) });
+        }
 #else
         for (; auto pInfo = processorInfo.Current(); processorInfo.MoveNext()) {
             // Collect the physical core -> logical core mapping
@@ -209,6 +220,12 @@ class CpuTopology
                     gInfo->Group.GroupInfo[i].ActiveProcessorMask,
                     gInfo->Group.GroupInfo[i].ActiveProcessorCount));
         }
+        for (; auto nInfo = numaInfo.Current(); numaInfo.MoveNext()) {
+            // Collect the NUMA node --> Logical core mapping
+            numaMap.push_back(
+                { std::make_pair(nInfo->NumaNode.GroupMask.Mask,
+                                 nInfo->NumaNode.GroupMask.Group) });
+        }
 #endif
     }
 };
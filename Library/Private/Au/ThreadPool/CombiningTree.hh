@@ -0,0 +1,345 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include "Au/ThreadPinning/ThreadPinning.hh"
+#include "Au/ThreadPool/Futex.hh"
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @class CombiningTree
+ * @brief Barrier and reduction whose fan-in follows the cache hierarchy.
+ *
+ * Participants arrive at the node of their physical core, the last arrival
+ * at a node carries on to the node of the last level cache, then to the one
+ * of the NUMA node and finally to the root. Groups larger than cMaxFanIn are
+ * split into balanced subtrees. The participant completing the root releases
+ * the nodes it completed on its way up, top down, and so does every
+ * participant released at a node, so the wake-up fans out along the same
+ * tree and no cache line is shared beyond the group that owns it.
+ *
+ * Each node has its arrival counter on one cache line, the values to combine
+ * on a second and the generation the arrivals wait on on a third. Waiters
+ * spin for cSpins iterations, then block on the generation with a futex.
+ *
+ * Values are combined in position order, so a reduction of floating point
+ * values gives the same result on every round with the same inputs.
+ */
+class CombiningTree
+{
+  public:
+    /// Largest number of arrivals at a node
+    static constexpr Uint32 cMaxFanIn = 8;
+
+    /// Spin iterations before a waiter blocks
+    static constexpr int cSpins = 4096;
+
+  private:
+    static constexpr size_t cCacheLine = 64;
+    static constexpr size_t cLevels    = PlacementSpec::cLevels;
+    static constexpr size_t cMaxDepth  = 64;
+
+    struct alignas(cCacheLine) Node
+    {
+        std::atomic<Uint32> count;    ///< Arrivals this round
+        Uint32              fanIn;    ///< Arrivals completing it
+        int                 parent;   ///< -1 for the root
+        Uint32              position; ///< Slot in the parent
+
+        /// Values by position, cMaxFanIn of them fill a cache line
+        alignas(cCacheLine) std::array<Uint64, cMaxFanIn> slots;
+
+        /// Bumped once the round completed, the arrivals wait on it
+        alignas(cCacheLine) std::atomic<Uint32> generation;
+        std::atomic<Uint32> waiters; ///< Arrivals blocked in futexWait
+
+        Node()
+            : count{ 0 }
+            , fanIn{ 0 }
+            , parent{ -1 }
+            , position{ 0 }
+            , slots{}
+            , generation{ 0 }
+            , waiters{ 0 }
+        {
+        }
+    };
+    static_assert(sizeof(Node) == 3 * cCacheLine,
+                  "Counter, values and generation on a cache line each");
+
+    /// Node while the tree is built
+    struct Shape
+    {
+        Uint32 fanIn;
+        int    parent;
+        Uint32 position;
+    };
+
+    /// Participant or node while the tree is built
+    struct Item
+    {
+        bool                        isNode;
+        size_t                      index;
+        std::array<int, cLevels>    label;
+    };
+
+    std::unique_ptr<Node[]> m_nodes;
+    size_t                  m_nodeCount;
+    size_t                  m_depth;
+    std::vector<int>        m_leaf;     ///< Node of every participant
+    std::vector<Uint32>     m_position; ///< Slot of every participant
+
+    /// Written by the participant completing the root
+    alignas(cCacheLine) Uint64 m_result;
+
+    /**
+     * @brief           Make a node of the items, or return a lone item.
+     */
+    static Item makeNode(std::vector<Item> const& items,
+                         std::vector<Shape>&      shape,
+                         std::vector<int>&        leaf,
+                         std::vector<Uint32>&     position)
+    {
+        if (items.size() == 1)
+            return items[0];
+        size_t index = shape.size();
+        shape.push_back({ static_cast<Uint32>(items.size()), -1, 0 });
+        for (size_t slot = 0; slot < items.size(); slot++) {
+            if (items[slot].isNode) {
+                shape[items[slot].index].parent   = static_cast<int>(index);
+                shape[items[slot].index].position = static_cast<Uint32>(slot);
+            } else {
+                leaf[items[slot].index]     = static_cast<int>(index);
+                position[items[slot].index] = static_cast<Uint32>(slot);
+            }
+        }
+        return { true, index, items[0].label };
+    }
+
+    /**
+     * @brief           Combine a group, in balanced subtrees of at most
+     *                  cMaxFanIn items.
+     */
+    static Item makeGroup(std::vector<Item>    items,
+                          std::vector<Shape>&  shape,
+                          std::vector<int>&    leaf,
+                          std::vector<Uint32>& position)
+    {
+        while (items.size() > cMaxFanIn) {
+            size_t chunks = (items.size() + cMaxFanIn - 1) / cMaxFanIn;
+            size_t size   = (items.size() + chunks - 1) / chunks;
+            std::vector<Item> parents;
+            for (size_t first = 0; first < items.size(); first += size) {
+                size_t last = std::min(first + size, items.size());
+                parents.push_back(makeNode(
+                    std::vector<Item>(items.begin() + first,
+                                      items.begin() + last),
+                    shape,
+                    leaf,
+                    position));
+            }
+            items = std::move(parents);
+        }
+        return makeNode(items, shape, leaf, position);
+    }
+
+    void wait(Node& node, Uint32 generation)
+    {
+        for (int i = 0; i < cSpins; i++) {
+            if (node.generation.load(std::memory_order_acquire) != generation)
+                return;
+            cpuRelax();
+        }
+        // Pairs with release(): either it sees the waiter or the waiter sees
+        // the new generation, futexWait checks it again in the kernel
+        node.waiters.fetch_add(1);
+        while (node.generation.load() == generation)
+            futexWait(node.generation, generation);
+        node.waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static void release(Node& node)
+    {
+        node.generation.fetch_add(1);
+        if (node.waiters.load() != 0)
+            futexWakeAll(node.generation);
+    }
+
+  public:
+    /**
+     * @brief           Build the tree for participants running on the given
+     *                  processors.
+     *
+     * @param[in]       processors  Processor of every participant, -1 if it
+     *                              is unknown. Participants on unknown or
+     *                              unlabelled processors form flat groups.
+     *
+     * @param[in]       topology    Topology labelling the processors
+     */
+    explicit CombiningTree(
+        std::vector<int> const& processors,
+        const CpuTopology&      topology = CpuTopology::get())
+        : m_nodes{}
+        , m_nodeCount{ 0 }
+        , m_depth{ 0 }
+        , m_leaf(processors.size(), -1)
+        , m_position(processors.size(), 0)
+        , m_result{ 0 }
+    {
+        std::vector<AffinityVector::CpuLabel> labels;
+        AffinityVector(topology).getCpuLabels(labels);
+        std::map<int, std::array<int, cLevels>> labelOf(labels.begin(),
+                                                        labels.end());
+
+        std::vector<Item> items;
+        for (size_t p = 0; p < processors.size(); p++) {
+            auto it = labelOf.find(processors[p]);
+            if (it != labelOf.end())
+                items.push_back({ false, p, it->second });
+            else
+                items.push_back({ false, p, { -1, -1, -1 - int(p), 0 } });
+        }
+
+        // SMT siblings, then last level cache, NUMA node and the machine
+        std::vector<Shape> shape;
+        for (size_t prefix = cLevels - 1; items.size() > 1; prefix--) {
+            std::map<std::vector<int>, std::vector<Item>> groups;
+            for (auto& item : items) {
+                groups[{ item.label.begin(), item.label.begin() + prefix }]
+                    .push_back(item);
+            }
+            items.clear();
+            for (auto& group : groups)
+                items.push_back(
+                    makeGroup(group.second, shape, m_leaf, m_position));
+            if (prefix == 0)
+                break;
+        }
+        // A single participant still arrives at a root
+        if (items.size() == 1 && !items[0].isNode) {
+            shape.push_back({ 1, -1, 0 });
+            m_leaf[items[0].index] = static_cast<int>(shape.size() - 1);
+        }
+
+        m_nodeCount = shape.size();
+        m_nodes.reset(new Node[m_nodeCount]);
+        for (size_t i = 0; i < m_nodeCount; i++) {
+            m_nodes[i].fanIn    = shape[i].fanIn;
+            m_nodes[i].parent   = shape[i].parent;
+            m_nodes[i].position = shape[i].position;
+        }
+        for (int leaf : m_leaf) {
+            size_t depth = 1;
+            for (int n = leaf; m_nodes[n].parent >= 0; n = m_nodes[n].parent)
+                depth++;
+            m_depth = std::max(m_depth, depth);
+        }
+    }
+
+    CombiningTree(const CombiningTree&)            = delete;
+    CombiningTree& operator=(const CombiningTree&) = delete;
+
+    /**
+     * @brief           Number of participants.
+     */
+    size_t size() const { return m_leaf.size(); }
+
+    /**
+     * @brief           Nodes on the longest path from a participant to the
+     *                  root.
+     */
+    size_t depth() const { return m_depth; }
+
+    /**
+     * @brief           Number of nodes.
+     */
+    size_t nodeCount() const { return m_nodeCount; }
+
+    /**
+     * @brief           Node a participant arrives at.
+     */
+    int leafOf(size_t participant) const { return m_leaf[participant]; }
+
+    /**
+     * @brief           Parent of a node, -1 for the root.
+     */
+    int parentOf(size_t node) const { return m_nodes[node].parent; }
+
+    /**
+     * @brief           Arrive with a value and wait for the others.
+     *
+     * @details         Every participant must arrive exactly once per round.
+     *
+     * @param[in]       participant  Index of the calling participant
+     *
+     * @param[in]       value        Value of the participant
+     *
+     * @param[in]       combine      Associative function of two values
+     *
+     * @return          The values of all the participants of the round,
+     *                  combined in tree position order: slot order at every
+     *                  node, bottom up. The order is the same on every round
+     *                  but only matches the participant order for a
+     *                  commutative combine.
+     */
+    template<typename Combine>
+    Uint64 arrive(size_t participant, Uint64 value, Combine&& combine)
+    {
+        std::array<int, cMaxDepth> won;
+        size_t                     depth    = 0;
+        int                        index    = m_leaf[participant];
+        Uint32                     position = m_position[participant];
+        while (true) {
+            Node& node           = m_nodes[index];
+            node.slots[position] = value;
+            Uint32 generation = node.generation.load(std::memory_order_acquire);
+            if (node.count.fetch_add(1, std::memory_order_acq_rel) + 1
+                < node.fanIn) {
+                wait(node, generation);
+                break;
+            }
+            // Last arrival, the others wait until the round completes
+            node.count.store(0, std::memory_order_relaxed);
+            value = node.slots[0];
+            for (Uint32 slot = 1; slot < node.fanIn; slot++)
+                value = combine(value, node.slots[slot]);
+            won[depth++] = index;
+            if (node.parent < 0) {
+                m_result = value;
+                break;
+            }
+            position = node.position;
+            index    = node.parent;
+        }
+        while (depth > 0)
+            release(m_nodes[won[--depth]]);
+        return m_result;
+    }
+};
+
+} // namespace Au
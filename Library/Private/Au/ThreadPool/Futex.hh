@@ -0,0 +1,102 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include "Au/Types.hh"
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace Au {
+
+static_assert(sizeof(std::atomic<Uint32>) == sizeof(Uint32)
+                  && std::atomic<Uint32>::is_always_lock_free,
+              "The futex word must be a plain 32 bit integer");
+
+/**
+ * @brief Hint to the core that the thread is spinning, lets the SMT sibling
+ * run.
+ */
+inline void
+cpuRelax()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Blocks while 'word' holds 'expected'.
+ *
+ * May return spuriously, callers check the word again.
+ */
+inline void
+futexWait(std::atomic<Uint32>& word, Uint32 expected)
+{
+#ifdef __linux__
+    syscall(SYS_futex,
+            reinterpret_cast<Uint32*>(&word),
+            FUTEX_WAIT_PRIVATE,
+            expected,
+            nullptr,
+            nullptr,
+            0);
+#else
+    WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+#endif
+}
+
+/**
+ * @brief Wakes every thread blocked in futexWait on 'word'.
+ */
+inline void
+futexWakeAll(std::atomic<Uint32>& word)
+{
+#ifdef __linux__
+    syscall(SYS_futex,
+            reinterpret_cast<Uint32*>(&word),
+            FUTEX_WAKE_PRIVATE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+#else
+    WakeByAddressAll(&word);
+#endif
+}
+
+} // namespace Au
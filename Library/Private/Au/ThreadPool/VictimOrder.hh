@@ -0,0 +1,98 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include "Au/ThreadPinning/ThreadPinning.hh"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @class VictimOrder
+ * @brief Order in which a work stealing worker tries the other workers.
+ *
+ * The other workers of every worker are grouped by their distance in the
+ * topology: SMT siblings first, then workers sharing the last level cache,
+ * then the NUMA node, then the remote ones. Within a level they keep their
+ * index order, starting after the worker itself.
+ */
+class VictimOrder
+{
+  public:
+    /// Steal levels: SMT sibling, same cache, same NUMA node, remote
+    static constexpr size_t cLevels = PlacementSpec::cLevels;
+
+    /// Victims of one worker, by level
+    using Levels = std::array<std::vector<size_t>, cLevels>;
+
+    /**
+     * @brief          build
+     *
+     * @details        Sort the other workers of every worker by their distance
+     * in the topology. Unpinned workers are all remote.
+     *
+     * @param[in]      labels            Topology labels of the processors
+     *
+     * @param[in]      processors        Processor of every worker, -1 if it
+     * is not pinned
+     *
+     * @return         The victims of every worker
+     */
+    static std::vector<Levels> build(
+        std::vector<AffinityVector::CpuLabel> const& labels,
+        std::vector<int> const&                      processors)
+    {
+        std::map<int, std::array<int, cLevels>> labelOf;
+        for (auto& label : labels)
+            labelOf.emplace(label.first, label.second);
+
+        // Index of the first level the two processors differ at, from the
+        // NUMA node down to the physical core, or the SMT level for siblings
+        auto distance = [&labelOf](int a, int b) {
+            auto la = labelOf.find(a);
+            auto lb = labelOf.find(b);
+            if (la == labelOf.end() || lb == labelOf.end())
+                return cLevels - 1;
+            for (size_t level = 0; level < cLevels - 1; level++) {
+                if (la->second[level] != lb->second[level])
+                    return cLevels - 1 - level;
+            }
+            return size_t(0);
+        };
+
+        size_t              count = processors.size();
+        std::vector<Levels> victims(count);
+        for (size_t self = 0; self < count; self++) {
+            // Closer victims first, then by index after self
+            for (size_t i = 1; i < count; i++) {
+                size_t other = (self + i) % count;
+                victims[self][distance(processors[self], processors[other])]
+                    .push_back(other);
+            }
+        }
+        return victims;
+    }
+};
+
+} // namespace Au
@@ -0,0 +1,205 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @class WorkStealingDeque
+ * @brief Chase-Lev deque of pointers: one owner thread pushes and pops at the
+ * bottom, any thread steals from the top.
+ *
+ * The owner works LIFO on the most recently pushed, cache hot tasks while
+ * thieves take the oldest ones, which for recursively split work are the
+ * largest. Only pop and steal of the last element race, on m_top. The ring
+ * doubles when full; rings that thieves may still read are kept until the
+ * deque is destroyed.
+ *
+ * The memory orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+ */
+template<typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_pointer_v<T>, "The deque stores pointers");
+
+  private:
+    static constexpr size_t cCacheLine = 64;
+
+    class Ring
+    {
+      private:
+        const size_t                      m_mask;  ///< capacity - 1
+        std::unique_ptr<std::atomic<T>[]> m_items; ///< Element slots
+
+      public:
+        explicit Ring(size_t capacity)
+            : m_mask{ capacity - 1 }
+            , m_items{ new std::atomic<T>[capacity] }
+        {
+        }
+
+        size_t capacity() const { return m_mask + 1; }
+
+        T get(int64_t index) const
+        {
+            return m_items[index & m_mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item)
+        {
+            m_items[index & m_mask].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(cCacheLine) std::atomic<int64_t> m_top;    ///< Next slot to steal
+    alignas(cCacheLine) std::atomic<int64_t> m_bottom; ///< Next slot to push
+
+    std::atomic<Ring*>                 m_ring;  ///< Ring in use
+    std::vector<std::unique_ptr<Ring>> m_rings; ///< Every ring, owner only
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+    {
+        auto bigger = std::make_unique<Ring>(ring->capacity() * 2);
+        for (int64_t i = top; i < bottom; i++)
+            bigger->put(i, ring->get(i));
+        ring = bigger.get();
+        m_rings.push_back(std::move(bigger));
+        m_ring.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+  public:
+    /**
+     * @brief Creates an empty deque.
+     * @param capacity Initial number of elements, the deque grows past it.
+     */
+    explicit WorkStealingDeque(size_t capacity = 256)
+        : m_top{ 0 }
+        , m_bottom{ 0 }
+        , m_ring{ nullptr }
+        , m_rings{}
+    {
+        m_rings.push_back(std::make_unique<Ring>(roundUp(capacity)));
+        m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&)            = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Adds an element at the bottom, owner only.
+     * @param item Element to add.
+     */
+    void push(T item)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top    = m_top.load(std::memory_order_acquire);
+        Ring*   ring   = m_ring.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(ring->capacity()) - 1)
+            ring = grow(ring, top, bottom);
+        ring->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Removes the most recently pushed element, owner only.
+     * @return The element, nullptr if the deque is empty.
+     */
+    T pop()
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Ring*   ring   = m_ring.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top  = m_top.load(std::memory_order_relaxed);
+        T       item = nullptr;
+        if (top <= bottom) {
+            item = ring->get(bottom);
+            if (top == bottom) {
+                // Last element, a thief may be taking it as well
+                if (!m_top.compare_exchange_strong(top,
+                                                   top + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed))
+                    item = nullptr;
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+        } else {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Removes the oldest element, from any thread.
+     * @return The element, nullptr if the deque is empty or another thread
+     * won the race for it.
+     */
+    T steal()
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+        T item = m_ring.load(std::memory_order_acquire)->get(top);
+        if (!m_top.compare_exchange_strong(top,
+                                           top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+            return nullptr;
+        return item;
+    }
+
+    /**
+     * @brief Number of elements, approximate while other threads steal.
+     */
+    size_t size() const
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        int64_t top    = m_top.load(std::memory_order_acquire);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    /**
+     * @brief Checks for elements, approximate while other threads steal.
+     */
+    bool empty() const { return size() == 0; }
+};
+
+} // namespace Au
@@ -26,15 +26,25 @@
  *
  */
 
+#include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <thread>
 
+#include "Au/Logger.hh"
 #include "Au/Logger/LogManager.hh"
+#include "Au/Logger/Macros.hh"
+#include "Capi/au/logger/logger.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace Au::Logger;
 
 bool verbose = false;
@@ -313,8 +323,198 @@ TEST(LoggerTest, FileLoggerTest)
     std::remove(testFilename.c_str());
 }
 
+TEST(LoggerTest, RotatingFileLoggerTest)
+{
+    const std::string   testFilename = "test_rotating_logger.log";
+    std::vector<String> processed;
+    std::mutex          processedMutex;
+
+    auto hook = [&](const String& segment) {
+        // Stand-in for compression: rename the closed segment
+        String result = segment + ".done";
+        std::rename(segment.c_str(), result.c_str());
+        std::lock_guard<std::mutex> lock(processedMutex);
+        processed.push_back(result);
+        return result;
+    };
+
+    {
+        RotatingFileLogger logger(
+            testFilename, 256, std::chrono::seconds(0), 2, hook);
+        EXPECT_EQ(logger.getLoggerType(), "RotatingFileLogger");
+
+        for (int i = 0; i < 40; i++) {
+            logger.write(Message("Rotating message " + std::to_string(i)));
+        }
+        logger.flush();
+        logger.waitForPostProcessing();
+    }
+
+    // Each message is longer than 32 bytes, so 40 of them need several files
+    ASSERT_GE(processed.size(), 3u);
+
+    // Only the newest segments are kept
+    size_t kept = 0;
+    for (auto& path : processed) {
+        std::ifstream segment(path);
+        if (segment.good()) {
+            kept++;
+        }
+    }
+    EXPECT_EQ(kept, 2u);
+
+    // The active file holds the last message
+    std::ifstream infile(testFilename);
+    ASSERT_TRUE(infile.good());
+    std::string content((std::istreambuf_iterator<char>(infile)),
+                        std::istreambuf_iterator<char>());
+    infile.close();
+    EXPECT_NE(content.find("Rotating message 39"), std::string::npos);
+    EXPECT_LE(content.size(), 256u + 80u);
+
+    // Clean up
+    for (auto& path : processed) {
+        std::remove(path.c_str());
+    }
+    std::remove(testFilename.c_str());
+}
+
+TEST(LoggerTest, RotatingFileLoggerRecoveryTest)
+{
+    namespace fs = std::filesystem;
+    const fs::path dir      = "test_rotating_recovery";
+    const String   filename = (dir / "app.log").string();
+    fs::remove_all(dir);
+
+    // The directory is missing, nothing can be written until it is back
+    {
+        RotatingFileLogger logger(filename, 64, std::chrono::seconds(0), 2);
+        logger.write(Message("Lost message"));
+        fs::create_directory(dir);
+        logger.write(Message("Too early"));
+        EXPECT_FALSE(fs::exists(filename));
+
+        std::this_thread::sleep_for(RotatingFileLogger::cReopenInterval
+                                    + std::chrono::milliseconds(100));
+        logger.write(Message("Recovered message"));
+        logger.flush();
+        EXPECT_TRUE(fs::exists(filename));
+    }
+
+    // Segments of an earlier run, one of them post-processed
+    for (auto name : { "app.log.1.done", "app.log.2", "app.log.3" }) {
+        std::ofstream(dir / name) << "old\n";
+    }
+    std::ofstream(dir / "app.log.notes") << "unrelated\n";
+    {
+        RotatingFileLogger logger(filename, 64, std::chrono::seconds(0), 2);
+        // Retention applies to the earlier segments right away
+        EXPECT_FALSE(fs::exists(dir / "app.log.1.done"));
+        EXPECT_TRUE(fs::exists(dir / "app.log.2"));
+
+        for (int i = 0; i < 4; i++) {
+            logger.write(Message("Rotating message " + std::to_string(i)));
+        }
+        logger.waitForPostProcessing();
+    }
+    // New segments continue the numbering and push out the older ones
+    std::vector<String> kept;
+    for (auto& entry : fs::directory_iterator(dir)) {
+        String name = entry.path().filename().string();
+        if (name != "app.log" && name != "app.log.notes") {
+            kept.push_back(name);
+        }
+    }
+    EXPECT_EQ(kept.size(), 2u);
+    for (auto& name : kept) {
+        EXPECT_GT(std::stoi(name.substr(name.rfind('.') + 1)), 3) << name;
+    }
+    EXPECT_TRUE(fs::exists(dir / "app.log.notes"));
+
+    std::ifstream infile(filename);
+    std::string   content((std::istreambuf_iterator<char>(infile)),
+                        std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("Rotating message 3"), std::string::npos);
+
+    // Clean up
+    fs::remove_all(dir);
+}
+
+#if defined(__linux__)
+TEST(LoggerTest, MmapRingLoggerTest)
+{
+    const std::string testFilename = "test_mmap_ring_logger.ring";
+    std::remove(testFilename.c_str());
+
+    Au::Uint64 before = Timestamp().getNanosecond();
+    {
+        MmapRingLogger logger(testFilename, 1024);
+        EXPECT_EQ(logger.getLoggerType(), "MmapRingLogger");
+        Priority warning(Priority::PriorityLevel::eWarning);
+        for (int i = 0; i < 100; i++) {
+            logger.write(Message("Ring message " + std::to_string(i), warning));
+        }
+    }
+    Au::Uint64 after = Timestamp().getNanosecond();
+
+    // The ring only holds the newest records, oldest first, with the level
+    // and timestamp of each message
+    auto records = MmapRingLogger::readRing(testFilename);
+    ASSERT_FALSE(records.empty());
+    EXPECT_LT(records.size(), 100u);
+    EXPECT_EQ(records.back().text, "Ring message 99");
+    int first = std::stoi(records.front().text.substr(
+        records.front().text.rfind(' ')));
+    for (size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(records[i].text, "Ring message " + std::to_string(first + i));
+        EXPECT_EQ(records[i].level, Priority::PriorityLevel::eWarning);
+        EXPECT_GE(records[i].timestamp, before);
+        EXPECT_LE(records[i].timestamp, after);
+        if (i > 0) {
+            EXPECT_GE(records[i].timestamp, records[i - 1].timestamp);
+        }
+    }
+
+    // Reopening an existing ring appends to it
+    {
+        MmapRingLogger logger(testFilename, 1024);
+        logger.write(Message("Ring message after reopen"));
+    }
+    records = MmapRingLogger::readRing(testFilename);
+    ASSERT_GE(records.size(), 2u);
+    EXPECT_EQ(records.back().text, "Ring message after reopen");
+    EXPECT_EQ(records[records.size() - 2].text, "Ring message 99");
+
+    std::remove(testFilename.c_str());
+}
+
+TEST(LoggerTest, MmapRingLoggerCrashTest)
+{
+    const std::string testFilename = "test_mmap_ring_crash.ring";
+    std::remove(testFilename.c_str());
+
+    // The child writes and dies without unmapping or flushing anything
+    EXPECT_DEATH(
+        {
+            MmapRingLogger logger(testFilename, 4096);
+            logger.write(Message("Last words before the crash"));
+            std::abort();
+        },
+        "");
+
+    auto records = MmapRingLogger::readRing(testFilename);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].text, "Last words before the crash");
+
+    std::remove(testFilename.c_str());
+}
+#endif
+
 TEST(LoggerTest, GenericLoggerTest)
 {
+    EXPECT_NO_THROW(LoggerFactory::validateLoggerType("RotatingFileLogger"));
+    EXPECT_NO_THROW(LoggerFactory::validateLoggerType("MmapRingLogger"));
+
     // We expect validateLoggerType to throw
     EXPECT_THROW(LoggerFactory::validateLoggerType("GenericLogger"),
                  std::invalid_argument);
@@ -382,6 +582,823 @@ TEST(LoggerTest, DummyLoggerTest)
     EXPECT_TRUE(output.empty());
 }
 
+TEST(LoggerTest, MacroLevelFilterTest)
+{
+    std::unique_ptr<MockLogger> mockLogger = std::make_unique<MockLogger>();
+
+    EXPECT_CALL(*mockLogger.get(), write(testing::Truly([](const Message& msg) {
+        return msg.getMsg().find("Filtered") != std::string::npos;
+    }))).Times(0);
+    EXPECT_CALL(*mockLogger.get(), write(testing::Truly([](const Message& msg) {
+        return msg.getMsg().find("Forwarded") != std::string::npos;
+    }))).Times(2);
+    EXPECT_CALL(*mockLogger.get(), flush()).Times(1);
+
+    LogWriter::setLogger(std::move(mockLogger));
+
+    LogWriter::setLevel(Priority::PriorityLevel::eWarning);
+    EXPECT_TRUE(LogWriter::isEnabled(Priority::PriorityLevel::eFatal));
+    EXPECT_TRUE(LogWriter::isEnabled(Priority::PriorityLevel::eWarning));
+    EXPECT_FALSE(LogWriter::isEnabled(Priority::PriorityLevel::eNotice));
+    EXPECT_FALSE(LogWriter::isEnabled(Priority::PriorityLevel::eTrace));
+
+    AU_LOGGER_LOG_INFO("Filtered info message");
+    AU_LOGGER_LOG_DEBUG("Filtered debug message");
+    AU_LOGGER_LOG_WARN("Forwarded warning message");
+    AU_LOGGER_LOG_ERROR("Forwarded error message");
+
+    // Restore the default so other tests see every level
+    LogWriter::setLevelMask(~0U);
+    EXPECT_TRUE(LogWriter::isEnabled(Priority::PriorityLevel::eTrace));
+
+    LogWriter::getLogWriter()->stop();
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+class CollectingLogger : public GenericLogger
+{
+  public:
+    std::vector<Message>& m_out;
+    explicit CollectingLogger(std::vector<Message>& out)
+        : GenericLogger()
+        , m_out(out)
+    {
+        setLoggerName("CollectingLogger");
+    }
+    void        write(const Message& msg) override { m_out.push_back(msg); }
+    void        flush() override {}
+    std::string getLoggerType() const override { return "CollectingLogger"; }
+};
+#pragma GCC diagnostic pop
+
+TEST(LoggerTest, PerThreadRingsTest)
+{
+    constexpr int        threads = 4;
+    constexpr int        count   = 500;
+    std::vector<Message> written;
+
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([t] {
+            LogManager logger(LogWriter::getLogWriter());
+            for (int i = 0; i < count; i++) {
+                logger << ("T" + std::to_string(t) + " " + std::to_string(i));
+                // Flush every few messages so that batches interleave
+                if (i % 16 == 0)
+                    logger.flush();
+            }
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    LogWriter::getLogWriter()->stop();
+
+    // Every message arrives once and in program order for each thread
+    ASSERT_EQ(written.size(), static_cast<size_t>(threads * count));
+    std::vector<int> next(threads, 0);
+    for (size_t i = 0; i < written.size(); i++) {
+        std::string text  = written[i].getMsg();
+        size_t      pos   = text.rfind('T');
+        int         t     = std::stoi(text.substr(pos + 1));
+        int         index = std::stoi(text.substr(text.rfind(' ') + 1));
+        ASSERT_LT(t, threads);
+        EXPECT_EQ(index, next[t]++);
+    }
+}
+
+TEST(LoggerTest, RingOverflowOrderTest)
+{
+    // A sink slow enough for the producers to overflow their rings
+    class SlowLogger : public CollectingLogger
+    {
+      public:
+        using CollectingLogger::CollectingLogger;
+        void write(const Message& msg) override
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            CollectingLogger::write(msg);
+        }
+    };
+
+    constexpr int        threads = 2;
+    constexpr int        count   = 3000;
+    std::vector<Message> written;
+
+    LogWriter::setLogger(std::make_unique<SlowLogger>(written));
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([t] {
+            LogManager logger(LogWriter::getLogWriter());
+            for (int i = 0; i < count; i++) {
+                logger << ("T" + std::to_string(t) + " " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    LogWriter::getLogWriter()->stop();
+
+    // Records spilled to the shared queue are not written before the older
+    // ones left in the ring
+    ASSERT_EQ(written.size(), static_cast<size_t>(threads * count));
+    std::vector<int> next(threads, 0);
+    for (size_t i = 0; i < written.size(); i++) {
+        std::string text  = written[i].getMsg();
+        size_t      pos   = text.rfind('T');
+        int         t     = std::stoi(text.substr(pos + 1));
+        int         index = std::stoi(text.substr(text.rfind(' ') + 1));
+        ASSERT_LT(t, threads);
+        ASSERT_EQ(index, next[t]++);
+    }
+}
+
+TEST(LoggerTest, CurrentWriterTest)
+{
+    // The cached writer is the singleton while it runs
+    auto writer = LogWriter::getLogWriter();
+    EXPECT_EQ(&LogWriter::current(), writer.get());
+    EXPECT_EQ(&LogWriter::current(), writer.get());
+
+    // A closed writer is replaced by the next singleton
+    writer->stop();
+    LogWriter& next = LogWriter::current();
+    EXPECT_NE(&next, writer.get());
+    EXPECT_EQ(&next, LogWriter::getLogWriter().get());
+    EXPECT_EQ(next.getState(), LogWriter::State::eRunning);
+    next.stop();
+}
+
+TEST(LoggerTest, SetLoggerWhileRunningTest)
+{
+    // Records a logger destroyed while the logging thread is writing to it
+    class GuardedLogger : public CollectingLogger
+    {
+      public:
+        std::atomic<bool>  m_writing{ false };
+        std::atomic<bool>& m_torn;
+        GuardedLogger(std::vector<Message>& out, std::atomic<bool>& torn)
+            : CollectingLogger(out)
+            , m_torn(torn)
+        {
+        }
+        ~GuardedLogger() override
+        {
+            if (m_writing.load()) {
+                m_torn = true;
+            }
+        }
+        void write(const Message& msg) override
+        {
+            m_writing = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(5));
+            CollectingLogger::write(msg);
+            m_writing = false;
+        }
+    };
+
+    constexpr int        count = 2000;
+    std::vector<Message> written;
+    std::atomic<bool>    torn{ false };
+
+    LogWriter::setLogger(std::make_unique<GuardedLogger>(written, torn));
+    std::thread producer([] {
+        LogManager logger(LogWriter::getLogWriter());
+        for (int i = 0; i < count; i++) {
+            logger << ("Swap " + std::to_string(i));
+        }
+    });
+    for (int i = 0; i < 50; i++) {
+        LogWriter::setLogger(std::make_unique<GuardedLogger>(written, torn));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    producer.join();
+    LogWriter::getLogWriter()->stop();
+
+    // Every message is written once, by the logger installed at the time
+    EXPECT_FALSE(torn.load());
+    EXPECT_EQ(written.size(), static_cast<size_t>(count));
+}
+
+TEST(LoggerTest, OverflowPolicyTest)
+{
+    // A sink slow enough for one thread to fill its ring and the queue
+    class SlowLogger : public CollectingLogger
+    {
+      public:
+        using CollectingLogger::CollectingLogger;
+        void write(const Message& msg) override
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            CollectingLogger::write(msg);
+        }
+    };
+
+    constexpr int        count = 4000;
+    std::vector<Message> written;
+    Au::Uint64           droppedBefore = LogWriter::getDroppedCount();
+
+    LogWriter::setOverflowPolicy(OverflowPolicy::eDropNewest, 16);
+    LogWriter::setLogger(std::make_unique<SlowLogger>(written));
+    {
+        LogManager logger(LogWriter::getLogWriter());
+        for (int i = 0; i < count; i++) {
+            logger << ("Overflow " + std::to_string(i));
+        }
+    }
+    LogWriter::getLogWriter()->stop();
+    LogWriter::setOverflowPolicy(OverflowPolicy::eBlock, 0);
+
+    // Every message is either written or counted as dropped
+    Au::Uint64 dropped = LogWriter::getDroppedCount() - droppedBefore;
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(written.size() + dropped, static_cast<size_t>(count));
+}
+
+TEST(LoggerTest, CompositeLoggerTest)
+{
+    using Level = Priority::PriorityLevel;
+
+    std::vector<Message> warnings, everything, errors;
+    auto                 composite = std::make_unique<CompositeLogger>();
+    composite->addLogger(std::make_unique<CollectingLogger>(warnings),
+                         Priority::maskUpTo(Level::eWarning));
+    composite->addLogger(std::make_unique<CollectingLogger>(everything));
+    composite->addLogger(std::make_unique<CollectingLogger>(errors),
+                         Priority::maskUpTo(Level::eError),
+                         false);
+    EXPECT_EQ(composite->getLoggerCount(), 3u);
+    EXPECT_EQ(composite->getLoggerType(), "CompositeLogger");
+    EXPECT_THROW(composite->addLogger(nullptr), std::invalid_argument);
+
+    for (auto level : { Level::eFatal,
+                        Level::eError,
+                        Level::eWarning,
+                        Level::eInfo,
+                        Level::eDebug }) {
+        Priority priority(level);
+        composite->write(Message(priority.toStr(), priority));
+    }
+    composite->flush();
+
+    EXPECT_EQ(warnings.size(), 3u);
+    EXPECT_EQ(everything.size(), 5u);
+    ASSERT_EQ(errors.size(), 2u);
+    EXPECT_EQ(errors[1].getText(), "Error");
+    EXPECT_EQ(everything[4].getText(), "Debug");
+}
+
+TEST(LoggerTest, CompositeLoggerSlowSinkTest)
+{
+    // Blocks every write until released
+    class StalledLogger : public CollectingLogger
+    {
+      public:
+        std::mutex& m_gate;
+        StalledLogger(std::vector<Message>& out, std::mutex& gate)
+            : CollectingLogger(out)
+            , m_gate(gate)
+        {
+        }
+        void write(const Message& msg) override
+        {
+            std::lock_guard<std::mutex> lock(m_gate);
+            CollectingLogger::write(msg);
+        }
+    };
+
+    std::mutex           gate;
+    std::vector<Message> fast, slow;
+    CompositeLogger      composite;
+    composite.addLogger(std::make_unique<CollectingLogger>(fast), ~0U, false);
+    composite.addLogger(std::make_unique<StalledLogger>(slow, gate),
+                        ~0U,
+                        true,
+                        4,
+                        OverflowPolicy::eDropNewest);
+
+    gate.lock();
+    for (int i = 0; i < 100; i++) {
+        composite.write(Message("Message " + std::to_string(i)));
+    }
+
+    // The stalled sink neither held up the caller nor the fast sink
+    EXPECT_EQ(fast.size(), 100u);
+    EXPECT_GT(composite.getDroppedCount(1), 0u);
+    EXPECT_EQ(composite.getDroppedCount(0), 0u);
+
+    gate.unlock();
+    composite.flush();
+    EXPECT_EQ(slow.size() + composite.getDroppedCount(1), 100u);
+}
+
+TEST(LoggerTest, SampledAndRateLimitedMacrosTest)
+{
+    std::vector<Message> written;
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+
+    for (int i = 0; i < 1000; i++) {
+        AU_LOGGER_LOG_EVERY_N("Sampled warning", eWarning, 100);
+    }
+    for (int i = 0; i < 50; i++) {
+        AU_LOGGER_LOG_RATE_LIMITED("Rate limited error", eError, 5);
+    }
+    // Stopping drains the queue and summarises what was suppressed
+    LogWriter::getLogWriter()->stop();
+
+    size_t sampled = 0, limited = 0;
+    bool   sampledSummary = false, limitedSummary = false;
+    for (auto& msg : written) {
+        std::string_view text = msg.getText();
+        sampled += text == "Sampled warning";
+        limited += text == "Rate limited error";
+        if (text.find("suppressed 990 messages") != std::string_view::npos) {
+            sampledSummary = true;
+            EXPECT_TRUE(msg.getPriority()
+                        == Priority(Priority::PriorityLevel::eWarning));
+        }
+        if (text.find("suppressed 45 messages") != std::string_view::npos) {
+            limitedSummary = true;
+        }
+    }
+    EXPECT_EQ(sampled, 10u);
+    // Allow for the loop straddling a one second window
+    EXPECT_GE(limited, 5u);
+    EXPECT_LE(limited, 10u);
+    EXPECT_TRUE(sampledSummary);
+    EXPECT_TRUE(limitedSummary || limited != 5u);
+}
+
+TEST(LoggerTest, JsonLoggerTest)
+{
+    const std::string testFilename = "test_json_logger.log";
+    std::remove(testFilename.c_str());
+    {
+        auto jsonLogger =
+            LoggerFactory::createLogger("JsonLogger", testFilename);
+        EXPECT_EQ(jsonLogger->getLoggerType(), "JsonLogger");
+
+        Priority warn(Priority::PriorityLevel::eWarning);
+        Message  msg(std::string_view("say \"hi\"\n"), warn);
+        msg.addField("rows", 42).addField("ok", false).addField("name", "a\tb");
+        msg.addField("nan", std::nan(""));
+        jsonLogger->write(msg);
+        jsonLogger->flush();
+    }
+
+    std::ifstream infile(testFilename);
+    ASSERT_TRUE(infile.good()) << "Log file not created";
+    std::string line;
+    std::getline(infile, line);
+    infile.close();
+
+    EXPECT_EQ(line.rfind("{\"ts\":", 0), 0u);
+    EXPECT_NE(line.find(",\"level\":\"Warning\",\"msg\":\"say \\\"hi\\\"\\n\","
+                        "\"rows\":42,\"ok\":false,\"name\":\"a\\tb\","
+                        "\"nan\":null}"),
+              std::string::npos)
+        << line;
+
+    // Clean up
+    std::remove(testFilename.c_str());
+}
+
+TEST(LoggerTest, JsonEscapeTest)
+{
+    // Special characters at every offset of a block, on both sides of the
+    // vectorized and scalar paths
+    for (size_t len = 0; len < 48; len++) {
+        for (size_t pos = 0; pos < len; pos++) {
+            for (char special : { '"', '\\', '\n', '\x01', '\x1f' }) {
+                std::string text(len, 'a');
+                text[pos] = special;
+
+                std::string expected(pos, 'a');
+                switch (special) {
+                    case '"':
+                        expected += "\\\"";
+                        break;
+                    case '\\':
+                        expected += "\\\\";
+                        break;
+                    case '\n':
+                        expected += "\\n";
+                        break;
+                    case '\x01':
+                        expected += "\\u0001";
+                        break;
+                    default:
+                        expected += "\\u001f";
+                        break;
+                }
+                expected.append(len - pos - 1, 'a');
+
+                std::string out;
+                JsonLogger::appendEscaped(out, text);
+                ASSERT_EQ(out, expected) << "len " << len << " pos " << pos;
+            }
+        }
+    }
+
+    // Bytes above 0x7f (UTF-8) pass through unchanged
+    std::string utf8 = "gr\xc3\xbc\xc3\x9f"
+                       "e aus K\xc3\xb6ln, 0123456789";
+    std::string out;
+    JsonLogger::appendEscaped(out, utf8);
+    EXPECT_EQ(out, utf8);
+}
+
+#if defined(__linux__)
+// Records the affinity and scheduling policy of the thread calling write()
+class PlacementProbeLogger : public GenericLogger
+{
+  public:
+    std::atomic<int>& m_policy;
+    cpu_set_t&        m_cpus;
+
+    PlacementProbeLogger(std::atomic<int>& policy, cpu_set_t& cpus)
+        : m_policy{ policy }
+        , m_cpus{ cpus }
+    {
+    }
+
+    void write(const Message& msg) override
+    {
+        pthread_getaffinity_np(pthread_self(), sizeof(m_cpus), &m_cpus);
+        m_policy = sched_getscheduler(0);
+    }
+
+    void flush() override {}
+};
+
+TEST(LoggerTest, PlacementTest)
+{
+    // Pick a CPU this process may run on
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed)) {
+        cpu++;
+    }
+
+    ThreadPlacement placement;
+    placement.m_affinity   = ThreadPlacement::Affinity::eCpus;
+    placement.m_cpus       = { cpu };
+    placement.m_scheduling = ThreadPlacement::Scheduling::eIdle;
+    LogWriter::setPlacement(placement);
+    EXPECT_EQ(LogWriter::getPlacement().m_cpus, std::vector<int>{ cpu });
+
+    std::atomic<int> policy{ -1 };
+    cpu_set_t        cpus;
+    CPU_ZERO(&cpus);
+    LogWriter::setLogger(std::make_unique<PlacementProbeLogger>(policy, cpus));
+    LogWriter::getLogWriter()->log(Message("placed"));
+    LogWriter::getLogWriter()->stop();
+
+    EXPECT_EQ(policy, SCHED_IDLE);
+    EXPECT_EQ(CPU_COUNT(&cpus), 1);
+    EXPECT_TRUE(CPU_ISSET(cpu, &cpus));
+
+    // The logging thread of the next instance is placed by default again
+    LogWriter::setPlacement(ThreadPlacement());
+    LogWriter::setLogger(std::make_unique<PlacementProbeLogger>(policy, cpus));
+    LogWriter::getLogWriter()->log(Message("unplaced"));
+    LogWriter::getLogWriter()->stop();
+    EXPECT_NE(policy, SCHED_IDLE);
+}
+
+TEST(LoggerTest, RunningPlacementTest)
+{
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int last = CPU_SETSIZE - 1;
+    while (!CPU_ISSET(last, &allowed)) {
+        last--;
+    }
+
+    std::atomic<int> policy{ -1 };
+    cpu_set_t        cpus;
+    CPU_ZERO(&cpus);
+    LogWriter::setPlacement(ThreadPlacement());
+    LogWriter::setLogger(std::make_unique<PlacementProbeLogger>(policy, cpus));
+
+    // Logs one message and waits for the running thread to write it
+    auto probe = [&policy](const char* text) {
+        policy = -1;
+        LogWriter::getLogWriter()->log(Message(text));
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (policy == -1 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return policy.load();
+    };
+    ASSERT_NE(probe("started"), -1);
+    int       startPolicy = policy;
+    cpu_set_t startCpus   = cpus;
+
+    // Placed on the last core of the package of the last allowed CPU
+    ThreadPlacement placement;
+    placement.m_affinity   = ThreadPlacement::Affinity::eLastCore;
+    placement.m_cpus       = { last };
+    placement.m_scheduling = ThreadPlacement::Scheduling::eIdle;
+    LogWriter::setPlacement(placement);
+    EXPECT_EQ(probe("placed"), SCHED_IDLE);
+    EXPECT_TRUE(CPU_ISSET(last, &cpus));
+    EXPECT_LE(CPU_COUNT(&cpus), 8);
+
+    // The default placement undoes it without restarting the thread
+    LogWriter::setPlacement(ThreadPlacement());
+    EXPECT_EQ(probe("unplaced"), startPolicy);
+    EXPECT_TRUE(CPU_EQUAL(&cpus, &startCpus));
+    LogWriter::getLogWriter()->stop();
+}
+#endif
+
+TEST(LoggerTest, FormattedLogTest)
+{
+    std::vector<Message> written;
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+    LogWriter::setLevel(Priority::PriorityLevel::eInfo);
+
+    logger_ctx_t* ctx = au_logger_create();
+    au_logger_logf(ctx, AUD_LOG_LEVEL_WARN, "%s %d", "capi", 1);
+    // Filtered out before formatting
+    au_logger_logf(ctx, AUD_LOG_LEVEL_DEBUG, "%s %d", "capi", 2);
+    LogWriter::getLogWriter()->logf(
+        Priority::PriorityLevel::eError, "cpp %05.1f", 2.5);
+    au_logger_destroy(ctx);
+
+    LogWriter::setLevelMask(~0U);
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].getText(), "capi 1");
+    EXPECT_EQ(written[0].getPriority().getLevel(),
+              Priority::PriorityLevel::eWarning);
+    EXPECT_EQ(written[1].getText(), "cpp 002.5");
+}
+
+TEST(LoggerTest, StopLifecycleTest)
+{
+    std::vector<Message> written;
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+
+    auto held = LogWriter::getLogWriter();
+    EXPECT_EQ(held->getState(), LogWriter::State::eRunning);
+    held->log(Message("before stop"));
+    held->stop();
+    EXPECT_EQ(held->getState(), LogWriter::State::eClosed);
+
+    // Stopping again is harmless and the singleton is not released twice
+    held->stop();
+    held->start();
+    EXPECT_EQ(held->getState(), LogWriter::State::eClosed);
+
+    // A closed writer still delivers, synchronously
+    held->log(Message("after stop"));
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].getText(), "before stop");
+    EXPECT_EQ(written[1].getText(), "after stop");
+
+    auto next = LogWriter::getLogWriter();
+    EXPECT_NE(next.get(), held.get());
+    EXPECT_EQ(next->getState(), LogWriter::State::eRunning);
+    next->stop();
+}
+
+#if defined(__linux__)
+TEST(LoggerTest, ForkTest)
+{
+    const std::string testFilename = "test_fork_logger.log";
+    std::remove(testFilename.c_str());
+    LogWriter::setLogger(
+        LoggerFactory::createLogger("FileLogger", testFilename));
+
+    LogManager logManager(LogWriter::getLogWriter());
+    logManager << "Parent before fork";
+    logManager.flush();
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        // Don't hang the test if the child deadlocks
+        alarm(10);
+        LogManager childLog(LogWriter::getLogWriter());
+        childLog << "Child after fork";
+        childLog.flush();
+        LogWriter::getLogWriter()->stop();
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    logManager << "Parent after fork";
+    logManager.flush();
+    LogWriter::getLogWriter()->stop();
+
+    std::ifstream infile(testFilename);
+    std::string   content((std::istreambuf_iterator<char>(infile)),
+                        std::istreambuf_iterator<char>());
+    infile.close();
+
+    // Every message once: the child neither lost its own nor repeated the
+    // parent's
+    auto count = [&content](const std::string& text) {
+        size_t n = 0;
+        for (size_t pos = content.find(text); pos != std::string::npos;
+             pos        = content.find(text, pos + 1)) {
+            n++;
+        }
+        return n;
+    };
+    EXPECT_EQ(count("Parent before fork"), 1u);
+    EXPECT_EQ(count("Child after fork"), 1u);
+    EXPECT_EQ(count("Parent after fork"), 1u);
+
+    std::remove(testFilename.c_str());
+}
+
+TEST(LoggerTest, ForkThreadedLoggersTest)
+{
+    const std::string asyncFilename    = "test_fork_async_sink.log";
+    const std::string rotatingFilename = "test_fork_rotating.log";
+    std::remove(asyncFilename.c_str());
+    std::remove(rotatingFilename.c_str());
+
+    // Both loggers run threads of their own
+    auto composite = std::make_unique<CompositeLogger>();
+    composite->addLogger(
+        LoggerFactory::createLogger("FileLogger", asyncFilename));
+    composite->addLogger(std::make_unique<RotatingFileLogger>(rotatingFilename),
+                         ~0U,
+                         false);
+    LogWriter::setLogger(std::move(composite));
+
+    LogManager logManager(LogWriter::getLogWriter());
+    logManager << "Parent before fork";
+    logManager.flush();
+
+    std::fflush(nullptr);
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        // A hang in the exit drain or in a destructor fails the test
+        alarm(10);
+        LogManager childLog(LogWriter::getLogWriter());
+        childLog << "Child after fork";
+        childLog.flush();
+        std::exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    logManager << "Parent after fork";
+    logManager.flush();
+    LogWriter::getLogWriter()->stop();
+
+    // The child's message went through the restarted threads
+    const char* texts[] = { "Parent before fork",
+                            "Child after fork",
+                            "Parent after fork" };
+    for (const auto& filename : { asyncFilename, rotatingFilename }) {
+        std::ifstream infile(filename);
+        std::string   content((std::istreambuf_iterator<char>(infile)),
+                            std::istreambuf_iterator<char>());
+        for (auto text : texts) {
+            size_t first = content.find(text);
+            EXPECT_NE(first, std::string::npos) << filename << ": " << text;
+            EXPECT_EQ(content.find(text, first + 1), std::string::npos)
+                << filename << ": " << text;
+        }
+        std::remove(filename.c_str());
+    }
+}
+
+TEST(LoggerTest, ForkMmapRingLoggerTest)
+{
+    const std::string filename = "test_fork_ring.bin";
+    std::remove(filename.c_str());
+
+    auto ring = std::make_unique<MmapRingLogger>(filename, 1 << 16);
+    auto raw  = ring.get();
+    LogWriter::setLogger(std::move(ring));
+
+    LogManager logManager(LogWriter::getLogWriter());
+    logManager << "Parent before fork";
+    logManager.flush();
+
+    std::fflush(nullptr);
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        alarm(10);
+        LogManager childLog(LogWriter::getLogWriter());
+        for (int i = 0; i < 200; i++) {
+            childLog << ("Child " + std::to_string(i));
+        }
+        childLog.flush();
+        std::string own = filename + "." + std::to_string(getpid());
+        std::exit(raw->getFilename() == own ? 0 : 1);
+    }
+
+    // Both processes write at the same time
+    for (int i = 0; i < 200; i++) {
+        logManager << ("Parent " + std::to_string(i));
+    }
+    logManager.flush();
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(raw->getFilename(), filename);
+    LogWriter::getLogWriter()->stop();
+
+    // Each process has a ring of its own, in order and not torn
+    const std::string childFilename = filename + "." + std::to_string(pid);
+    auto              parent        = MmapRingLogger::readRing(filename);
+    auto              child         = MmapRingLogger::readRing(childFilename);
+    ASSERT_EQ(parent.size(), 201u);
+    EXPECT_EQ(parent[0].text, "Parent before fork");
+    ASSERT_EQ(child.size(), 200u);
+    for (int i = 0; i < 200; i++) {
+        EXPECT_EQ(parent[i + 1].text, "Parent " + std::to_string(i));
+        EXPECT_EQ(child[i].text, "Child " + std::to_string(i));
+    }
+    std::remove(filename.c_str());
+    std::remove(childFilename.c_str());
+}
+#endif
+
+TEST(LoggerTest, LegacyLoggerTest)
+{
+    std::vector<Message> written;
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+
+    auto& legacy = Au::Logger::getInstance();
+    legacy.setLevel(Au::LogLevel::INFO);
+    EXPECT_FALSE(legacy.isEnabled(Au::LogLevel::DEBUG));
+    EXPECT_TRUE(legacy.isEnabled(Au::LogLevel::WARNING));
+
+    legacy.log(Au::LogLevel::DEBUG, "Filtered out");
+    legacy.log(Au::LogLevel::WARNING, "Leaf", std::hex, 255, "subleaf", 1);
+    legacy.log(Au::LogLevel::CRITICAL, "Critical");
+    LogWriter::getLogWriter()->stop();
+
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_NE(written[0].getText().find("Leaf"), std::string::npos);
+    EXPECT_NE(written[0].getText().find("ff subleaf 1"), std::string::npos);
+    EXPECT_EQ(written[0].getPriority().getLevel(),
+              Priority::PriorityLevel::eWarning);
+    EXPECT_EQ(written[1].getPriority().getLevel(),
+              Priority::PriorityLevel::ePanic);
+}
+
+TEST(LoggerTest, LegacyLoggerFileTest)
+{
+    const std::string    testFilename = "cpuidlog.txt";
+    std::vector<Message> written;
+    std::remove(testFilename.c_str());
+    LogWriter::setLogger(std::make_unique<CollectingLogger>(written));
+
+    // The file is added next to the application's logger
+    auto& legacy = Au::Logger::getInstance();
+    legacy.setLevel(Au::LogLevel::INFO, true);
+    legacy.setLevel(Au::LogLevel::INFO, true);
+    legacy.log(Au::LogLevel::WARNING, "To both");
+    // Application messages do not go to the file
+    AU_LOGGER_LOG("Not legacy", eWarning);
+
+    // and removed again, leaving that logger in place
+    legacy.setLevel(Au::LogLevel::INFO, false);
+    legacy.log(Au::LogLevel::WARNING, "Application only");
+    LogWriter::getLogWriter()->stop();
+    legacy.setLevel(Au::LogLevel::CRITICAL);
+
+    ASSERT_EQ(written.size(), 3u);
+    EXPECT_EQ(written[0].getText(), "To both");
+    EXPECT_EQ(written[1].getText(), "Not legacy");
+    EXPECT_EQ(written[2].getText(), "Application only");
+
+    std::ifstream infile(testFilename);
+    std::string   content((std::istreambuf_iterator<char>(infile)),
+                        std::istreambuf_iterator<char>());
+    infile.close();
+    size_t first = content.find("To both");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_EQ(content.find("To both", first + 1), std::string::npos);
+    EXPECT_EQ(content.find("Application only"), std::string::npos);
+    EXPECT_EQ(content.find("Not legacy"), std::string::npos);
+
+    std::remove(testFilename.c_str());
+}
+
 // Gtest main with an argument parser
 int
 main(int argc, char** argv)
@@ -76,6 +76,25 @@ TEST(MessageTest, PriorityCoverage)
     EXPECT_TRUE(p1 != p2);
 }
 
+TEST(MessageTest, PriorityNamesAndLabels)
+{
+    static_assert(Priority::indexOf(Priority::PriorityLevel::eFatal) == 0);
+    static_assert(Priority::indexOf(Priority::PriorityLevel::eTrace) == 7);
+
+    for (size_t i = 0; i < Priority::cNames.size(); i++) {
+        Priority p(static_cast<Priority::PriorityLevel>(1U << i));
+        EXPECT_EQ(p.getName(), Priority::cNames[i]);
+        EXPECT_EQ(p.toStr(), Priority::cNames[i]);
+        // Labels are the names padded to a common width
+        EXPECT_EQ(p.getLabel().size(), Priority::cLabelWidth);
+        EXPECT_EQ(p.getLabel().substr(0, p.getName().size()), p.getName());
+    }
+    EXPECT_EQ(Priority(Priority::PriorityLevel::eNotice).getLabel(), "Notice ");
+
+    Priority invalid(static_cast<Priority::PriorityLevel>(0));
+    EXPECT_EQ(invalid.getName(), "Unknown");
+}
+
 TEST(MessageTest, PriorityLevelsComparison)
 {
     // Create priorities for all levels
@@ -141,3 +160,138 @@ TEST(MessageTest, MessageCoverage)
     EXPECT_TRUE(msg2.getMsg().find("Priority message") != std::string::npos);
     EXPECT_EQ(msg2.getPriority().toStr(), "Warning");
 }
+
+TEST(MessageTest, InlineAndHeapText)
+{
+    std::string shortText(Message::cInlineCapacity, 's');
+    std::string longText(Message::cInlineCapacity + 1, 'l');
+
+    Message inlineMsg(shortText);
+    Message heapMsg(longText);
+    EXPECT_EQ(inlineMsg.getText(), shortText);
+    EXPECT_EQ(heapMsg.getText(), longText);
+
+    // Copies are deep, moves keep the text
+    Message copy(heapMsg);
+    EXPECT_EQ(copy.getText(), longText);
+    EXPECT_NE(copy.getText().data(), heapMsg.getText().data());
+
+    Message moved(std::move(copy));
+    EXPECT_EQ(moved.getText(), longText);
+
+    copy = inlineMsg;
+    EXPECT_EQ(copy.getText(), shortText);
+    copy = heapMsg;
+    EXPECT_EQ(copy.getText(), longText);
+    copy = Message("short again");
+    EXPECT_EQ(copy.getText(), "short again");
+    EXPECT_NE(copy.getMsg().find("short again"), std::string::npos);
+}
+
+TEST(MessageTest, MovedFromIsEmpty)
+{
+    std::string longText(Message::cInlineCapacity + 1, 'l');
+
+    // The source keeps no length that would point past its inline buffer
+    for (const std::string& text : { std::string("short"), longText }) {
+        Message source(text);
+        source.addField("rows", 42);
+        Message moved(std::move(source));
+        EXPECT_EQ(moved.getText(), text);
+        EXPECT_TRUE(moved.hasFields());
+        EXPECT_TRUE(source.getText().empty());
+        EXPECT_FALSE(source.hasFields());
+
+        Message assigned("other");
+        assigned = std::move(moved);
+        EXPECT_EQ(assigned.getText(), text);
+        EXPECT_TRUE(moved.getText().empty());
+        EXPECT_FALSE(moved.hasFields());
+
+        // A moved-from message can be reused
+        moved = Message("reused");
+        EXPECT_EQ(moved.getText(), "reused");
+    }
+}
+
+TEST(MessageTest, Fields)
+{
+    Message msg("request done");
+    EXPECT_FALSE(msg.hasFields());
+
+    std::string path = "/tmp/a \"b\"";
+    msg.addField("rows", 42)
+        .addField("bytes", 7ULL)
+        .addField("ratio", 0.5)
+        .addField("cached", true)
+        .addField("path", path);
+    EXPECT_TRUE(msg.hasFields());
+    EXPECT_EQ(msg.getText(), "request done");
+
+    std::vector<MessageField> fields;
+    msg.forEachField(
+        [&fields](const MessageField& field) { fields.push_back(field); });
+    ASSERT_EQ(fields.size(), 5u);
+    EXPECT_EQ(fields[0].m_key, "rows");
+    EXPECT_EQ(fields[0].m_type, MessageField::Type::eInt);
+    EXPECT_EQ(fields[0].m_int, 42);
+    EXPECT_EQ(fields[1].m_type, MessageField::Type::eUint);
+    EXPECT_EQ(fields[1].m_uint, 7u);
+    EXPECT_EQ(fields[2].m_type, MessageField::Type::eDouble);
+    EXPECT_EQ(fields[2].m_double, 0.5);
+    EXPECT_EQ(fields[3].m_type, MessageField::Type::eBool);
+    EXPECT_TRUE(fields[3].m_bool);
+    EXPECT_EQ(fields[4].m_type, MessageField::Type::eString);
+    EXPECT_EQ(fields[4].m_string, path);
+
+    // Fields spill to the heap together with the text and survive copies
+    std::string big(Message::cInlineCapacity, 'x');
+    msg.addField("big", big).addField("after", -1);
+
+    Message copy(msg);
+    EXPECT_EQ(copy.getText(), "request done");
+    Message moved(std::move(copy));
+    Message assigned("other");
+    assigned = moved;
+
+    for (const Message* m : { &msg, &moved, &assigned }) {
+        size_t       offset = 0, count = 0;
+        MessageField field;
+        while (m->nextField(offset, field)) {
+            count++;
+        }
+        EXPECT_EQ(count, 7u);
+        EXPECT_EQ(field.m_key, "after");
+        EXPECT_EQ(field.m_int, -1);
+    }
+}
+
+namespace {
+Message
+formatted(const char* fmt, ...)
+{
+    Message msg("old text");
+    msg.addField("dropped", 1);
+
+    va_list args;
+    va_start(args, fmt);
+    msg.vformat(fmt, args);
+    va_end(args);
+    return msg;
+}
+} // namespace
+
+TEST(MessageTest, Vformat)
+{
+    Message msg = formatted("%s=%d", "answer", 42);
+    EXPECT_EQ(msg.getText(), "answer=42");
+    EXPECT_FALSE(msg.hasFields());
+
+    // Output longer than the inline buffer is formatted again into the heap
+    std::string big(Message::cInlineCapacity * 3, 'b');
+    msg = formatted("[%s]", big.c_str());
+    EXPECT_EQ(msg.getText(), "[" + big + "]");
+
+    msg = formatted("%s", "");
+    EXPECT_EQ(msg.getText(), "");
+}
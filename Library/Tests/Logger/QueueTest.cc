@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/Logger/Queue.hh"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace Au::Logger;
+
+TEST(QueueTest, SpscRingCapacity)
+{
+    SpscRing<int> ring(5);
+    // Capacity is rounded up to a power of two
+    EXPECT_EQ(ring.capacity(), 8u);
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(8));
+    EXPECT_EQ(ring.size(), 8u);
+
+    int value = -1;
+    EXPECT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.tryPush(8));
+}
+
+TEST(QueueTest, SpscRingWrapAround)
+{
+    SpscRing<std::string> ring(4);
+    std::string           out;
+
+    // Push and pop well past the capacity to exercise index wrap around
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(ring.tryPush(std::to_string(i)));
+        EXPECT_TRUE(ring.tryPush(std::to_string(i + 1000)));
+        EXPECT_TRUE(ring.tryPop(out));
+        EXPECT_EQ(out, std::to_string(i));
+        EXPECT_TRUE(ring.tryPop(out));
+        EXPECT_EQ(out, std::to_string(i + 1000));
+    }
+    EXPECT_FALSE(ring.tryPop(out));
+
+    // Elements left in the ring are destroyed with it
+    EXPECT_TRUE(ring.tryPush(std::string(64, 'x')));
+}
+
+TEST(QueueTest, SpscRingProducerConsumer)
+{
+    constexpr int     count = 100000;
+    SpscRing<Message> ring(64);
+    std::thread       producer([&ring] {
+        for (int i = 0; i < count; i++) {
+            Message msg(std::to_string(i));
+            while (!ring.tryPush(msg)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    Message msg("");
+    for (int i = 0; i < count; i++) {
+        while (!ring.tryPop(msg)) {
+            std::this_thread::yield();
+        }
+        std::string text = msg.getMsg();
+        ASSERT_EQ(text.substr(text.rfind(' ') + 1), std::to_string(i)) << text;
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
+
+namespace {
+Message
+makeMessage(const std::string& text, Priority::PriorityLevel level)
+{
+    Priority priority(level);
+    return Message(text, priority);
+}
+
+std::string
+payload(const Message& msg)
+{
+    std::string text = msg.getMsg();
+    return text.substr(text.rfind(' ') + 1);
+}
+} // namespace
+
+TEST(QueueTest, LockingQueueUnbounded)
+{
+    LockingQueue queue;
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(queue.enqueue(Message(std::to_string(i))));
+    }
+    EXPECT_EQ(queue.getCount(), 1000u);
+    EXPECT_EQ(queue.getDropped(), 0u);
+}
+
+TEST(QueueTest, LockingQueueDropNewest)
+{
+    LockingQueue queue;
+    queue.configure(2, OverflowPolicy::eDropNewest);
+
+    EXPECT_TRUE(queue.enqueue(Message("a")));
+    EXPECT_TRUE(queue.enqueue(Message("b")));
+    EXPECT_FALSE(queue.enqueue(Message("c")));
+    EXPECT_EQ(queue.getDropped(), 1u);
+    EXPECT_EQ(payload(queue.dequeue()), "a");
+    EXPECT_EQ(payload(queue.dequeue()), "b");
+}
+
+TEST(QueueTest, LockingQueueDropOldest)
+{
+    LockingQueue queue;
+    queue.configure(2, OverflowPolicy::eDropOldest);
+
+    EXPECT_TRUE(queue.enqueue(Message("a")));
+    EXPECT_TRUE(queue.enqueue(Message("b")));
+    EXPECT_TRUE(queue.enqueue(Message("c")));
+    EXPECT_EQ(queue.getDropped(), 1u);
+    EXPECT_EQ(payload(queue.dequeue()), "b");
+    EXPECT_EQ(payload(queue.dequeue()), "c");
+}
+
+TEST(QueueTest, LockingQueueDropBelowPriority)
+{
+    using Level = Priority::PriorityLevel;
+    LockingQueue queue;
+    queue.configure(2, OverflowPolicy::eDropBelowPriority, Level::eWarning);
+
+    EXPECT_TRUE(queue.enqueue(makeMessage("info", Level::eInfo)));
+    EXPECT_TRUE(queue.enqueue(makeMessage("error1", Level::eError)));
+
+    // Less severe than the threshold, dropped outright
+    EXPECT_FALSE(queue.enqueue(makeMessage("debug", Level::eDebug)));
+    // Severe enough, evicts the queued info message
+    EXPECT_TRUE(queue.enqueue(makeMessage("error2", Level::eError)));
+    EXPECT_EQ(queue.getDropped(), 2u);
+
+    EXPECT_EQ(payload(queue.dequeue()), "error1");
+    EXPECT_EQ(payload(queue.dequeue()), "error2");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(QueueTest, LockingQueueBlock)
+{
+    constexpr int count = 1000;
+    LockingQueue  queue;
+    queue.configure(4, OverflowPolicy::eBlock);
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < count; i++) {
+            EXPECT_TRUE(queue.enqueue(Message(std::to_string(i))));
+        }
+    });
+
+    // Nothing is lost, the producer waits for room instead
+    for (int i = 0; i < count; i++) {
+        while (queue.empty()) {
+            std::this_thread::yield();
+        }
+        EXPECT_LE(queue.getCount(), 4u);
+        EXPECT_EQ(payload(queue.dequeue()), std::to_string(i));
+    }
+    producer.join();
+    EXPECT_EQ(queue.getDropped(), 0u);
+
+    // A closed queue stops blocking and drops what does not fit
+    for (int i = 0; i < 4; i++) {
+        queue.enqueue(Message("fill"));
+    }
+    queue.close();
+    EXPECT_FALSE(queue.enqueue(Message("late")));
+    EXPECT_EQ(queue.getDropped(), 1u);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2025, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/Memory/ObjectPool.hh"
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Au::Memory;
+
+namespace {
+
+class Tracked
+{
+  public:
+    static std::atomic<int> live;
+    std::string             m_value;
+
+    explicit Tracked(std::string value)
+        : m_value{ std::move(value) }
+    {
+        live++;
+    }
+    ~Tracked() { live--; }
+};
+std::atomic<int> Tracked::live{ 0 };
+
+TEST(ObjectPoolTest, AcquireRelease)
+{
+    ObjectPool<Tracked> pool(4);
+    EXPECT_EQ(pool.capacity(), 4u);
+
+    std::vector<Tracked*> objs;
+    for (int i = 0; i < 4; i++) {
+        objs.push_back(pool.acquire(std::to_string(i)));
+        EXPECT_TRUE(pool.owns(objs.back()));
+        EXPECT_EQ(objs.back()->m_value, std::to_string(i));
+    }
+    EXPECT_EQ(Tracked::live, 4);
+    EXPECT_EQ(pool.getFallbackCount(), 0u);
+
+    // Distinct slots
+    EXPECT_EQ(std::set<Tracked*>(objs.begin(), objs.end()).size(), 4u);
+
+    for (auto obj : objs) {
+        pool.release(obj);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+
+    // Released slots are reused
+    Tracked* again = pool.acquire("again");
+    EXPECT_TRUE(pool.owns(again));
+    pool.release(again);
+    EXPECT_EQ(pool.getFallbackCount(), 0u);
+}
+
+TEST(ObjectPoolTest, HeapFallback)
+{
+    ObjectPool<Tracked> pool(1);
+
+    Tracked* first  = pool.acquire("first");
+    Tracked* second = pool.acquire("second");
+    EXPECT_TRUE(pool.owns(first));
+    EXPECT_FALSE(pool.owns(second));
+    EXPECT_EQ(pool.getFallbackCount(), 1u);
+
+    pool.release(second);
+    pool.release(first);
+    pool.release(nullptr);
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(ObjectPoolTest, ConcurrentAcquireRelease)
+{
+    constexpr int       threads = 4;
+    constexpr int       rounds  = 20000;
+    ObjectPool<Tracked> pool(threads * 2);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&pool, t] {
+            for (int i = 0; i < rounds; i++) {
+                Tracked* a = pool.acquire(std::to_string(t));
+                Tracked* b = pool.acquire(std::to_string(t));
+                // A slot handed out twice would be overwritten by another
+                // thread
+                EXPECT_EQ(a->m_value, std::to_string(t));
+                EXPECT_EQ(b->m_value, std::to_string(t));
+                pool.release(b);
+                pool.release(a);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    EXPECT_EQ(Tracked::live, 0);
+    // Every thread holds at most two objects at a time
+    EXPECT_EQ(pool.getFallbackCount(), 0u);
+}
+
+} // namespace
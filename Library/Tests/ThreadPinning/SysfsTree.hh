@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @brief                    SysfsTree
+ *
+ * @details                  Synthetic /sys/devices/system tree of an SMT2
+ * machine: the sibling of CPU n is CPU n + cpuCount / 2, every core has its
+ * own L1 caches, pairs of cores share an L2 cache, coresPerCache cores share
+ * an L3 cache and the cores are split evenly over nodeCount nodes and
+ * packages. Only the *_list forms of the CPU maps are written. CPUs for which
+ * offline() is true have no topology. With
+ * reversedIndexes the cache/index<N> directories list the caches from L3
+ * down to L1.
+ */
+class SysfsTree
+{
+  public:
+    std::string m_root;
+
+    SysfsTree(const std::string&       name,
+              int                      cpuCount,
+              int                      coresPerCache,
+              int                      nodeCount,
+              std::function<bool(int)> offline,
+              bool                     reversedIndexes = false)
+        : m_root{ (std::filesystem::temp_directory_path() / name).string() }
+    {
+        std::filesystem::remove_all(m_root);
+        int   coreCount = cpuCount / 2;
+        auto  online    = [&](int cpu) { return !offline(cpu); };
+        auto  coreOf    = [&](int cpu) { return cpu % coreCount; };
+        auto& root      = m_root;
+        auto  mkdir     = [&root](const std::string& path) {
+            std::filesystem::create_directories(root + "/" + path);
+        };
+        auto write = [&root](const std::string& path, const std::string& text) {
+            std::ofstream(root + "/" + path) << text << "\n";
+        };
+        auto cpulist = [&](std::function<bool(int)> member) {
+            std::string text;
+            for (int cpu = 0; cpu < cpuCount; cpu++) {
+                if (!online(cpu) || !member(cpu))
+                    continue;
+                int last = cpu;
+                while (last + 1 < cpuCount && online(last + 1)
+                       && member(last + 1))
+                    last++;
+                text += (text.empty() ? "" : ",") + std::to_string(cpu);
+                if (last > cpu)
+                    text += "-" + std::to_string(last);
+                cpu = last;
+            }
+            return text;
+        };
+
+        // Lists of the CPUs of (cores sharing a resource, resource index)
+        std::map<std::pair<int, int>, std::string> sharedLists;
+        for (int cpu = 0; cpu < cpuCount; cpu++) {
+            std::string dir = "cpu/cpu" + std::to_string(cpu);
+            if (!online(cpu)) {
+                mkdir(dir);
+                continue;
+            }
+            mkdir(dir + "/topology");
+            int  core   = coreOf(cpu);
+            auto shared = [&](int cores) -> const std::string& {
+                auto key = std::make_pair(cores, core / cores);
+                auto it  = sharedLists.find(key);
+                if (it == sharedLists.end()) {
+                    it = sharedLists
+                             .emplace(key, cpulist([&](int c) {
+                                          return coreOf(c) / cores
+                                                 == core / cores;
+                                      }))
+                             .first;
+                }
+                return it->second;
+            };
+            write(dir + "/topology/thread_siblings_list", shared(1));
+            write(dir + "/topology/physical_package_id",
+                  std::to_string(core / (coreCount / nodeCount)));
+
+            // level, type and cores sharing the cache
+            std::vector<std::tuple<int, std::string, int>> caches = {
+                { 1, "Data", 1 },
+                { 1, "Instruction", 1 },
+                { 2, "Unified", 2 },
+                { 3, "Unified", coresPerCache },
+            };
+            if (reversedIndexes)
+                std::reverse(caches.begin(), caches.end());
+            for (size_t index = 0; index < caches.size(); index++) {
+                auto [level, type, cores] = caches[index];
+                std::string cacheDir =
+                    dir + "/cache/index" + std::to_string(index);
+                mkdir(cacheDir);
+                write(cacheDir + "/level", std::to_string(level));
+                write(cacheDir + "/type", type);
+                write(cacheDir + "/shared_cpu_list", shared(cores));
+            }
+        }
+        int coresPerNode = coreCount / nodeCount;
+        for (int node = 0; node < nodeCount; node++) {
+            std::string dir = "node/node" + std::to_string(node);
+            mkdir(dir);
+            write(dir + "/cpulist", cpulist([&](int cpu) {
+                      return coreOf(cpu) / coresPerNode == node;
+                  }));
+        }
+    }
+
+    ~SysfsTree() { std::filesystem::remove_all(m_root); }
+};
+
+} // namespace Au
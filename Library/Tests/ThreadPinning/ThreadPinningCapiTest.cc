@@ -77,6 +77,46 @@ TEST_F(PinThreadsTest, capiVerifyCustom)
     EXPECT_TRUE(VerifyAffinity(affinityVector));
 }
 
+TEST_F(PinThreadsTest, capiVerifyPlacement)
+{
+    pthread_t* threadList = &thread_ids[0];
+    EXPECT_EQ(au_place_threads(threadList, thread_ids.size(), "unknown"), -1);
+    EXPECT_EQ(au_place_threads(threadList, thread_ids.size(), "scatter,nosmt"),
+              0);
+}
+
+TEST(ThreadPinningCapiTest, availableProcessors)
+{
+    size_t           count = au_get_available_processors(nullptr, 0);
+    std::vector<int> processors(count + 1, -1);
+    EXPECT_GE(count, 1u);
+    EXPECT_EQ(au_get_available_processors(processors.data(), count), count);
+    EXPECT_TRUE(std::is_sorted(processors.begin(), processors.begin() + count));
+    EXPECT_EQ(processors[count], -1);
+    EXPECT_GE(au_get_cpu_quota(), 0.0);
+}
+
+TEST(ThreadPinningCapiTest, customReport)
+{
+    int processor = 0;
+    au_get_available_processors(&processor, 1);
+    std::thread worker(
+        [] { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+    pthread_t            thread = worker.native_handle();
+    au_thread_affinity_t report{};
+    EXPECT_EQ(au_pin_threads_custom_report(&thread, 1, &processor, 1, &report),
+              0);
+    int affinity = -1;
+    EXPECT_EQ(au_get_thread_affinity(thread, &affinity, 1), 1u);
+    worker.join();
+
+    EXPECT_EQ(affinity, processor);
+    EXPECT_EQ(report.requested, processor);
+    EXPECT_EQ(report.actual, processor);
+    EXPECT_EQ(report.actualCount, 1u);
+    EXPECT_EQ(report.status, 0);
+}
+
 #if AU_ENABLE_ASSERTS == 1
 // Negative test case
 TEST_F(PinThreadsNegativeTest, capiVerifyInvalidcorenumber)
@@ -25,9 +25,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *
  */
+#include "Capi/au/threadpinning.h"
 #include "MockTest.hh"
 #include <fstream>
 
+#ifdef __linux__
+#include "SysfsTree.hh"
+#endif
+
 namespace {
 
 using namespace Au;
@@ -36,7 +41,11 @@ class MockCpuTopology : public CpuTopology
   public:
     MockCpuTopology(){};
 
-    void setActiveProcessors(int num) { active_processors = num; }
+    void setActiveProcessors(int num)
+    {
+        active_processors = num;
+        availableProcessors.clear();
+    }
     void setPMap(std::vector<std::vector<std::pair<KAFFINITY, int>>> pMap)
     {
         processorMap = pMap;
@@ -49,6 +58,10 @@ class MockCpuTopology : public CpuTopology
     {
         groupMap = gMap;
     }
+    void setNMap(std::vector<std::vector<std::pair<KAFFINITY, int>>> nMap)
+    {
+        numaMap = nMap;
+    }
 };
 
 INSTANTIATE_TEST_SUITE_P(
@@ -149,4 +162,665 @@ TEST_P(ThreadPinningTest, affinityVectorTest)
     EXPECT_EQ(processPinGroup, SpreadResult);
 }
 
+TEST(ThreadPinningNumaTest, numaAffinityVectorTest)
+{
+    // Two nodes of two L3 caches with four SMT2 cores each, Linux numbering:
+    // the SMT sibling of core n is n + 16
+    std::vector<std::vector<CoreMask>> pMap, cMap, nMap;
+    for (int core = 0; core < 16; core++) {
+        pMap.push_back(
+            { std::make_pair((1UL << core) | (1UL << (core + 16)), 0) });
+    }
+    for (int cache = 0; cache < 4; cache++) {
+        cMap.push_back({ std::make_pair(
+            (0xFUL << (cache * 4)) | (0xFUL << (cache * 4 + 16)), 0) });
+    }
+    nMap.push_back({ std::make_pair(0x00FF00FFUL, 0) });
+    nMap.push_back({ std::make_pair(0xFF00FF00UL, 0) });
+
+    MockCpuTopology mockCT;
+    mockCT.setActiveProcessors(32);
+    mockCT.setPMap(pMap);
+    mockCT.setCMap(cMap);
+    mockCT.setGMap({ std::make_pair(0xFFFFFFFFUL, 32) });
+    mockCT.setNMap(nMap);
+    auto av = AffinityVector(mockCT);
+
+    std::vector<int> processPinGroup(3);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 4, 8 }));
+
+    processPinGroup.assign(4, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 4, 8, 12 }));
+
+    processPinGroup.assign(8, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 1, 4, 5, 8, 9, 12, 13 }));
+
+    // Every physical core of a cache is used before its SMT siblings
+    processPinGroup.assign(20, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup,
+              (std::vector<int>{ 0, 1, 2,  3,  16, 4,  5,  6,  7,  20,
+                                 8, 9, 10, 11, 24, 12, 13, 14, 15, 28 }));
+
+    processPinGroup.assign(4, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_COMPACT);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 1, 2, 3 }));
+
+    processPinGroup.assign(20, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_COMPACT);
+    EXPECT_EQ(processPinGroup,
+              (std::vector<int>{ 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
+                                 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }));
+
+    // Without NUMA information the machine is one node
+    mockCT.setNMap({});
+    processPinGroup.assign(4, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 4, 8, 12 }));
+}
+
+TEST(PlacementSpecTest, parse)
+{
+    PlacementSpec spec;
+    ASSERT_TRUE(PlacementSpec::parse("compact", spec));
+    EXPECT_EQ(spec.policy, PlacementPolicy::eCompact);
+    EXPECT_EQ(spec.permute, 0);
+    EXPECT_FALSE(spec.noSmt);
+
+    ASSERT_TRUE(PlacementSpec::parse(" Scatter, permute=2 ,NOSMT", spec));
+    EXPECT_EQ(spec.policy, PlacementPolicy::eScatter);
+    EXPECT_EQ(spec.permute, 2);
+    EXPECT_TRUE(spec.noSmt);
+
+    ASSERT_TRUE(PlacementSpec::parse("spread,places=ll_caches", spec));
+    EXPECT_EQ(spec.policy, PlacementPolicy::eSpread);
+    EXPECT_EQ(spec.places, PlaceKind::eCaches);
+
+    for (const char* bad : { "",
+                             "balanced",
+                             "compact,4",
+                             "compact,places=cores",
+                             "close,1",
+                             "close,places=sockets",
+                             "scatter,smt" }) {
+        PlacementSpec unchanged;
+        EXPECT_FALSE(PlacementSpec::parse(bad, unchanged)) << bad;
+        EXPECT_EQ(unchanged.policy, PlacementPolicy::eCompact) << bad;
+    }
+}
+
+TEST(PlacementSpecTest, placementAffinityVector)
+{
+    // 2 nodes of 2 caches of 2 cores, the SMT sibling of core n is n + 8
+    MockCpuTopology mockCT;
+    std::vector<std::vector<CoreMask>> pMap, cMap, nMap;
+    for (int core = 0; core < 8; core++)
+        pMap.push_back({ { (1UL << core) | (1UL << (core + 8)), 0 } });
+    for (int cache = 0; cache < 4; cache++)
+        cMap.push_back({ { (0x3UL << cache * 2) * 0x101, 0 } });
+    for (int node = 0; node < 2; node++)
+        nMap.push_back({ { (0xFUL << node * 4) * 0x101, 0 } });
+    mockCT.setActiveProcessors(16);
+    mockCT.setPMap(pMap);
+    mockCT.setCMap(cMap);
+    mockCT.setGMap({ { 0xFFFF, 64 } });
+    mockCT.setNMap(nMap);
+    AffinityVector av(mockCT);
+
+    auto place = [&av](const char* text, int threads) {
+        PlacementSpec spec;
+        EXPECT_TRUE(PlacementSpec::parse(text, spec)) << text;
+        std::vector<int> processPinGroup(threads, -1);
+        av.getPlacementAffinityVector(processPinGroup, spec);
+        return processPinGroup;
+    };
+    using V = std::vector<int>;
+    EXPECT_EQ(place("compact", 8), (V{ 0, 8, 1, 9, 2, 10, 3, 11 }));
+    EXPECT_EQ(place("compact,1", 8), (V{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+    EXPECT_EQ(place("compact,1", 10), (V{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    EXPECT_EQ(place("scatter", 8), (V{ 0, 4, 2, 6, 1, 5, 3, 7 }));
+    EXPECT_EQ(place("scatter", 10), (V{ 0, 4, 2, 6, 1, 5, 3, 7, 8, 12 }));
+    EXPECT_EQ(place("scatter,nosmt", 10), (V{ 0, 4, 2, 6, 1, 5, 3, 7, 0, 4 }));
+    EXPECT_EQ(place("compact,nosmt", 3), (V{ 0, 1, 2 }));
+    EXPECT_EQ(place("close", 3), (V{ 0, 8, 1 }));
+    EXPECT_EQ(place("close,places=cores", 4), (V{ 0, 1, 2, 3 }));
+    EXPECT_EQ(place("spread,places=cores", 4), (V{ 0, 2, 4, 6 }));
+    EXPECT_EQ(place("spread,places=numa_domains", 4), (V{ 0, 1, 4, 5 }));
+    // More threads than places: consecutive threads share a place
+    EXPECT_EQ(place("close,places=ll_caches", 8),
+              (V{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+    EXPECT_EQ(place("spread,places=cores", 16),
+              (V{ 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15 }));
+}
+
+TEST(PartitionSpecTest, parse)
+{
+    std::map<std::string, std::string> environ;
+    auto getenv = [&environ](const char* name) -> const char* {
+        auto it = environ.find(name);
+        return it == environ.end() ? nullptr : it->second.c_str();
+    };
+
+    PartitionSpec spec;
+    ASSERT_TRUE(PartitionSpec::parse(" 3 / 8 ", spec, getenv));
+    EXPECT_EQ(spec.index, 3u);
+    EXPECT_EQ(spec.count, 8u);
+    ASSERT_TRUE(PartitionSpec::parse("None", spec, getenv));
+    EXPECT_EQ(spec.count, 1u);
+
+    // Unset, then from the launcher
+    ASSERT_TRUE(PartitionSpec::fromEnvironment(spec, getenv));
+    EXPECT_EQ(spec.count, 1u);
+    environ["AU_CPU_PARTITION"] = "auto";
+    ASSERT_TRUE(PartitionSpec::fromEnvironment(spec, getenv));
+    EXPECT_EQ(spec.count, 1u);
+    environ["MPI_LOCALRANKID"] = "1";
+    environ["MPI_LOCALNRANKS"] = "4";
+    ASSERT_TRUE(PartitionSpec::fromEnvironment(spec, getenv));
+    EXPECT_EQ(spec.index, 1u);
+    EXPECT_EQ(spec.count, 4u);
+    environ["OMPI_COMM_WORLD_LOCAL_RANK"] = "2";
+    environ["OMPI_COMM_WORLD_LOCAL_SIZE"] = "3";
+    ASSERT_TRUE(PartitionSpec::fromEnvironment(spec, getenv));
+    EXPECT_EQ(spec.index, 2u);
+    EXPECT_EQ(spec.count, 3u);
+    environ["OMPI_COMM_WORLD_LOCAL_RANK"] = "3";
+    EXPECT_FALSE(PartitionSpec::fromEnvironment(spec, getenv));
+
+    for (const char* bad : { "2", "4/4", "1/0", "-1/4", "a/2", "1/2/3" }) {
+        PartitionSpec unchanged;
+        EXPECT_FALSE(PartitionSpec::parse(bad, unchanged, getenv)) << bad;
+        EXPECT_EQ(unchanged.count, 1u) << bad;
+    }
+}
+
+#ifdef __linux__
+TEST(CpuSetTest, parseAndConvert)
+{
+    auto list = CpuSet::fromList("0-3,8,65-66\n");
+    EXPECT_EQ(list.toList(), (std::vector<int>{ 0, 1, 2, 3, 8, 65, 66 }));
+    EXPECT_EQ(list.count(), 7u);
+    EXPECT_EQ(list.size(), 67);
+    ASSERT_EQ(list.toCoreMasks().size(), 2u);
+    EXPECT_EQ(list.toCoreMasks()[0], std::make_pair(KAFFINITY(0x10F), 0));
+    EXPECT_EQ(list.toCoreMasks()[1], std::make_pair(KAFFINITY(0x6), 1));
+    EXPECT_EQ(CpuSet::fromCoreMasks(list.toCoreMasks()), list);
+
+    // cpumaps list 32 bit chunks, the most significant first
+    auto mask = CpuSet::fromMask("00000006,00000000,0000010f\n");
+    EXPECT_EQ(mask, list);
+
+    EXPECT_TRUE(CpuSet::fromList("").empty());
+    EXPECT_TRUE(CpuSet::fromMask("00000000,00000000").empty());
+
+    CpuSet high;
+    high.set(1500);
+    EXPECT_TRUE(high.test(1500));
+    EXPECT_EQ(high.size(), 1501);
+    high.reset(1500);
+    EXPECT_TRUE(high.empty());
+}
+
+TEST(CpuSetTest, parseList)
+{
+    const char text[] = "0-63,65,128-130,191-192\n";
+    CpuSet     cpus;
+    ASSERT_TRUE(CpuSet::parseList(text, sizeof(text) - 1, cpus));
+    EXPECT_EQ(cpus.count(), 64u + 1 + 3 + 2);
+    EXPECT_TRUE(cpus.test(63) && cpus.test(65) && cpus.test(192));
+    EXPECT_FALSE(cpus.test(64) || cpus.test(131) || cpus.test(190));
+
+    // Only the given length is parsed, the buffer need not end in a NUL
+    CpuSet prefix;
+    ASSERT_TRUE(CpuSet::parseList("12-13,99", 5, prefix));
+    EXPECT_EQ(prefix.toList(), (std::vector<int>{ 12, 13 }));
+
+    CpuSet empty;
+    EXPECT_TRUE(CpuSet::parseList("\n", 1, empty));
+    EXPECT_TRUE(empty.empty());
+
+    for (const char* bad : { "3-1", "a", "1-", "1;2", "-1", "99999999999" }) {
+        CpuSet ignored;
+        EXPECT_FALSE(CpuSet::parseList(bad, strlen(bad), ignored)) << bad;
+    }
+    EXPECT_TRUE(CpuSet::fromList("0-3x").empty());
+
+    CpuSet range;
+    range.setRange(60, 200);
+    EXPECT_EQ(range.count(), 141u);
+    EXPECT_EQ(range.first(), 60);
+    EXPECT_EQ(range.size(), 201);
+}
+
+TEST(CpuSetTest, sysfsDir)
+{
+    SysfsTree tree("au_sysfs_dir", 8, 4, 1, [](int cpu) { return cpu == 5; });
+    SysfsDir  cpuRoot(tree.m_root + "/cpu");
+    ASSERT_TRUE(cpuRoot.isOpen());
+    std::vector<int> ids = cpuRoot.list("cpu");
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, (std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+
+    SysfsDir index(cpuRoot, "cpu1/cache/index3");
+    int      level = 0;
+    CpuSet   shared;
+    EXPECT_TRUE(index.readInt("level", level));
+    EXPECT_EQ(level, 3);
+    EXPECT_TRUE(index.readEquals("type", "Unified"));
+    EXPECT_FALSE(index.readEquals("type", "Unif"));
+    ASSERT_TRUE(index.readList("shared_cpu_list", shared));
+    EXPECT_EQ(shared.toList(), (std::vector<int>{ 0, 1, 2, 3, 4, 6, 7 }));
+
+    // Offline CPUs have no topology
+    SysfsDir offline(cpuRoot, "cpu5/topology");
+    EXPECT_FALSE(offline.isOpen());
+    EXPECT_FALSE(offline.readList("thread_siblings_list", shared));
+}
+
+TEST(CpuTopologySysfsTest, cpus1024)
+{
+    // 2P machine: 512 SMT2 cores, 8 cores per L3, one node per socket
+    SysfsTree   tree("au_sysfs_1024", 1024, 8, 2, [](int) { return false; });
+    CpuTopology topology(tree.m_root, CpuSet());
+
+    EXPECT_EQ(topology.active_processors, 1024u);
+    EXPECT_EQ(topology.max_processors, 1024u);
+    EXPECT_EQ(topology.processorMap.size(), 512u);
+    EXPECT_EQ(topology.cacheMap.size(), 64u);
+    EXPECT_EQ(topology.numaMap.size(), 2u);
+    ASSERT_EQ(topology.groupMap.size(), 1024u / CpuSet::cWordBits);
+
+    // Cores are ordered by their first CPU, with the sibling 512 CPUs up
+    EXPECT_EQ(CpuSet::fromCoreMasks(topology.processorMap[511]).toList(),
+              (std::vector<int>{ 511, 1023 }));
+
+    AffinityVector   av(topology);
+    std::vector<int> processPinGroup(1024);
+    av.getAffinityVector(processPinGroup, pinStrategy::CORE);
+    std::vector<int> sorted(processPinGroup);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> all(1024);
+    std::iota(all.begin(), all.end(), 0);
+    EXPECT_EQ(sorted, all);
+
+    // One thread per L3 cache
+    processPinGroup.assign(64, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::SPREAD);
+    for (int thread = 0; thread < 64; thread++) {
+        EXPECT_EQ(processPinGroup[thread], thread * 8) << thread;
+    }
+
+    processPinGroup.assign(2, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 256 }));
+
+    processPinGroup.assign(1024, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_COMPACT);
+    EXPECT_EQ(processPinGroup[511], 511);
+    EXPECT_EQ(processPinGroup[1023], 1023);
+
+    // machine -> package -> NUMA -> L3 -> L2 -> core -> thread
+    const CpuDomain& machine = topology.domainTree;
+    EXPECT_EQ(machine.cpus.count(), 1024u);
+    ASSERT_EQ(machine.children.size(), 2u);
+    const CpuDomain& package = machine.children[1];
+    EXPECT_EQ(package.level, DomainLevel::ePackage);
+    EXPECT_EQ(package.cpus.first(), 256);
+    ASSERT_EQ(package.children.size(), 1u);
+    const CpuDomain& node = package.children[0];
+    EXPECT_EQ(node.level, DomainLevel::eNuma);
+    ASSERT_EQ(node.children.size(), 32u);
+    const CpuDomain& l3 = node.children[0];
+    EXPECT_EQ(l3.level, DomainLevel::eL3);
+    ASSERT_EQ(l3.children.size(), 4u);
+    const CpuDomain& l2 = l3.children[1];
+    EXPECT_EQ(l2.level, DomainLevel::eL2);
+    EXPECT_EQ(l2.cpus.toList(), (std::vector<int>{ 258, 259, 770, 771 }));
+    ASSERT_EQ(l2.children.size(), 2u);
+    EXPECT_EQ(l2.children[0].level, DomainLevel::eCore);
+    ASSERT_EQ(l2.children[0].children.size(), 2u);
+    EXPECT_EQ(l2.children[0].children[1].level, DomainLevel::eThread);
+    EXPECT_EQ(l2.children[0].children[1].cpus.first(), 770);
+
+    EXPECT_EQ(topology.getDomains(DomainLevel::eL3).size(), 64u);
+    EXPECT_EQ(topology.getDomains(DomainLevel::eL2).size(), 256u);
+    EXPECT_EQ(topology.getDomains(DomainLevel::eThread).size(), 1024u);
+    EXPECT_EQ(topology.cacheDomains.size(), 3u);
+    EXPECT_EQ(topology.cacheDomains.at(1).size(), 512u);
+}
+
+TEST(CpuTopologySysfsTest, offlineCpus)
+{
+    // CPUs 64 to 127 offline: the online CPU numbers are not contiguous. The
+    // caches are listed from L3 down, the levels still have to be right.
+    SysfsTree   tree(
+        "au_sysfs_offline",
+        256,
+        8,
+        1,
+        [](int cpu) { return cpu >= 64 && cpu < 128; },
+        true);
+    CpuTopology topology(tree.m_root, CpuSet());
+
+    EXPECT_EQ(topology.cacheMap.size(), 16u);
+    EXPECT_EQ(topology.getDomains(DomainLevel::eL2).size(), 64u);
+    EXPECT_EQ(topology.getDomains(DomainLevel::eNuma).size(), 1u);
+
+    EXPECT_EQ(topology.active_processors, 192u);
+    EXPECT_EQ(topology.max_processors, 256u);
+    EXPECT_EQ(topology.processorMap.size(), 128u);
+
+    AffinityVector   av(topology);
+    std::vector<int> processPinGroup(192);
+    av.getAffinityVector(processPinGroup, pinStrategy::CORE);
+    std::sort(processPinGroup.begin(), processPinGroup.end());
+    for (int cpu : processPinGroup) {
+        EXPECT_TRUE(cpu < 64 || cpu >= 128) << cpu;
+    }
+    EXPECT_EQ(std::unique(processPinGroup.begin(), processPinGroup.end()),
+              processPinGroup.end());
+}
+
+TEST(CpuTopologySysfsTest, allowedCpus)
+{
+    // 128 SMT2 cores, the sibling of CPU n is n + 128, nodes of 64 cores
+    SysfsTree tree("au_sysfs_allowed", 256, 8, 2, [](int) { return false; });
+    CpuSet    allowed = CpuSet::fromList("0-15,200-203");
+    CpuTopology topology(tree.m_root, allowed);
+
+    EXPECT_EQ(topology.active_processors, 20u);
+    EXPECT_EQ(topology.max_processors, 256u);
+    EXPECT_EQ(topology.availableProcessors, allowed.toList());
+    // None of the siblings is allowed, every core has one CPU left
+    EXPECT_EQ(topology.processorMap.size(), 20u);
+    EXPECT_EQ(topology.cacheMap.size(), 3u);
+    EXPECT_EQ(topology.numaMap.size(), 2u);
+    EXPECT_EQ(topology.domainTree.cpus, allowed);
+    EXPECT_EQ(topology.getDomains(DomainLevel::eL3).size(), 3u);
+
+    AffinityVector   av(topology);
+    std::vector<int> processPinGroup(22);
+    av.getAffinityVector(processPinGroup, pinStrategy::LOGICAL);
+    std::vector<int> expected = allowed.toList();
+    expected.push_back(0);
+    expected.push_back(1);
+    EXPECT_EQ(processPinGroup, expected);
+
+    for (int strategy = pinStrategy::SPREAD;
+         strategy <= pinStrategy::NUMA_COMPACT;
+         strategy++) {
+        processPinGroup.assign(40, -1);
+        av.getAffinityVector(processPinGroup, strategy);
+        for (int cpu : processPinGroup) {
+            EXPECT_TRUE(allowed.test(cpu)) << strategy << " " << cpu;
+        }
+    }
+
+    processPinGroup.assign(2, 0);
+    av.getAffinityVector(processPinGroup, pinStrategy::NUMA_SPREAD);
+    EXPECT_EQ(processPinGroup, (std::vector<int>{ 0, 200 }));
+
+    // A mask without any online CPU is ignored
+    CpuTopology unrestricted(tree.m_root, CpuSet::fromList("300-301"));
+    EXPECT_EQ(unrestricted.active_processors, 256u);
+}
+
+TEST(CpuTopologySysfsTest, partition)
+{
+    // 32 SMT2 cores, the sibling of CPU n is n + 32, 4 cores per L3 cache,
+    // 2 cores per L2 cache, nodes of 16 cores
+    SysfsTree   tree("au_sysfs_partition", 64, 4, 2, [](int) { return false; });
+    CpuTopology topology(tree.m_root, CpuSet());
+
+    auto slices = [&topology](size_t count) {
+        std::vector<CpuSet> result;
+        for (size_t index = 0; index < count; index++)
+            result.push_back(
+                CpuTopology::partition(topology.domainTree, count, index));
+        return result;
+    };
+    EXPECT_EQ(slices(1), (std::vector<CpuSet>{ topology.domainTree.cpus }));
+    EXPECT_EQ(slices(2), topology.getDomains(DomainLevel::eNuma));
+    EXPECT_EQ(slices(8), topology.getDomains(DomainLevel::eL3));
+    EXPECT_EQ(slices(16), topology.getDomains(DomainLevel::eL2));
+    EXPECT_EQ(slices(32), topology.getDomains(DomainLevel::eCore));
+
+    for (size_t count : { 3, 5, 6, 7, 12, 24, 64 }) {
+        CpuSet covered;
+        size_t smallest = SIZE_MAX, largest = 0;
+        for (auto& slice : slices(count)) {
+            CpuSet overlap = covered;
+            overlap &= slice;
+            EXPECT_TRUE(overlap.empty()) << count;
+            covered |= slice;
+            smallest = std::min(smallest, slice.count());
+            largest  = std::max(largest, slice.count());
+            // Siblings stay together while there are enough cores
+            if (count > 32)
+                continue;
+            for (int cpu : slice.toList())
+                EXPECT_TRUE(slice.test((cpu + 32) % 64)) << count;
+        }
+        EXPECT_EQ(covered, topology.domainTree.cpus) << count;
+        EXPECT_LE(largest - smallest, 64 / count / 4 + 2) << count;
+    }
+    // More slices than CPUs share them
+    for (auto& slice : slices(100))
+        EXPECT_EQ(slice.count(), 1u);
+
+    // Every strategy stays in the slice
+    CpuSet         slice = CpuTopology::partition(topology.domainTree, 3, 1);
+    CpuTopology    sliced(tree.m_root, slice);
+    AffinityVector av(sliced);
+    EXPECT_EQ(sliced.availableProcessors, slice.toList());
+    for (int strategy = pinStrategy::SPREAD;
+         strategy <= pinStrategy::NUMA_COMPACT;
+         strategy++) {
+        std::vector<int> processPinGroup(40, -1);
+        av.getAffinityVector(processPinGroup, strategy);
+        for (int cpu : processPinGroup) {
+            EXPECT_TRUE(slice.test(cpu)) << strategy << " " << cpu;
+        }
+    }
+
+    // Malformed or unset, the process keeps its CPUs
+    auto getenv = [](const char* name) -> const char* {
+        return std::string(name) == "AU_CPU_PARTITION" ? "1/x" : nullptr;
+    };
+    EXPECT_EQ(CpuTopology::environmentPartition(getenv).count, 1u);
+    EXPECT_EQ(CpuTopology::environmentPartition(
+                  [](const char*) { return nullptr; })
+                  .count,
+              1u);
+    CpuSet affinity = CpuSet::fromList("0-47");
+    EXPECT_EQ(CpuTopology::ofProcess(
+                  tree.m_root, PartitionSpec(), affinity, CpuSet())
+                  .domainTree.cpus,
+              affinity);
+
+    // Slices of the cgroup cpuset, whatever the affinity of every rank
+    CpuSet cpuset = CpuSet::fromList("0-15,32-47");
+    CpuSet covered;
+    for (size_t index : { 0, 1 }) {
+        PartitionSpec spec;
+        spec.index   = index;
+        spec.count   = 2;
+        CpuSet slice = CpuTopology::ofProcess(
+                           tree.m_root, spec, CpuSet::fromList("0-63"), cpuset)
+                           .domainTree.cpus;
+        EXPECT_EQ(slice.count(), 16u) << index;
+        CpuSet overlap = covered;
+        overlap &= slice;
+        EXPECT_TRUE(overlap.empty()) << index;
+        covered |= slice;
+    }
+    EXPECT_EQ(covered, cpuset);
+
+    // Bound by the launcher, the process keeps its CPUs
+    PartitionSpec half;
+    half.index   = 1;
+    half.count   = 2;
+    CpuSet bound = CpuSet::fromList("0-3,32-35");
+    EXPECT_EQ(CpuTopology::ofProcess(tree.m_root, half, bound, cpuset)
+                  .domainTree.cpus,
+              bound);
+}
+
+TEST(CpuTopologySysfsTest, setPartition)
+{
+    std::vector<int> whole = ThreadPinning().getAvailableProcessors();
+
+    EXPECT_FALSE(ThreadPinning::setPartition(2, 2).ok());
+    EXPECT_FALSE(ThreadPinning::setPartition(1, 0).ok());
+    EXPECT_EQ(au_set_cpu_partition(2, 2), -1);
+
+    // The slices of the machine cover it, disjoint when there are enough
+    // processors
+    std::vector<int> covered;
+    for (size_t index = 0; index < 2; index++) {
+        ASSERT_TRUE(ThreadPinning::setPartition(index, 2).ok());
+        size_t selected = 0, count = 0;
+        ThreadPinning::getPartition(selected, count);
+        EXPECT_EQ(selected, index);
+        EXPECT_EQ(count, 2u);
+
+        std::vector<int> slice = ThreadPinning().getAvailableProcessors();
+        EXPECT_FALSE(slice.empty());
+        if (whole.size() >= 2) {
+            EXPECT_LE(slice.size(), (whole.size() + 1) / 2 + 1);
+        }
+        covered.insert(covered.end(), slice.begin(), slice.end());
+    }
+    std::sort(covered.begin(), covered.end());
+    covered.erase(std::unique(covered.begin(), covered.end()), covered.end());
+    EXPECT_EQ(covered, whole);
+
+    // Through the C API, back to the whole machine
+    EXPECT_EQ(au_set_cpu_partition(0, 1), 0);
+    size_t index = 1, count = 0;
+    au_get_cpu_partition(&index, &count);
+    EXPECT_EQ(index, 0u);
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(ThreadPinning().getAvailableProcessors(), whole);
+}
+
+/**
+ * @brief                    CgroupTree
+ *
+ * @details                  Synthetic cgroup mount and /proc/self/cgroup.
+ */
+class CgroupTree
+{
+  public:
+    std::string m_root;
+    std::string m_procCgroup;
+
+    explicit CgroupTree(const std::string& name)
+        : m_root{ (std::filesystem::temp_directory_path() / name).string() }
+        , m_procCgroup{ m_root + "/proc_self_cgroup" }
+    {
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+
+    void write(const std::string& path, const std::string& text)
+    {
+        auto file = std::filesystem::path(m_root) / path;
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file) << text << "\n";
+    }
+
+    ~CgroupTree() { std::filesystem::remove_all(m_root); }
+};
+
+TEST(CgroupTest, unified)
+{
+    CgroupTree tree("au_cgroup_v2");
+    tree.write("proc_self_cgroup", "0::/kubepods/pod1/c1");
+    tree.write("kubepods/cpu.max", "max 100000");
+    tree.write("kubepods/pod1/cpu.max", "150000 100000");
+    tree.write("kubepods/pod1/cpuset.cpus.effective", "2-5,8");
+    tree.write("kubepods/pod1/c1/cpu.max", "400000 100000");
+
+    Cgroup cgroup(tree.m_root, tree.m_procCgroup);
+    CpuSet cpus;
+    // c1 has no cpuset file, the one of its parent applies
+    ASSERT_TRUE(cgroup.cpuset(cpus));
+    EXPECT_EQ(cpus.toList(), (std::vector<int>{ 2, 3, 4, 5, 8 }));
+    // The smallest limit of the hierarchy
+    EXPECT_DOUBLE_EQ(cgroup.cpuQuota(), 1.5);
+
+    // Without a cgroup namespace the container's cgroup is the mount root
+    CgroupTree root("au_cgroup_v2_root");
+    root.write("proc_self_cgroup", "0::/host/path/of/container");
+    root.write("cpu.max", "max 100000");
+    root.write("cpuset.cpus.effective", "0-3");
+    Cgroup unlimited(root.m_root, root.m_procCgroup);
+    ASSERT_TRUE(unlimited.cpuset(cpus));
+    EXPECT_EQ(cpus.count(), 4u);
+    EXPECT_EQ(unlimited.cpuQuota(), 0);
+}
+
+TEST(CgroupTest, legacy)
+{
+    CgroupTree tree("au_cgroup_v1");
+    tree.write("proc_self_cgroup",
+               "12:cpuset:/docker/abc\n"
+               "4:cpu,cpuacct:/docker/abc\n"
+               "0::/docker/abc");
+    tree.write("cpuset/docker/abc/cpuset.effective_cpus", "1,3");
+    tree.write("cpu,cpuacct/docker/abc/cpu.cfs_quota_us", "250000");
+    tree.write("cpu,cpuacct/docker/abc/cpu.cfs_period_us", "100000");
+    tree.write("cpu,cpuacct/docker/cpu.cfs_quota_us", "-1");
+    tree.write("cpu,cpuacct/docker/cpu.cfs_period_us", "100000");
+
+    Cgroup cgroup(tree.m_root, tree.m_procCgroup);
+    CpuSet cpus;
+    ASSERT_TRUE(cgroup.cpuset(cpus));
+    EXPECT_EQ(cpus.toList(), (std::vector<int>{ 1, 3 }));
+    EXPECT_DOUBLE_EQ(cgroup.cpuQuota(), 2.5);
+
+    // Outside of any cgroup nothing is limited
+    Cgroup none(tree.m_root, tree.m_root + "/missing");
+    EXPECT_FALSE(none.cpuset(cpus));
+    EXPECT_EQ(none.cpuQuota(), 0);
+}
+
+TEST(ThreadAffinityTest, report)
+{
+    // Pin a helper thread so that the affinity of the test runner is kept
+    const CpuTopology& topology  = CpuTopology::get();
+    int                processor = topology.availableProcessors.empty()
+                                       ? 0
+                                       : topology.availableProcessors[0];
+    std::thread        worker(
+        [] { std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+    AffinityVector              av(topology);
+    std::vector<ThreadAffinity> report;
+    std::vector<pthread_t>      threads{ worker.native_handle(),
+                                    worker.native_handle() };
+
+    Status status = av.setAffinity(
+        threads,
+        { static_cast<int>(topology.max_processors), processor },
+        report);
+    worker.join();
+
+    // The second thread is pinned even though the first one failed
+    ASSERT_EQ(report.size(), 2u);
+    EXPECT_FALSE(status.ok());
+    EXPECT_EQ(status, Status{ InvalidArgumentError() });
+    EXPECT_EQ(report[0].thread, threads[0]);
+    EXPECT_EQ(report[0].requested, static_cast<int>(topology.max_processors));
+    EXPECT_FALSE(report[0].status.ok());
+    EXPECT_FALSE(report[0].actual.empty());
+    EXPECT_EQ(report[1].requested, processor);
+    EXPECT_TRUE(report[1].status.ok()) << report[1].status.message();
+    EXPECT_EQ(report[1].actual, (std::vector<int>{ processor }));
+}
+#endif
+
 } // namespace
@@ -166,16 +166,9 @@ class PinThreadsTest : public ::testing::Test
 #else
     int getCoreAffinity(pthread_t threadHandle)
     {
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        pthread_getaffinity_np(threadHandle, sizeof(cpu_set_t), &cpuset);
-
-        for (int core = 0; core < CPU_SETSIZE; ++core) {
-            if (CPU_ISSET(core, &cpuset)) {
-                return core;
-            }
-        }
-        return -1;
+        // Not limited to CPU_SETSIZE CPUs
+        auto cpus = CpuSet::ofThread(threadHandle).toList();
+        return cpus.empty() ? -1 : cpus.front();
     }
 #endif
   public:
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/Barrier.hh"
+#include "Au/ThreadPool/CombiningTree.hh"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace Au;
+
+/**
+ * Two NUMA nodes of two L3 caches, four SMT2 cores per cache: 32 logical
+ * processors, siblings numbered next to each other.
+ */
+class MockCpuTopology : public CpuTopology
+{
+  public:
+    MockCpuTopology()
+    {
+        active_processors = 32;
+        processorMap.clear();
+        cacheMap.clear();
+        numaMap.clear();
+        groupMap = { std::make_pair(0xFFFFFFFFULL, 32) };
+        for (int core = 0; core < 16; core++)
+            processorMap.push_back({ std::make_pair(0b11ULL << core * 2, 0) });
+        for (int cache = 0; cache < 4; cache++)
+            cacheMap.push_back({ std::make_pair(0xFFULL << cache * 8, 0) });
+        for (int node = 0; node < 2; node++)
+            numaMap.push_back({ std::make_pair(0xFFFFULL << node * 16, 0) });
+    }
+};
+
+/**
+ * Runs body(participant, round) on one thread per participant.
+ */
+template<typename Body>
+void
+runRounds(size_t participants, int rounds, Body body)
+{
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < participants; p++) {
+        threads.emplace_back([&body, p, rounds] {
+            for (int round = 0; round < rounds; round++)
+                body(p, round);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+}
+
+TEST(CombiningTreeTest, followsTheHierarchy)
+{
+    MockCpuTopology  topology;
+    std::vector<int> processors(32);
+    for (int cpu = 0; cpu < 32; cpu++)
+        processors[cpu] = cpu;
+    CombiningTree tree(processors, topology);
+
+    // Cores, caches, nodes and the root
+    EXPECT_EQ(tree.depth(), 4u);
+    EXPECT_EQ(tree.nodeCount(), 16u + 4u + 2u + 1u);
+    for (int cpu = 0; cpu < 32; cpu += 2) {
+        // SMT siblings meet first
+        EXPECT_EQ(tree.leafOf(cpu), tree.leafOf(cpu + 1));
+        EXPECT_NE(tree.leafOf(cpu), tree.leafOf((cpu + 2) % 32));
+        // Then the cores of a cache, of a node
+        int core  = tree.leafOf(cpu);
+        int cache = tree.parentOf(core);
+        int node  = tree.parentOf(cache);
+        EXPECT_EQ(cache, tree.parentOf(tree.leafOf(cpu / 8 * 8)));
+        EXPECT_EQ(node,
+                  tree.parentOf(tree.parentOf(tree.leafOf(cpu / 16 * 16))));
+        EXPECT_EQ(tree.parentOf(tree.parentOf(node)), -1);
+    }
+    EXPECT_NE(tree.parentOf(tree.leafOf(0)), tree.parentOf(tree.leafOf(8)));
+    EXPECT_NE(tree.parentOf(tree.parentOf(tree.leafOf(0))),
+              tree.parentOf(tree.parentOf(tree.leafOf(16))));
+}
+
+TEST(CombiningTreeTest, skipsSingleLevels)
+{
+    // One thread per core of the first cache: a single node
+    MockCpuTopology topology;
+    CombiningTree   tree({ 0, 2, 4, 6 }, topology);
+    EXPECT_EQ(tree.depth(), 1u);
+    EXPECT_EQ(tree.nodeCount(), 1u);
+}
+
+TEST(CombiningTreeTest, boundsTheFanIn)
+{
+    // Unknown placement: 100 participants in groups of at most eight
+    CombiningTree tree(std::vector<int>(100, -1));
+    EXPECT_EQ(tree.depth(), 3u);
+    EXPECT_EQ(tree.nodeCount(), 13u + 2u + 1u);
+    std::vector<int> arrivals(tree.nodeCount(), 0);
+    for (size_t p = 0; p < tree.size(); p++)
+        arrivals[tree.leafOf(p)]++;
+    for (size_t n = 0; n < tree.nodeCount(); n++) {
+        if (tree.parentOf(n) >= 0)
+            arrivals[tree.parentOf(n)]++;
+    }
+    for (int count : arrivals) {
+        EXPECT_GE(count, 2);
+        EXPECT_LE(count, int(CombiningTree::cMaxFanIn));
+    }
+}
+
+TEST(TreeBarrierTest, singleParticipant)
+{
+    TreeBarrier barrier(size_t{ 1 });
+    EXPECT_EQ(barrier.size(), 1u);
+    EXPECT_EQ(barrier.depth(), 1u);
+    barrier.arriveAndWait(0);
+    EXPECT_EQ(barrier.reduce(0, 2.5, TreeBarrier::ReduceOp::eSum), 2.5);
+    EXPECT_EQ(barrier.reduce(0, Int64{ -3 }, TreeBarrier::ReduceOp::eMin), -3);
+}
+
+TEST(TreeBarrierTest, arriveAndWait)
+{
+    constexpr size_t cThreads = 11;
+    constexpr int    cRounds  = 2000;
+    TreeBarrier      barrier(cThreads);
+    std::vector<int> seen(cThreads, -1);
+    std::atomic<int> errors{ 0 };
+
+    runRounds(cThreads, cRounds, [&](size_t p, int round) {
+        seen[p] = round;
+        barrier.arriveAndWait(p);
+        // Every participant wrote this round, none the next one yet
+        for (int value : seen) {
+            if (value != round)
+                errors++;
+        }
+        barrier.arriveAndWait(p);
+    });
+    EXPECT_EQ(errors.load(), 0);
+}
+
+TEST(TreeBarrierTest, reduce)
+{
+    constexpr size_t cThreads = 9;
+    constexpr int    cRounds  = 1000;
+    TreeBarrier      barrier(cThreads);
+    std::atomic<int> errors{ 0 };
+
+    runRounds(cThreads, cRounds, [&](size_t p, int round) {
+        using Op  = TreeBarrier::ReduceOp;
+        Int64 sum = barrier.reduce(p, Int64(p) * round, Op::eSum);
+        Int64 min = barrier.reduce(p, Int64(p) - round, Op::eMin);
+        Int64 max = barrier.reduce(p, Int64(p) + round, Op::eMax);
+        double half = barrier.reduce(p, 0.5 * round, Op::eSum);
+        if (sum != Int64(cThreads * (cThreads - 1) / 2) * round
+            || min != -round || max != Int64(cThreads - 1) + round
+            || half != 0.5 * round * cThreads)
+            errors++;
+    });
+    EXPECT_EQ(errors.load(), 0);
+}
+
+TEST(TreeBarrierTest, reproducibleSum)
+{
+    // Floating point sums depend on the order, which must not vary
+    constexpr size_t    cThreads = 8;
+    constexpr int       cRounds  = 200;
+    TreeBarrier         barrier(cThreads);
+    std::vector<double> values   = { 1e16, 1.0, -1e16, 1.0,
+                                     3.3,  -2.2, 1e-8, 7.0 };
+    std::vector<std::set<double>> results(cThreads);
+
+    runRounds(cThreads, cRounds, [&](size_t p, int) {
+        results[p].insert(
+            barrier.reduce(p, values[p], TreeBarrier::ReduceOp::eSum));
+    });
+    for (auto& result : results) {
+        ASSERT_EQ(result.size(), 1u);
+        EXPECT_EQ(*result.begin(), *results[0].begin());
+    }
+}
+
+TEST(TreeBarrierTest, pinnedParticipants)
+{
+    // All on the first processor of the machine: they share a core
+    std::vector<ThreadAffinity> affinity(4);
+    for (auto& thread : affinity)
+        thread.requested = 0;
+    TreeBarrier      barrier(affinity);
+    std::atomic<int> errors{ 0 };
+    EXPECT_EQ(barrier.depth(), 1u);
+
+    runRounds(affinity.size(), 100, [&](size_t p, int round) {
+        if (barrier.reduce(p, Int64(round), TreeBarrier::ReduceOp::eMax)
+            != round)
+            errors++;
+    });
+    EXPECT_EQ(errors.load(), 0);
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Capi/au/threadpool.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+void
+increment(void* arg)
+{
+    static_cast<std::atomic<int>*>(arg)->fetch_add(1);
+}
+
+void
+sumRange(size_t begin, size_t end, void* arg)
+{
+    auto* sum = static_cast<std::atomic<size_t>*>(arg);
+    for (size_t i = begin; i < end; i++)
+        sum->fetch_add(i);
+}
+
+TEST(ThreadPoolCapiTest, submitAndParallelFor)
+{
+    au_thread_pool_t* pool = au_thread_pool_create(2, -1);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(au_thread_pool_size(pool), 2u);
+
+    std::atomic<int> count{ 0 };
+    for (int i = 0; i < 100; i++)
+        au_thread_pool_submit(pool, increment, &count);
+    au_thread_pool_wait(pool);
+    EXPECT_EQ(count.load(), 100);
+
+    std::atomic<size_t> sum{ 0 };
+    au_parallel_for(pool, 0, 1000, 10, sumRange, &sum);
+    EXPECT_EQ(sum.load(), 999u * 1000 / 2);
+
+    au_thread_pool_destroy(pool);
+    au_thread_pool_destroy(nullptr);
+}
+
+} // namespace
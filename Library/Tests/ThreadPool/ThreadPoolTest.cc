@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "Au/ThreadPool.hh"
+#include "Au/ThreadPool/VictimOrder.hh"
+#include "Au/ThreadPool/WorkStealingDeque.hh"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace Au;
+
+TEST(WorkStealingDequeTest, ownerAndThief)
+{
+    std::vector<int>        items(1000);
+    WorkStealingDeque<int*> deque(4);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    // Grows past the initial capacity
+    for (auto& item : items)
+        deque.push(&item);
+    EXPECT_EQ(deque.size(), items.size());
+    // The owner takes the newest, thieves the oldest
+    EXPECT_EQ(deque.pop(), &items.back());
+    EXPECT_EQ(deque.steal(), &items.front());
+    EXPECT_EQ(deque.steal(), &items[1]);
+    for (size_t i = items.size() - 2; i > 1; i--)
+        EXPECT_EQ(deque.pop(), &items[i]);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(deque.pop(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, concurrentSteal)
+{
+    constexpr int           cItems = 100000;
+    std::vector<int>        items(cItems);
+    std::vector<int>        taken(cItems, 0);
+    std::atomic<bool>       done{ false };
+    std::atomic<int>        count{ 0 };
+    WorkStealingDeque<int*> deque;
+    std::iota(items.begin(), items.end(), 0);
+
+    auto take = [&](int* item) {
+        taken[*item]++;
+        count++;
+    };
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&] {
+            while (!done.load() || !deque.empty()) {
+                if (int* item = deque.steal())
+                    take(item);
+            }
+        });
+    }
+    // The owner pops every other push, racing the thieves for the last item
+    for (int i = 0; i < cItems; i++) {
+        deque.push(&items[i]);
+        if (i % 2 == 1) {
+            if (int* item = deque.pop())
+                take(item);
+        }
+    }
+    while (int* item = deque.pop())
+        take(item);
+    done = true;
+    for (auto& thief : thieves)
+        thief.join();
+
+    EXPECT_EQ(count.load(), cItems);
+    EXPECT_EQ(std::count(taken.begin(), taken.end(), 1), cItems);
+}
+
+TEST(VictimOrderTest, hierarchicalLevels)
+{
+    // Mock topology: 2 nodes of 2 caches of 2 SMT2 cores, CPU n + 8 is the
+    // sibling of CPU n. Labels are node, cache, core and SMT rank.
+    std::vector<AffinityVector::CpuLabel> labels;
+    for (int cpu = 0; cpu < 16; cpu++) {
+        int core = cpu % 8;
+        labels.push_back(
+            { cpu, { core / 4, core / 2 % 2, core % 2, cpu / 8 } });
+    }
+
+    // Sibling, same cache, same node, other node and unpinned workers
+    std::vector<int> processors = { 0, 8, 1, 2, 4, -1 };
+    auto             victims    = VictimOrder::build(labels, processors);
+    using Levels                = VictimOrder::Levels;
+    ASSERT_EQ(victims.size(), processors.size());
+
+    // SMT sibling, same LLC, same node, remote; by index after self
+    EXPECT_EQ(victims[0], (Levels{ { { 1 }, { 2 }, { 3 }, { 4, 5 } } }));
+    EXPECT_EQ(victims[1], (Levels{ { { 0 }, { 2 }, { 3 }, { 4, 5 } } }));
+    EXPECT_EQ(victims[2], (Levels{ { {}, { 0, 1 }, { 3 }, { 4, 5 } } }));
+    EXPECT_EQ(victims[3], (Levels{ { {}, {}, { 0, 1, 2 }, { 4, 5 } } }));
+    EXPECT_EQ(victims[4], (Levels{ { {}, {}, {}, { 5, 0, 1, 2, 3 } } }));
+    EXPECT_EQ(victims[5], (Levels{ { {}, {}, {}, { 0, 1, 2, 3, 4 } } }));
+}
+
+TEST(ThreadPoolTest, submitAndWait)
+{
+    ThreadPool       pool(4, ThreadPool::cNoPinning);
+    std::atomic<int> count{ 0 };
+    EXPECT_EQ(pool.size(), 4u);
+    EXPECT_TRUE(pool.getStatus().ok());
+    EXPECT_TRUE(pool.getAffinity().empty());
+    EXPECT_EQ(pool.workerIndex(), -1);
+
+    for (int i = 0; i < 1000; i++) {
+        pool.submit([&pool, &count] {
+            // -1 when the waiting thread runs the task
+            EXPECT_GE(pool.workerIndex(), -1);
+            EXPECT_LT(pool.workerIndex(), 4);
+            // Tasks submitted by a task are waited for as well
+            pool.submit([&count] { count++; });
+            count++;
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 2000);
+}
+
+TEST(ThreadPoolTest, parallelFor)
+{
+    ThreadPool pool(3, ThreadPool::cNoPinning);
+    for (size_t grain : { 0, 1, 7, 1000 }) {
+        std::vector<std::atomic<int>> hits(10000);
+        pool.parallelFor(
+            0,
+            hits.size(),
+            [&hits, grain](size_t begin, size_t end) {
+                EXPECT_LT(begin, end);
+                if (grain != 0) {
+                    EXPECT_LE(end - begin, grain);
+                }
+                for (size_t i = begin; i < end; i++)
+                    hits[i]++;
+            },
+            grain);
+        for (auto& hit : hits)
+            EXPECT_EQ(hit.load(), 1) << "grain " << grain;
+    }
+
+    bool called = false;
+    pool.parallelFor(5, 5, [&called](size_t, size_t) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+TEST(ThreadPoolTest, nestedParallelFor)
+{
+    ThreadPool                    pool(2, ThreadPool::cNoPinning);
+    std::vector<std::atomic<int>> hits(64 * 64);
+    pool.parallelFor(
+        0,
+        64,
+        [&pool, &hits](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; row++) {
+                pool.parallelFor(
+                    0,
+                    64,
+                    [&hits, row](size_t first, size_t last) {
+                        for (size_t col = first; col < last; col++)
+                            hits[row * 64 + col]++;
+                    },
+                    4);
+            }
+        },
+        1);
+    for (auto& hit : hits)
+        EXPECT_EQ(hit.load(), 1);
+}
+
+TEST(ThreadPoolTest, pinnedWorkers)
+{
+    ThreadPool pool(2, pinStrategy::LOGICAL);
+    EXPECT_TRUE(pool.getStatus().ok()) << pool.getStatus().message();
+    ASSERT_EQ(pool.getAffinity().size(), 2u);
+    for (auto& worker : pool.getAffinity())
+        EXPECT_EQ(worker.actual, (std::vector<int>{ worker.requested }));
+
+    // Tasks submitted right after construction already run pinned. The
+    // test thread does not wait(), which would run some of them itself.
+    ThreadPool                    early(2, pinStrategy::LOGICAL);
+    std::mutex                    mutex;
+    std::vector<std::vector<int>> seen;
+    for (int i = 0; i < 8; i++) {
+        early.submit([&mutex, &seen] {
+            std::vector<int> cpus =
+                ThreadPinning().getThreadAffinity(pthread_self());
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.push_back(cpus);
+        });
+    }
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(mutex);
+        if (seen.size() == 8)
+            break;
+    }
+    for (auto& cpus : seen)
+        EXPECT_EQ(cpus.size(), 1u);
+
+    ThreadPool invalid(1, 42);
+    EXPECT_FALSE(invalid.getStatus().ok());
+    EXPECT_TRUE(invalid.getAffinity().empty());
+
+    ThreadPool automatic;
+    EXPECT_GE(automatic.size(), 1u);
+}
+
+} // namespace
@@ -40,6 +40,8 @@ log_capi()
     au_logger_log(logger, "This is warn message", AUD_LOG_LEVEL_WARN);
     au_logger_log(logger, "This is error message", AUD_LOG_LEVEL_ERROR);
     au_logger_log(logger, "This is fatal message", AUD_LOG_LEVEL_FATAL);
+    au_logger_logf(
+        logger, AUD_LOG_LEVEL_INFO, "This is message %d of %s", 8, "log_capi");
     au_logger_flush(logger);
     au_logger_destroy(logger);
 }
@@ -75,6 +75,12 @@ log_macro()
     AU_LOGGER_LOG_TRACE("This is a trace message using macro");
     AU_LOGGER_LOG_DEBUG("This is a debug message using macro");
     AU_LOGGER_LOG_NOTICE("This is a notice message using macro");
+
+    // Hot paths: log only 1 in 1000 executions, or at most 2 per second
+    for (int i = 0; i < 10000; ++i) {
+        AU_LOGGER_LOG_EVERY_N("This is a sampled message", eWarning, 1000);
+        AU_LOGGER_LOG_RATE_LIMITED("This is a rate limited message", eInfo, 2);
+    }
 }
 
 int
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Decodes a ring file written by Au::Logger::MmapRingLogger, for example the
+ * one left behind by a crashed process, and prints the records oldest first.
+ *
+ * Usage: logger_ring_reader_cpp <ring file>
+ */
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+#include "Au/Logger/Logger.hh"
+
+using namespace Au::Logger;
+
+int
+main(int argc, char const* argv[])
+{
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <ring file>" << std::endl;
+        return 1;
+    }
+
+    auto records = MmapRingLogger::readRing(argv[1]);
+    if (records.empty()) {
+        std::cerr << "No records found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Example "2024-09-02 11:31:36.123456789 : Info    : This is a message"
+    for (const auto& record : records) {
+        auto seconds = static_cast<std::time_t>(record.timestamp / 1000000000);
+        auto nanos   = record.timestamp % 1000000000;
+        auto local   = std::localtime(&seconds);
+        std::cout << std::put_time(local, "%Y-%m-%d %H:%M:%S") << "."
+                  << std::setw(9) << std::setfill('0') << nanos << " : "
+                  << Priority(record.level).getLabel() << " : " << record.text
+                  << std::endl;
+    }
+    return 0;
+}
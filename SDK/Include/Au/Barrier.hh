@@ -0,0 +1,144 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#pragma once
+#include "Au/Config.h"
+#include "Au/ThreadPinning.hh"
+#include "Au/Types.hh"
+#include <memory>
+#include <vector>
+
+namespace Au {
+
+class CombiningTree;
+
+/**
+ * @class TreeBarrier
+ * @brief Barrier and reduction for a fixed set of threads, combining along the
+ * cache hierarchy.
+ *
+ * The threads sharing a physical core meet first, then the cores sharing a
+ * last level cache, then the caches of a NUMA node and finally the nodes, at
+ * most eight arrivals per meeting point. Every meeting point sits on its own
+ * cache lines, so arrivals only contend with their neighbours. Waiting threads
+ * spin briefly, then sleep in the kernel until released.
+ *
+ * Every participant must arrive once per round, with its own index.
+ */
+class TreeBarrier
+{
+  public:
+    /// Reduction of the values given by the participants
+    enum class ReduceOp
+    {
+        eSum,
+        eMin,
+        eMax,
+    };
+
+    /**
+     * @brief          TreeBarrier
+     *
+     * @param[in]      processors        Processor each participant is pinned
+     * to, -1 if it is not pinned
+     */
+    explicit TreeBarrier(std::vector<int> const& processors);
+
+    /**
+     * @brief          TreeBarrier
+     *
+     * @details        One participant per entry, placed on the requested
+     * processor, e.g. the workers of ThreadPool::getAffinity().
+     *
+     * @param[in]      affinity          Affinity of the participants
+     */
+    explicit TreeBarrier(std::vector<ThreadAffinity> const& affinity);
+
+    /**
+     * @brief          TreeBarrier
+     *
+     * @details        Participants of unknown placement, combined in flat
+     * groups.
+     *
+     * @param[in]      participants      Number of participants
+     */
+    explicit TreeBarrier(size_t participants);
+
+    ~TreeBarrier();
+
+    TreeBarrier(const TreeBarrier&)            = delete;
+    TreeBarrier& operator=(const TreeBarrier&) = delete;
+
+    /**
+     * @brief          size
+     *
+     * @return         Number of participants
+     */
+    size_t size() const;
+
+    /**
+     * @brief          depth
+     *
+     * @return         Meeting points on the longest path of a participant
+     */
+    size_t depth() const;
+
+    /**
+     * @brief          arriveAndWait
+     *
+     * @details        Returns once every participant has arrived.
+     *
+     * @param[in]      participant       Index of the caller, below size()
+     */
+    void arriveAndWait(size_t participant);
+
+    /**
+     * @brief          reduce
+     *
+     * @details        Arrives with a value and waits for the others. Values
+     * are combined in the same order on every round, so every participant gets
+     * the same, reproducible, result.
+     *
+     * @param[in]      participant       Index of the caller, below size()
+     *
+     * @param[in]      value             Value of the caller
+     *
+     * @param[in]      op                Reduction, the same for every
+     * participant of a round
+     *
+     * @return         The reduction of the values of the round
+     */
+    double reduce(size_t participant, double value, ReduceOp op);
+
+    /**
+     * @brief          reduce
+     *
+     * @details        Integer reduction, see reduce(size_t, double, ReduceOp).
+     * Sums wrap around.
+     */
+    Int64 reduce(size_t participant, Int64 value, ReduceOp op);
+
+  private:
+    std::unique_ptr<CombiningTree> m_tree;
+};
+} // namespace Au
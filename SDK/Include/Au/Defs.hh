@@ -70,6 +70,19 @@
 #endif
 #endif
 
+/**
+ * @brief AUD_PRINTF_FORMAT() macro
+ *        Lets the compiler check printf style arguments, fmtIndex is the
+ *        1-based position of the format string, argIndex the one of the first
+ *        variadic argument or 0 for a va_list.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define AUD_PRINTF_FORMAT(fmtIndex, argIndex)                                  \
+    __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define AUD_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
+
 /**
  * dllexport helps to explicitly export symbols on Windows.
  * Therefore, any new API's must first be declared with ALCP_API_EXPORT to load
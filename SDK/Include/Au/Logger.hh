@@ -28,15 +28,13 @@
 
 #pragma once
 
-#include <ctime>
-#include <fstream>
+#include <atomic>
 #include <iomanip> // for std::hex
-#include <iostream>
 #include <sstream>
 #include <string>
 
 #include "Au/Config.h"
-#include "Au/Logger.hh"
+#include "Au/Logger/LogWriter.hh"
 #include "Au/Types.hh"
 
 namespace Au {
@@ -49,108 +47,77 @@ enum class LogLevel
     CRITICAL
 };
 
-class Logger
+namespace Logger {
+
+/**
+ * @brief Variadic logger used for the CPUID debug output.
+ *
+ * Messages are formatted on the calling thread and handed to the LogWriter,
+ * which timestamps, filters and writes them from the logging thread like any
+ * other message.
+ */
+class LegacyLogger
 {
   private:
-    LogLevel m_logLevel;
-    bool     m_logToFile;
-    Logger(LogLevel level = LogLevel::CRITICAL, bool logToFile = false)
-        : m_logLevel{ level }
-        , m_logToFile{ logToFile }
-    {
-        if (level < LogLevel::CRITICAL) {
-            m_logLevel = level;
-            return;
-        }
-        if (AU_BUILD_TYPE_RELEASE)
-            m_logLevel = LogLevel::CRITICAL;
-        else if (AU_BUILD_TYPE_DEBUG)
-            m_logLevel = LogLevel::INFO;
-        else if (AU_BUILD_TYPE_DEVELOPER)
-            m_logLevel = LogLevel::DEBUG;
-    }
-
-    /**
-     * @brief Append variables to the message
-     * @param stream The stringstream to append to
-     * @param value The value to append
-     * @param args The rest of the values to append
-     *
-     * @return void
-     */
-    template<typename T, typename... Args>
-    void appendVariables(std::stringstream& stream, T&& value, Args&&... args)
-    {
-        stream << " " << value;
-        appendVariables(stream, std::forward<Args>(args)...);
-    }
+    std::atomic<LogLevel> m_logLevel;
+    std::atomic<bool>     m_logToFile; ///< cpuidlog.txt may be installed
 
-    /**
-     * @brief Append variables to the message, The terminal condition for
-     * appendVariables recursion
-     * @param stream The stringstream to append to
-     *
-     * @return void
-     */
-    void appendVariables(std::stringstream& stream) {}
+    LegacyLogger(LogLevel level = LogLevel::CRITICAL);
 
     /**
-     * @brief Write the message to the log file
-     * @param message The message to write
+     * @brief Map a legacy level onto the LogWriter priority levels
+     * @param level The legacy log level
      *
-     * @return void
+     * @return The matching Priority::PriorityLevel
      */
-    void writeToLogFile(const String& message)
-    {
-        std::ofstream logFile;
-        logFile.open("cpuidlog.txt", std::ios_base::app);
-        if (logFile.is_open()) {
-            logFile << message << std::endl;
-        }
-    }
+    static Priority::PriorityLevel toPriority(LogLevel level);
 
     /**
-     * @brief Write the message to the console
-     * @param message The message to write
+     * @brief Hand a formatted message to the LogWriter
+     * @param level The log level
+     * @param text The formatted message
      *
      * @return void
      */
-    void writeToConsole(const String& message)
-    {
-        std::cout << message << std::endl;
-    }
+    void submit(LogLevel level, const String& text);
 
   public:
-    Logger(Logger const&)         = delete;
-    void operator=(Logger const&) = delete;
+    LegacyLogger(LegacyLogger const&)   = delete;
+    void operator=(LegacyLogger const&) = delete;
 
     /**
      * @brief Get the logger instance
      * @return The logger instance
      */
-    static Logger& getInstance()
-    {
-        static Logger instance;
-        return instance;
-    }
+    static LegacyLogger& getInstance();
 
     /**
      * @brief Set the log level
      * @param level The log level
-     * @param logToFile If true, log to file
+     * @param logToFile If true, also log to cpuidlog.txt. The file is added
+     * next to the LogWriter's current logger and only gets the messages of
+     * this logger, false removes it again.
      * @return void
      */
-    void setLevel(LogLevel level, bool logToFile = false)
+    void setLevel(LogLevel level, bool logToFile = false);
+
+    /**
+     * @brief Check whether messages of a level are logged
+     * @param level The log level
+     *
+     * @return true if both this logger and the LogWriter accept the level
+     */
+    bool isEnabled(LogLevel level) const
     {
-        this->m_logLevel  = level;
-        this->m_logToFile = logToFile;
+        return level >= m_logLevel.load(std::memory_order_relaxed)
+               && LogWriter::isEnabled(toPriority(level));
     }
 
     /**
      * @brief Log a message
      * @param level The log level
      * @param message The message to log
-     * @param args The arguments to log
+     * @param args The arguments to log, each preceded by a space
      * std::hex can be used to print variables in hex format
      * Example usage: log(LogLevel::DEBUG, "Value is: ", std::hex, value);
      *
@@ -159,43 +126,29 @@ class Logger
     template<typename... Args>
     void log(LogLevel level, const String& message, Args&&... args)
     {
-        if (level < m_logLevel)
+        if (!isEnabled(level))
             return;
-        String logLevelStr;
-        switch (level) {
-            case LogLevel::DEBUG:
-                logLevelStr = "[DEBUG]";
-                break;
-            case LogLevel::INFO:
-                logLevelStr = "[INFO]";
-                break;
-            case LogLevel::WARNING:
-                logLevelStr = "[WARNING]";
-                break;
-            case LogLevel::ERROR:
-                logLevelStr = "[ERROR]";
-                break;
-            case LogLevel::CRITICAL:
-                logLevelStr = "[CRITICAL]";
-                break;
-        }
-
-        std::time_t now       = std::time(nullptr);
-        String timestamp = std::asctime(std::localtime(&now));
-        timestamp =
-            timestamp.substr(0, timestamp.length() - 1); // Remove newline
 
         std::stringstream logMessageStream;
-        logMessageStream << timestamp << " " << logLevelStr << " " << message;
-        appendVariables(logMessageStream, std::forward<Args>(args)...);
-
-        String logMessage = logMessageStream.str();
-        if (m_logToFile)
-            writeToLogFile(logMessage);
-        writeToConsole(logMessage);
+        logMessageStream << message;
+        ((logMessageStream << " " << std::forward<Args>(args)), ...);
+        submit(level, logMessageStream.str());
     }
 };
 
+/**
+ * @brief Get the legacy logger instance, keeps
+ * Au::Logger::getInstance().log(...) call sites working
+ * @return The logger instance
+ */
+inline LegacyLogger&
+getInstance()
+{
+    return LegacyLogger::getInstance();
+}
+
+} // namespace Logger
+
 // Overload << operator for std::ostream to print variables in hex format
 template<typename T, class = enableIf<std::is_integral<T>>>
 std::ostream&
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2024, Advanced Micro Devices. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+#include "Au/Logger/Message.hh"
+
+#include <functional>
+
+namespace Au::Logger {
+
+/**
+ * @class LogSite
+ * @brief Per call site state behind the sampling and rate limiting macros.
+ *
+ * Each AU_LOGGER_LOG_EVERY_N / AU_LOGGER_LOG_RATE_LIMITED statement owns a
+ * function-local static LogSite. Deciding whether to log is a couple of
+ * relaxed atomic operations, no lock is taken. Sites register themselves in
+ * a lock-free list on first use so that the logging thread can periodically
+ * report how many messages each of them suppressed.
+ */
+class LogSite
+{
+  private:
+    const char*             m_file;
+    int                     m_line;
+    Priority::PriorityLevel m_level;
+    std::atomic<Uint64>     m_calls;       ///< Calls seen by sampleEveryN()
+    std::atomic<Uint64>     m_windowStart; ///< Rate window start, steady ns
+    std::atomic<Uint64>     m_windowCount; ///< Calls in the current window
+    std::atomic<Uint64>     m_suppressed;  ///< Not logged since last summary
+    LogSite*                m_next;        ///< Next registered site
+
+    static std::atomic<LogSite*> s_head;
+
+  public:
+    /**
+     * @brief Registers the call site.
+     * @param file Source file of the statement.
+     * @param line Source line of the statement.
+     * @param level Level the summaries are logged at.
+     */
+    LogSite(const char* file, int line, Priority::PriorityLevel level);
+
+    LogSite(const LogSite&)            = delete;
+    LogSite& operator=(const LogSite&) = delete;
+
+    /**
+     * @brief Lets the first of every n calls through.
+     * @param n Sampling period, 0 and 1 log every call.
+     * @return true if this call should be logged.
+     */
+    bool sampleEveryN(Uint64 n)
+    {
+        if (m_calls.fetch_add(1, std::memory_order_relaxed) % (n ? n : 1)
+            == 0) {
+            return true;
+        }
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Lets at most perSecond calls through in every one second window.
+     * @param perSecond Calls logged per window.
+     * @return true if this call should be logged.
+     */
+    bool allowRate(Uint64 perSecond);
+
+    /**
+     * @brief Get and reset the number of suppressed calls.
+     */
+    Uint64 takeSuppressed()
+    {
+        return m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Builds a summary message for every site which suppressed calls
+     * since the last report, e.g. "file.cc:42: suppressed 1234 messages".
+     * @param emit Called with each summary.
+     */
+    static void reportSuppressed(const std::function<void(Message&)>& emit);
+};
+
+} // namespace Au::Logger
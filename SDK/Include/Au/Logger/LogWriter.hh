@@ -27,25 +27,97 @@
  */
 
 #pragma once
+#include "Au/Defs.hh"
 #include "Au/Logger/Logger.hh"
 #include "Au/Logger/Queue.hh"
 
+#include <condition_variable>
+
 namespace Au::Logger {
 
+/**
+ * @class ThreadPlacement
+ * @brief Where the logging thread runs and how the scheduler treats it.
+ *
+ * Keeping the logging thread off the cores running compute threads avoids
+ * the scheduler migrating it there and causing jitter. Placement is only
+ * supported on Linux and is ignored elsewhere.
+ */
+class ThreadPlacement
+{
+  public:
+    enum class Affinity : Uint8
+    {
+        eNone,        ///< Keep the affinity inherited from start()
+        eCpus,        ///< Run on the CPUs in m_cpus
+        eLastCore,    ///< Run on the last core of a package, see m_cpus
+        eSmtSiblings, ///< Run on the SMT siblings of the CPUs in m_cpus
+    };
+
+    enum class Scheduling : Uint8
+    {
+        eDefault, ///< Inherit the policy of the thread calling start()
+        eNice,    ///< Lower the priority to m_nice
+        eIdle,    ///< SCHED_IDLE, only runs when the CPU is otherwise idle
+    };
+
+    Affinity m_affinity{ Affinity::eNone };
+    /// Target or housekeeping CPUs. For eLastCore, a CPU of the package,
+    /// empty for the package the logging thread is running on.
+    std::vector<int> m_cpus{};
+    Scheduling       m_scheduling{ Scheduling::eDefault };
+    int              m_nice{ 19 }; ///< Nice value for Scheduling::eNice
+};
+
 /**
  * @class LogWriter
  * @brief Manages the logging thread and writes messages through a chosen
  * logger.
+ *
+ * Every producer thread pushes into its own lock-free SPSC ring, registered
+ * on first use. The logging thread polls the rings round-robin and merges the
+ * collected messages by timestamp before writing them.
+ *
+ * Lifecycle: the singleton is started on first use and drained when the
+ * process exits; messages logged after that are written synchronously. On
+ * Linux the logging thread is paused across fork() and restarted in both
+ * the parent and the child, so asynchronous logging keeps working in
+ * preforking servers. Loggers running threads of their own (asynchronous
+ * CompositeLogger sinks, RotatingFileLogger post-processing) stop and
+ * restart them through the ILogger fork hooks.
  */
 class LogWriter
 {
+  public:
+    /// State of a LogWriter instance
+    enum class State : Uint8
+    {
+        eIdle,     ///< Logging thread not started, or paused around fork()
+        eRunning,  ///< Logging thread collecting messages
+        eStopping, ///< Logging thread draining before it exits
+        eClosed,   ///< Shut down, messages are written synchronously
+    };
+
   private:
     std::thread              m_thread; ///< Thread for logging
     std::unique_ptr<ILogger> m_logger; ///< Logger instance
-    std::atomic<bool> m_running; ///< Atomic boolean to control running state
-    LockingQueue      m_queue;   ///< Queue for log messages
+    std::atomic<State>       m_state;  ///< Changed under m_lifecycleMutex
+    std::mutex        m_lifecycleMutex; ///< Serializes start/stop, late writes
+    LockingQueue      m_queue;          ///< Overflow for full producer rings
+    std::mutex              m_waitMutex; ///< Mutex guarding idle waits
+    std::condition_variable m_waitCond;  ///< Wakes the idle logging thread
+    std::atomic<bool> m_placementChanged; ///< Thread must reapply s_placement
     static std::mutex instanceMutex; ///< Mutex for singleton instance
     static std::shared_ptr<LogWriter> instance; ///< Singleton instance
+    static std::atomic<Uint32>
+        s_levelMask; ///< Bitmask of enabled Priority::PriorityLevel values
+    static size_t                  s_queueCapacity;  ///< Overflow queue bound
+    static OverflowPolicy          s_overflowPolicy; ///< Applied when full
+    static Priority::PriorityLevel s_overflowThreshold; ///< For drop-below
+    static std::atomic<Uint64>     s_dropped; ///< Drops by past instances
+    static std::atomic<Uint64>     s_blocked; ///< Waits by past instances
+    static std::mutex              s_placementMutex; ///< Guards s_placement
+    static ThreadPlacement         s_placement; ///< For the logging thread
 
     /**
      * @brief Main function executed by the logging thread to process queued
@@ -53,6 +125,42 @@ class LogWriter
      */
     void loggerThread();
 
+    /**
+     * @brief Hands a pooled record to the calling thread's ring.
+     */
+    void submit(Message* rec);
+
+    /**
+     * @brief Applies s_placement to the calling (logging) thread.
+     */
+    static void applyPlacement();
+
+    /**
+     * @brief Lets the logging thread drain the rings and exit, then flushes
+     * the logger. Called with m_lifecycleMutex held.
+     */
+    void stopThread();
+
+    /**
+     * @brief Drains the queue, joins the logging thread and flushes the
+     * logger without touching the singleton instance.
+     */
+    void shutdown();
+
+    /**
+     * @brief pthread_atfork() handlers, pausing the logging thread across
+     * fork() and restarting it in the parent and in the child.
+     */
+    static void forkPrepare();
+    static void forkParent();
+    static void forkChild();
+
+    /**
+     * @brief atexit() handler draining the singleton before other static
+     * objects used by the loggers are destroyed.
+     */
+    static void drainAtExit();
+
     /**
      * @brief Private constructor for singleton pattern.
      */
@@ -74,26 +182,165 @@ class LogWriter
      */
     static std::shared_ptr<LogWriter> getLogWriter();
 
+    /**
+     * @brief Get the singleton for a log call without taking any lock.
+     *
+     * Every thread keeps a reference to the singleton and reuses it while it
+     * is running, getLogWriter() is only called to start or replace it. Used
+     * by the AU_LOGGER_LOG macros.
+     * @return The singleton, kept alive until the calling thread calls this
+     * again or exits.
+     */
+    static LogWriter& current();
+
     /**
      * @brief Specifies the ILogger implementation to use for output.
+     *
+     * Like replaceLogger(), the logging thread is paused while the loggers
+     * are swapped and the current logger writes the pending messages.
      * @param logger A unique pointer to an ILogger-derived object.
      */
     static void setLogger(std::unique_ptr<ILogger> logger);
 
     /**
-     * @brief Starts the dedicated logging thread.
+     * @brief Replaces the logger with one built from the current logger, for
+     * example a wrapper adding an output to it.
+     *
+     * The logging thread is paused while the loggers are swapped, messages
+     * pending before the call are written by the current logger.
+     * @param replace Takes the current logger and returns its replacement,
+     * which must not be null.
+     */
+    static void replaceLogger(
+        const std::function<std::unique_ptr<ILogger>(std::unique_ptr<ILogger>)>&
+            replace);
+
+    /**
+     * @brief Enables every level at least as severe as the given one.
+     *
+     * Messages with a less severe level are dropped at the call site by the
+     * AU_LOGGER_LOG macros before any Message is built.
+     * @param level Least severe level that is still logged.
+     */
+    static void setLevel(Priority::PriorityLevel level);
+
+    /**
+     * @brief Enables exactly the levels whose bits are set in the mask.
+     * @param mask Bitwise OR of Priority::PriorityLevel values.
+     */
+    static void setLevelMask(Uint32 mask);
+
+    /**
+     * @brief Get the mask of currently enabled levels.
+     * @return Bitwise OR of enabled Priority::PriorityLevel values.
+     */
+    static Uint32 getLevelMask();
+
+    /**
+     * @brief Checks the runtime threshold for a level.
+     * @param level Level of the message about to be logged.
+     * @return true if messages of this level should be logged.
+     */
+    static bool isEnabled(Priority::PriorityLevel level)
+    {
+        return (s_levelMask.load(std::memory_order_relaxed)
+                & static_cast<Uint32>(level))
+               != 0;
+    }
+
+    /**
+     * @brief Bounds the queue behind the per-thread rings.
+     *
+     * A producer whose ring is full spills into a shared queue; with a
+     * capacity set, a full queue applies the given policy instead of growing.
+     * Memory is then bounded by the ring size per thread plus the capacity.
+     * The setting outlives stop() and applies to later instances.
+     * @param policy What to do with a message which does not fit.
+     * @param capacity Maximum number of queued messages, 0 for unbounded.
+     * @param threshold Least severe level kept by
+     * OverflowPolicy::eDropBelowPriority.
+     */
+    static void setOverflowPolicy(OverflowPolicy          policy,
+                                  size_t                  capacity,
+                                  Priority::PriorityLevel threshold =
+                                      Priority::PriorityLevel::eWarning);
+
+    /**
+     * @brief Get the number of messages dropped by the overflow policy since
+     * the process started.
+     */
+    static Uint64 getDroppedCount();
+
+    /**
+     * @brief Get the number of log calls which waited for room in the queue
+     * since the process started.
+     */
+    static Uint64 getBlockedCount();
+
+    /**
+     * @brief Sets where the logging thread runs and its scheduling class.
+     *
+     * A running logging thread applies it before writing its next batch,
+     * later instances apply it on start. The default placement restores the
+     * affinity, policy and nice value the thread started with. Failures are
+     * reported on stderr and leave the thread where it was.
+     * @param placement Affinity and scheduling of the logging thread.
+     */
+    static void setPlacement(const ThreadPlacement& placement);
+
+    /**
+     * @brief Get the placement set with setPlacement().
+     */
+    static ThreadPlacement getPlacement();
+
+    /**
+     * @brief Starts the dedicated logging thread, unless it is running or the
+     * instance is closed.
      */
     void start();
 
     /**
-     * @brief Signals the logging thread to stop and waits for it to finish.
+     * @brief Drains and stops the logging thread and closes the instance.
+     *
+     * The singleton is released, the next getLogWriter() creates a new
+     * instance. Callers still holding this one can log to it; their
+     * messages are written synchronously.
      */
     void stop();
 
     /**
-     * @brief Sends a batch of messages to the logging queue.
+     * @brief Get the lifecycle state of this instance.
+     */
+    State getState() const;
+
+    /**
+     * @brief Sends a batch of messages to the calling thread's ring.
      * @param msgs A vector of log messages to enqueue.
      */
     void log(std::vector<Message>& msgs);
+
+    /**
+     * @brief Sends a single message to the calling thread's ring.
+     * @param msg The log message to enqueue.
+     */
+    void log(const Message& msg);
+
+    /**
+     * @brief Formats a message printf style and sends it to the calling
+     * thread's ring.
+     *
+     * Nothing is formatted when the level is disabled, otherwise the text is
+     * formatted straight into a pooled record without a temporary string.
+     * @param level Level of the message.
+     * @param fmt printf format string.
+     * @param args Arguments for fmt.
+     */
+    void vlogf(Priority::PriorityLevel level, const char* fmt, va_list args);
+
+    /**
+     * @brief Variadic form of vlogf().
+     */
+    void logf(Priority::PriorityLevel level, const char* fmt, ...)
+        AUD_PRINTF_FORMAT(3, 4);
 };
 } // namespace Au::Logger
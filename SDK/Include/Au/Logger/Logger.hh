@@ -28,6 +28,11 @@
 
 #pragma once
 #include "Au/Logger/Message.hh"
+#include "Au/Logger/Queue.hh"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
 
 /**
  * @brief ISink class - Writes the message to the output
@@ -72,6 +77,27 @@ class ILogger
      */
     virtual String getLoggerType() const = 0;
 
+    /**
+     * @brief Called by LogWriter before fork(), with its logging thread
+     * paused. Loggers running threads of their own stop them here.
+     *
+     * The default flushes, so that buffered output is not written by both
+     * the parent and the child.
+     */
+    virtual void forkPrepare() { flush(); }
+
+    /**
+     * @brief Called by LogWriter in the parent after fork().
+     */
+    virtual void forkParent() {}
+
+    /**
+     * @brief Called by LogWriter in the child after fork(), where only the
+     * forking thread exists. Threads stopped by forkPrepare() are started
+     * again here.
+     */
+    virtual void forkChild() {}
+
     virtual ~ILogger() = default;
 };
 
@@ -147,6 +173,310 @@ class FileLogger : public GenericLogger
     ~FileLogger() override;
 };
 
+/**
+ * @class RotatingFileLogger
+ * @brief Writes log messages to a file which is rotated by size and age.
+ *
+ * When the active file exceeds maxBytes, or has been open longer than maxAge,
+ * it is renamed to "<filename>.<n>" and a fresh file is opened. Rotation only
+ * renames and reopens on the logging thread; closed segments are handed to a
+ * background thread which runs the optional post-processing hook (for example
+ * compression) and deletes the oldest segments beyond maxFiles. Segments left
+ * by earlier runs count towards maxFiles. If the active file cannot be opened,
+ * messages are dropped and the open is retried every cReopenInterval.
+ */
+class RotatingFileLogger : public GenericLogger
+{
+  public:
+    /**
+     * @brief Post-processing hook run on the background thread.
+     *
+     * Receives the path of a closed segment and returns the path of the
+     * resulting file (e.g. "<segment>.gz"), which is what retention deletes.
+     */
+    using PostProcessHook = std::function<String(const String& segment)>;
+
+    static constexpr Uint64 cDefaultMaxBytes = 64ULL << 20; ///< 64 MiB
+    static constexpr Uint32 cDefaultMaxFiles = 5;
+
+    /// Delay between attempts to open the active file after a failure
+    static constexpr std::chrono::seconds cReopenInterval{ 1 };
+
+  private:
+    String                                m_filename; ///< Active file path
+    Uint64                                m_maxBytes; ///< 0 disables
+    std::chrono::seconds                  m_maxAge;   ///< 0 disables
+    Uint32                                m_maxFiles; ///< Segments kept
+    PostProcessHook                       m_hook;     ///< May be empty
+    FILE*                                 m_file;     ///< Active file
+    Uint64                                m_bytes;    ///< Size of active file
+    std::chrono::steady_clock::time_point m_opened;   ///< Last open attempt
+    Uint64                                m_sequence; ///< Next segment number
+
+    std::mutex              m_workMutex; ///< Guards the members below
+    std::condition_variable m_workCond;  ///< Wakes the background thread
+    std::deque<String>      m_pending;   ///< Segments waiting for the hook
+    std::deque<String>      m_segments;  ///< Finished segments, oldest first
+    bool                    m_stopping;  ///< Background thread should exit
+    bool                    m_pausing;   ///< Exit, keeping m_pending
+    std::thread             m_worker;    ///< Post-processing thread
+
+    void open();
+    void rotate();
+    void adoptSegments();
+    void postProcessThread();
+
+  public:
+    /**
+     * @brief Constructor for RotatingFileLogger.
+     * @param filename Path of the active log file.
+     * @param maxBytes Rotate once the file reaches this size, 0 disables.
+     * @param maxAge Rotate once the file is this old, 0 disables.
+     * @param maxFiles Number of closed segments to keep.
+     * @param hook Optional post-processing hook for closed segments.
+     */
+    explicit RotatingFileLogger(
+        const String&        filename,
+        Uint64               maxBytes = cDefaultMaxBytes,
+        std::chrono::seconds maxAge   = std::chrono::seconds(0),
+        Uint32               maxFiles = cDefaultMaxFiles,
+        PostProcessHook      hook     = nullptr);
+
+    // Disable copy constructor and assignment operator
+    RotatingFileLogger(const RotatingFileLogger&)            = delete;
+    RotatingFileLogger& operator=(const RotatingFileLogger&) = delete;
+
+    void   write(const Message& msg) override;
+    void   flush() override;
+    String getLoggerType() const override;
+
+    /**
+     * @brief Blocks until every closed segment has been post-processed.
+     */
+    void waitForPostProcessing();
+
+    /// Stops the background thread around fork(), the child drops the
+    /// segments the parent still has to post-process
+    void forkPrepare() override;
+    void forkParent() override;
+    void forkChild() override;
+
+    ~RotatingFileLogger() override;
+};
+
+/**
+ * @class MmapRingLogger
+ * @brief Writes log messages into a fixed-size ring inside a memory-mapped
+ * file.
+ *
+ * Each record is a plain memory copy into a MAP_SHARED mapping followed by a
+ * release store of the head offset, there is no system call per record. The
+ * pages belong to the kernel page cache, so the most recent records survive a
+ * crash of the process and can be decoded afterwards with readRing(). Once the
+ * ring is full the oldest records are overwritten.
+ *
+ * A child process created with fork() must not write to the ring of its
+ * parent, it switches to a ring of its own named <filename>.<pid>.
+ *
+ * Only available on Linux, elsewhere the logger reports an error on
+ * construction and drops every message.
+ */
+class MmapRingLogger : public GenericLogger
+{
+  public:
+    static constexpr Uint64 cDefaultCapacity = 4ULL << 20; ///< 4 MiB
+
+    /**
+     * @brief A record decoded from a ring file.
+     */
+    struct Record
+    {
+        Uint64                  timestamp; ///< Nanoseconds since the epoch
+        Priority::PriorityLevel level;     ///< Level of the message
+        String                  text;      ///< Message text
+    };
+
+  private:
+    String         m_filename; ///< Backing file
+    Uint64         m_size;     ///< Size of the mapping
+    unsigned char* m_map;      ///< Start of the mapping, nullptr if unmapped
+
+    /**
+     * @brief Maps m_filename with m_size bytes, reusing a valid ring.
+     */
+    void mapRing();
+
+  public:
+    /**
+     * @brief Maps the ring file, creating or reinitializing it when needed.
+     *
+     * An existing ring with the same capacity is reused and appended to.
+     * @param filename Backing file of the ring.
+     * @param capacity Bytes available for records, rounded up to a power of
+     * two.
+     */
+    explicit MmapRingLogger(const String& filename,
+                            Uint64        capacity = cDefaultCapacity);
+
+    // Disable copy constructor and assignment operator
+    MmapRingLogger(const MmapRingLogger&)            = delete;
+    MmapRingLogger& operator=(const MmapRingLogger&) = delete;
+
+    void   write(const Message& msg) override;
+    void   flush() override;
+    String getLoggerType() const override;
+
+    /**
+     * @brief Get the ring file written to, <filename>.<pid> after fork().
+     */
+    String getFilename() const;
+
+    /// Unmaps the ring of the parent and maps <filename>.<pid> instead
+    void forkChild() override;
+
+    /**
+     * @brief Decodes the records of a ring file, oldest first.
+     *
+     * Reads the file with ordinary I/O, so it works on a ring left behind by
+     * a crashed process and on any platform.
+     * @param filename Ring file to decode.
+     * @return Records with their level and timestamp, empty if the file is
+     * not a valid ring.
+     */
+    static std::vector<Record> readRing(const String& filename);
+
+    ~MmapRingLogger() override;
+};
+
+/**
+ * @class CompositeLogger
+ * @brief Fans every message out to several loggers, each with its own set of
+ * enabled levels.
+ *
+ * An asynchronous sink gets a bounded queue and a worker thread of its own,
+ * so a slow sink (a network share, a full disk) only delays or drops its own
+ * messages and never stalls the logging thread or the other sinks. A
+ * synchronous sink is written directly on the logging thread, which suits
+ * cheap sinks such as MmapRingLogger.
+ */
+class CompositeLogger : public GenericLogger
+{
+  public:
+    static constexpr size_t cDefaultQueueCapacity = 8192;
+
+  private:
+    class Sink;
+    std::vector<std::unique_ptr<Sink>> m_sinks; ///< Sinks in insertion order
+
+  public:
+    CompositeLogger();
+
+    // Disable copy constructor and assignment operator
+    CompositeLogger(const CompositeLogger&)            = delete;
+    CompositeLogger& operator=(const CompositeLogger&) = delete;
+
+    /**
+     * @brief Adds a sink, must be called before the composite is in use.
+     * @param logger Logger receiving the messages.
+     * @param levelMask Bitwise OR of the Priority::PriorityLevel values the
+     * sink receives, see Priority::maskUpTo().
+     * @param async Give the sink its own queue and worker thread.
+     * @param queueCapacity Bound of the sink queue, 0 for unbounded.
+     * @param policy What an async sink does with messages which do not fit.
+     */
+    void addLogger(std::unique_ptr<ILogger> logger,
+                   Uint32                   levelMask = ~0U,
+                   bool                     async     = true,
+                   size_t         queueCapacity = cDefaultQueueCapacity,
+                   OverflowPolicy policy        = OverflowPolicy::eDropNewest);
+
+    /**
+     * @brief Get the number of sinks.
+     */
+    size_t getLoggerCount() const;
+
+    /**
+     * @brief Get a sink.
+     * @param index Position in the order the sinks were added.
+     */
+    ILogger& getLogger(size_t index);
+
+    /**
+     * @brief Get the number of messages a sink dropped because its queue was
+     * full.
+     * @param index Position in the order the sinks were added.
+     */
+    Uint64 getDroppedCount(size_t index) const;
+
+    void   write(const Message& msg) override;
+    String getLoggerType() const override;
+
+    /**
+     * @brief Waits until every async sink has written its queue, then
+     * flushes all sinks.
+     */
+    void flush() override;
+
+    /// Stops the sink workers around fork() and forwards to every sink. The
+    /// child drops the messages the parent still has to write.
+    void forkPrepare() override;
+    void forkParent() override;
+    void forkChild() override;
+
+    ~CompositeLogger() override;
+};
+
+/**
+ * @class JsonLogger
+ * @brief Writes one JSON object per message (JSON lines).
+ *
+ * Each line holds the timestamp in nanoseconds, the level, the text and every
+ * field attached with Message::addField(), e.g.
+ * {"ts":1725266496000000000,"level":"Info","msg":"done","rows":42}
+ *
+ * A line is formatted into a buffer reused across messages and written with
+ * a single fwrite(), so steady state logging does not allocate.
+ */
+class JsonLogger : public GenericLogger
+{
+  private:
+    String m_filename; ///< Filename to write logs, empty for stdout
+    FILE*  m_file;     ///< File pointer
+    String m_buffer;   ///< Line being formatted, reused across messages
+
+  public:
+    /**
+     * @brief Constructor for JsonLogger.
+     * @param filename The file to which logs should be written, "" or "-"
+     * for stdout.
+     */
+    explicit JsonLogger(const String& filename);
+
+    // Disable copy constructor and assignment operator
+    JsonLogger(const JsonLogger&)            = delete;
+    JsonLogger& operator=(const JsonLogger&) = delete;
+
+    /**
+     * @brief Appends the JSON line for a message, newline included.
+     * @param msg Message to format.
+     * @param out String the line is appended to.
+     */
+    static void formatJson(const Message& msg, String& out);
+
+    /**
+     * @brief Appends text escaped for use inside a JSON string.
+     * @param out String the escaped text is appended to.
+     * @param text Text to escape.
+     */
+    static void appendEscaped(String& out, std::string_view text);
+
+    void   write(const Message& msg) override;
+    void   flush() override;
+    String getLoggerType() const override;
+
+    ~JsonLogger() override;
+};
+
 /**
  * @class LoggerFactory
  * @brief Provides methods to create and configure logger instances.
@@ -155,6 +485,12 @@ class FileLogger : public GenericLogger
  * - "ConsoleLogger": Logs to console.
  * - "DummyLogger": Disables logging (no-op).
  * - "FileLogger": Logs to a file, specify filename as loggerName argument.
+ * - "RotatingFileLogger": Logs to a file rotated with the default limits,
+ *   specify filename as loggerName argument.
+ * - "MmapRingLogger": Logs to a crash-surviving memory-mapped ring, specify
+ *   filename as loggerName argument.
+ * - "JsonLogger": Logs JSON lines to a file, specify filename as loggerName
+ *   argument ("" or "-" for stdout).
  */
 class LoggerFactory
 {
@@ -162,7 +498,8 @@ class LoggerFactory
     /**
      * @brief Create a logger.
      * @param loggerType Type of the logger (e.g., "ConsoleLogger",
-     * "DummyLogger", "FileLogger").
+     * "DummyLogger", "FileLogger", "RotatingFileLogger", "MmapRingLogger",
+     * "JsonLogger").
      * @param loggerName Logger name or filename, depending on the logger type.
      * @return Unique pointer to ILogger instance or nullptr if invalid
      * loggerType.
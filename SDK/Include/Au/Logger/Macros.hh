@@ -29,21 +29,96 @@
 #pragma once
 
 #include "Au/Logger/LogManager.hh"
+#include "Au/Logger/LogSite.hh"
 
 using Au::Logger::LogManager;
+using Au::Logger::LogSite;
 using Au::Logger::LogWriter;
 using Au::Logger::Message;
 using Au::Logger::Priority;
 
-#define AU_LOGGER_LOG(msg, level)                                              \
-    {                                                                          \
-        Priority   priority(Priority::PriorityLevel::level);                   \
-        Message    message(std::string(msg), priority);                        \
-        LogManager logger = LogManager(LogWriter::getLogWriter());             \
-        logger << message;                                                     \
-        logger.flush();                                                        \
-        LogWriter::getLogWriter()->stop();                                     \
-    }
+// Bit values of Priority::PriorityLevel, usable in preprocessor expressions
+#define AU_LOGGER_LEVEL_FATAL   (1 << 0)
+#define AU_LOGGER_LEVEL_PANIC   (1 << 1)
+#define AU_LOGGER_LEVEL_ERROR   (1 << 2)
+#define AU_LOGGER_LEVEL_WARNING (1 << 3)
+#define AU_LOGGER_LEVEL_NOTICE  (1 << 4)
+#define AU_LOGGER_LEVEL_INFO    (1 << 5)
+#define AU_LOGGER_LEVEL_DEBUG   (1 << 6)
+#define AU_LOGGER_LEVEL_TRACE   (1 << 7)
+
+/*
+ * Least severe level compiled into the binary. Log statements below it
+ * generate no code, e.g. -DAU_LOGGER_MIN_LEVEL=AU_LOGGER_LEVEL_WARNING keeps
+ * only Warning and more severe messages.
+ */
+static_assert(AU_LOGGER_LEVEL_TRACE
+                  == static_cast<int>(Priority::PriorityLevel::eTrace),
+              "AU_LOGGER_LEVEL_* must match Priority::PriorityLevel");
+
+#ifndef AU_LOGGER_MIN_LEVEL
+#define AU_LOGGER_MIN_LEVEL AU_LOGGER_LEVEL_TRACE
+#endif
+
+#define AU_LOGGER_LEVEL_COMPILED_IN(level)                                     \
+    (static_cast<unsigned>(Priority::PriorityLevel::level)                     \
+     <= static_cast<unsigned>(AU_LOGGER_MIN_LEVEL))
+
+/*
+ * Checks the compile time and then the runtime threshold before anything is
+ * built, the message is enqueued to the LogWriter thread which is started on
+ * first use and drained when the process exits. A running LogWriter is
+ * reached through LogWriter::current(), without any lock.
+ */
+#define AU_LOGGER_LOG(msg, level) AU_LOGGER_LOG_IF(msg, level, true)
+
+/*
+ * Like AU_LOGGER_LOG, 'cond' is only evaluated once both level thresholds
+ * pass. 'site' names a function-local static LogSite declared for the
+ * statement, so the condition can use per call site state.
+ */
+#define AU_LOGGER_LOG_SITE_IF(msg, level, site, cond)                          \
+    do {                                                                       \
+        if constexpr (AU_LOGGER_LEVEL_COMPILED_IN(level)) {                    \
+            if (LogWriter::isEnabled(Priority::PriorityLevel::level)) {        \
+                static LogSite site(                                           \
+                    __FILE__, __LINE__, Priority::PriorityLevel::level);       \
+                if (cond) {                                                    \
+                    Priority priority(Priority::PriorityLevel::level);         \
+                    LogWriter::current().log(                                  \
+                        Message(std::string_view(msg), priority));             \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+#define AU_LOGGER_LOG_IF(msg, level, cond)                                     \
+    do {                                                                       \
+        if constexpr (AU_LOGGER_LEVEL_COMPILED_IN(level)) {                    \
+            if (LogWriter::isEnabled(Priority::PriorityLevel::level)           \
+                && (cond)) {                                                   \
+                Priority priority(Priority::PriorityLevel::level);             \
+                LogWriter::current().log(                                      \
+                    Message(std::string_view(msg), priority));                 \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+
+/*
+ * Logs the first of every 'n' executions of this statement. Suppressed
+ * executions are counted per call site and summarised by the logging thread
+ * about once a second.
+ */
+#define AU_LOGGER_LOG_EVERY_N(msg, level, n)                                   \
+    AU_LOGGER_LOG_SITE_IF(msg, level, auLogSite, auLogSite.sampleEveryN(n))
+
+/*
+ * Logs at most 'perSecond' executions of this statement in every one second
+ * window, the rest are counted and summarised like AU_LOGGER_LOG_EVERY_N.
+ */
+#define AU_LOGGER_LOG_RATE_LIMITED(msg, level, perSecond)                      \
+    AU_LOGGER_LOG_SITE_IF(                                                     \
+        msg, level, auLogSite, auLogSite.allowRate(perSecond))
 
 #define AU_LOGGER_LOG_INFO(msg) AU_LOGGER_LOG(msg, eInfo)
 
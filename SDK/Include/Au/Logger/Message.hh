@@ -28,12 +28,15 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <map>
+#include <cstdarg>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "Au/Types.hh"
@@ -90,11 +93,74 @@ class Priority
         eTrace   = (1 << 7), /* Lowest priority */
     };
 
+    /// Level names indexed by the bit position of the level
+    static constexpr std::array<std::string_view, 8> cNames = {
+        "Fatal", "Panic", "Error", "Warning",
+        "Notice", "Info", "Debug", "Trace",
+    };
+
+    /// Names left aligned and padded to cLabelWidth, as used in log lines
+    static constexpr size_t                          cLabelWidth = 7;
+    static constexpr std::array<std::string_view, 8> cLabels     = {
+        "Fatal  ", "Panic  ", "Error  ", "Warning",
+        "Notice ", "Info   ", "Debug  ", "Trace  ",
+    };
+
     Priority();
     explicit Priority(PriorityLevel level);
 
+    /**
+     * @brief Get the level name as a new string.
+     * @return Name of the level, e.g. "Warning".
+     */
     String toStr() const;
 
+    /**
+     * @brief Get the level name without allocating.
+     * @return Name of the level, e.g. "Warning", or "Unknown".
+     */
+    std::string_view getName() const
+    {
+        size_t index = indexOf(m_level);
+        return index < cNames.size() ? cNames[index] : "Unknown";
+    }
+
+    /**
+     * @brief Get the level name padded to cLabelWidth without allocating.
+     * @return Padded name of the level, e.g. "Info   ", or "Unknown".
+     */
+    std::string_view getLabel() const
+    {
+        size_t index = indexOf(m_level);
+        return index < cLabels.size() ? cLabels[index] : "Unknown";
+    }
+
+    /**
+     * @brief Bit position of a level, which indexes cNames and cLabels.
+     */
+    static constexpr size_t indexOf(PriorityLevel level)
+    {
+        Uint32 bit   = static_cast<Uint32>(level);
+        size_t index = 0;
+        while (index < 32 && (bit & (1U << index)) == 0) {
+            index++;
+        }
+        return index;
+    }
+
+    /**
+     * @brief Get the severity level.
+     * @return Level of this priority.
+     */
+    PriorityLevel getLevel() const;
+
+    /**
+     * @brief Mask of every level at least as severe as the given one.
+     * @param level Least severe level included.
+     * @return Bitwise OR of PriorityLevel values.
+     */
+    static Uint32 maskUpTo(PriorityLevel level);
+
     // Operator overloads to compare the priority
     bool operator<(const Priority& rhs) const;
     bool operator>(const Priority& rhs) const;
@@ -103,47 +169,177 @@ class Priority
     bool operator==(const Priority& rhs) const;
     bool operator!=(const Priority& rhs) const;
 
-    static std::map<Priority::PriorityLevel, String>* getMap();
-
   private:
-    static std::unique_ptr<std::map<PriorityLevel, String>> m_str_map;
-    static std::once_flag                                   initFlag;
-
     PriorityLevel m_level;
 };
 
+/**
+ * @class MessageField
+ * @brief Read-only view of one typed key/value field of a Message.
+ *
+ * The key and string value point into the Message and are valid as long as
+ * it is not modified or destroyed.
+ */
+class MessageField
+{
+  public:
+    enum class Type : Uint8
+    {
+        eInt,
+        eUint,
+        eDouble,
+        eBool,
+        eString,
+    };
+
+    Type             m_type{ Type::eInt }; ///< Which value member is set
+    std::string_view m_key{};              ///< Field name
+    Int64            m_int{ 0 };           ///< Value for eInt
+    Uint64           m_uint{ 0 };          ///< Value for eUint
+    Float64          m_double{ 0 };        ///< Value for eDouble
+    bool             m_bool{ false };      ///< Value for eBool
+    std::string_view m_string{};           ///< Value for eString
+};
+
 // Class for message.
 /**
  * @class Message
  * @brief Encapsulates a log message with content, priority, and timestamp.
+ *
+ * The text and any key/value fields share one buffer. Up to cInlineCapacity
+ * bytes are stored inside the object, so building or copying a typical
+ * message does not allocate; larger messages spill to the heap.
  */
 class Message
 {
+  public:
+    /// Bytes stored without allocation, keeps a Message at 256 bytes on LP64
+    static constexpr size_t cInlineCapacity = 224;
+
   private:
-    String    m_msg;       ///< Log message
-    Priority  m_priority;  ///< Priority of the message
-    Timestamp m_timestamp; ///< Timestamp of the message
+    char                    m_inline[cInlineCapacity]; ///< Short messages
+    std::unique_ptr<char[]> m_heap;         ///< Buffer once m_inline is full
+    Uint32                  m_heapCapacity; ///< Size of m_heap
+    Uint32                  m_length;       ///< Text length in bytes
+    Uint32                  m_fieldBytes;   ///< Encoded fields after the text
+    Priority                m_priority;     ///< Priority of the message
+    Timestamp               m_timestamp;    ///< Timestamp of the message
+
+    char*       data() { return m_heap ? m_heap.get() : m_inline; }
+    const char* data() const { return m_heap ? m_heap.get() : m_inline; }
+
+    void     assign(std::string_view text);
+    void     copyFrom(const Message& other);
+    void     moveFrom(Message& other);
+    char*    grow(size_t bytes);
+    Message& appendField(MessageField::Type type,
+                         std::string_view   key,
+                         const void*        value,
+                         size_t             size);
 
   public:
     /**
      * @brief Constructor for Message.
      * @param msg Log message.
      */
-    explicit Message(const String& msg);
+    explicit Message(std::string_view msg);
 
     /**
      * @brief Constructor for Message with priority.
      * @param msg Log message.
      * @param priority Priority of the message.
      */
-    explicit Message(const String& msg, Priority& priority);
+    explicit Message(std::string_view msg, Priority& priority);
+
+    Message(const Message& other);
+    /// A moved-from message is left with empty text and no fields
+    Message(Message&& other) noexcept;
+    Message& operator=(const Message& other);
+    Message& operator=(Message&& other) noexcept;
+    ~Message() = default;
 
     /**
-     * @brief Get the log message.
+     * @brief Get the log message formatted with its timestamp and priority.
      * @return Log message.
      */
     String getMsg() const;
 
+    /**
+     * @brief Get the text of the message without any decoration.
+     * @return View of the text, valid as long as the Message.
+     */
+    std::string_view getText() const;
+
+    /**
+     * @brief Replaces the text with printf style formatted output, removing
+     * any fields.
+     *
+     * The output is written straight into the message buffer; only text
+     * longer than the inline capacity allocates.
+     * @param fmt printf format string.
+     * @param args Arguments for fmt.
+     */
+    void vformat(const char* fmt, va_list args);
+
+    /**
+     * @brief Attaches a typed key/value field.
+     *
+     * Integers, floating point numbers, bools and anything convertible to
+     * std::string_view are supported. The field is encoded into the message
+     * buffer, there is no allocation per field while it fits inline.
+     * @param key Field name, truncated to 255 bytes.
+     * @param value Field value.
+     * @return Reference to this Message for chaining.
+     */
+    template<typename T>
+    Message& addField(std::string_view key, const T& value)
+    {
+        using Type = MessageField::Type;
+        if constexpr (std::is_same_v<T, bool>) {
+            return appendField(Type::eBool, key, &value, 1);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            Int64 v = value;
+            return appendField(Type::eInt, key, &v, sizeof(v));
+        } else if constexpr (std::is_integral_v<T>) {
+            Uint64 v = value;
+            return appendField(Type::eUint, key, &v, sizeof(v));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            Float64 v = value;
+            return appendField(Type::eDouble, key, &v, sizeof(v));
+        } else {
+            static_assert(std::is_convertible_v<const T&, std::string_view>,
+                          "Unsupported field type");
+            std::string_view v = value;
+            return appendField(Type::eString, key, v.data(), v.size());
+        }
+    }
+
+    /**
+     * @brief Checks whether any field is attached.
+     */
+    bool hasFields() const { return m_fieldBytes != 0; }
+
+    /**
+     * @brief Decodes the field at 'offset' and advances it to the next one.
+     * @param offset Start with 0.
+     * @param field Receives the decoded field.
+     * @return false once every field has been read.
+     */
+    bool nextField(size_t& offset, MessageField& field) const;
+
+    /**
+     * @brief Calls fn(const MessageField&) for each field in insertion order.
+     */
+    template<typename Fn>
+    void forEachField(Fn&& fn) const
+    {
+        size_t       offset = 0;
+        MessageField field;
+        while (nextField(offset, field)) {
+            fn(field);
+        }
+    }
+
     /**
      * @brief Get the priority of the message.
      * @return Priority of the message.
@@ -28,14 +28,48 @@
 
 #pragma once
 #include "Au/Logger/Message.hh"
+#include <condition_variable>
 #include <deque>
+#include <new>
 namespace Au::Logger {
 
+/**
+ * @enum OverflowPolicy
+ * @brief What a bounded LockingQueue does with a message that does not fit.
+ */
+enum class OverflowPolicy
+{
+    eBlock,             ///< Wait until the consumer makes room
+    eDropNewest,        ///< Discard the incoming message
+    eDropOldest,        ///< Discard the oldest queued message
+    eDropBelowPriority, ///< Discard messages less severe than a threshold
+};
+
+/**
+ * @class LockingQueue
+ * @brief Mutex protected FIFO of messages, unbounded unless a capacity is
+ * set.
+ *
+ * When bounded, a full queue applies its OverflowPolicy and counts the
+ * messages it dropped and the enqueue calls it blocked.
+ */
 class LockingQueue
 {
   private:
-    std::mutex          m_mutex;
-    std::deque<Message> m_queue;
+    std::mutex              m_mutex;
+    std::condition_variable m_notFull;
+    std::deque<Message>     m_queue;
+    size_t                  m_capacity;  ///< 0 means unbounded
+    OverflowPolicy          m_policy;
+    Priority                m_threshold; ///< Used by eDropBelowPriority
+    bool                    m_closed;    ///< Producers no longer wait
+    std::atomic<Uint64>     m_dropped;
+    std::atomic<Uint64>     m_blocked;
+
+    bool full() const
+    {
+        return m_capacity != 0 && m_queue.size() >= m_capacity;
+    }
 
   public:
     LockingQueue();
@@ -44,14 +78,187 @@ class LockingQueue
     LockingQueue(const LockingQueue&)            = delete;
     LockingQueue& operator=(const LockingQueue&) = delete;
 
-    void    enqueue(const Message& msg);
+    /**
+     * @brief Bounds the queue and selects what happens when it is full.
+     *
+     * eDropBelowPriority discards an incoming message less severe than the
+     * threshold, or else evicts the oldest such queued message; if every
+     * queued message is at least as severe, the producer waits as with
+     * eBlock so important messages are never lost.
+     * @param capacity Maximum number of queued messages, 0 for unbounded.
+     * @param policy Overflow behaviour once capacity is reached.
+     * @param threshold Least severe level kept by eDropBelowPriority.
+     */
+    void configure(size_t                  capacity,
+                   OverflowPolicy          policy,
+                   Priority::PriorityLevel threshold =
+                       Priority::PriorityLevel::eWarning);
+
+    /**
+     * @brief Appends a message, applying the overflow policy when full.
+     * @param msg The message to enqueue.
+     * @return false if the message was dropped.
+     */
+    bool    enqueue(const Message& msg);
     Message dequeue();
     bool    empty();
     Uint64  getCount();
 
+    /**
+     * @brief Releases blocked producers for good, used when the consumer
+     * exits. Messages which still do not fit are dropped.
+     */
+    void close();
+
+    /**
+     * @brief Number of messages dropped by the overflow policy.
+     */
+    Uint64 getDropped() const;
+
+    /**
+     * @brief Number of enqueue calls which had to wait for room.
+     */
+    Uint64 getBlocked() const;
+
     ~LockingQueue() = default;
 };
 
+/**
+ * @class SpscRing
+ * @brief Bounded lock-free ring buffer for exactly one producer thread and one
+ * consumer thread.
+ *
+ * The capacity is rounded up to a power of two. The producer only stores to
+ * m_tail and the consumer only stores to m_head; each side keeps a cached copy
+ * of the other index on its own cache line so that the shared indices are only
+ * re-read when the ring looks full (or empty).
+ */
+template<typename T>
+class SpscRing
+{
+  private:
+    static constexpr size_t cCacheLine = 64;
+
+    struct Slot
+    {
+        alignas(T) unsigned char m_data[sizeof(T)];
+    };
+
+    const size_t            m_mask;  ///< capacity - 1
+    std::unique_ptr<Slot[]> m_slots; ///< Uninitialized element storage
+
+    alignas(cCacheLine) std::atomic<size_t> m_head; ///< Next slot to pop
+    size_t m_tailCache;                             ///< Consumer copy of m_tail
+
+    alignas(cCacheLine) std::atomic<size_t> m_tail; ///< Next slot to push
+    size_t m_headCache;                             ///< Producer copy of m_head
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    T* at(size_t index)
+    {
+        return std::launder(
+            reinterpret_cast<T*>(m_slots[index & m_mask].m_data));
+    }
+
+  public:
+    /**
+     * @brief Creates an empty ring.
+     * @param capacity Minimum number of elements the ring can hold.
+     */
+    explicit SpscRing(size_t capacity)
+        : m_mask{ roundUp(capacity) - 1 }
+        , m_slots{ new Slot[m_mask + 1] }
+        , m_head{ 0 }
+        , m_tailCache{ 0 }
+        , m_tail{ 0 }
+        , m_headCache{ 0 }
+    {
+    }
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+            at(i)->~T();
+    }
+
+    /**
+     * @brief Appends an element, producer side only.
+     * @param value Element to copy or move into the ring.
+     * @return false if the ring is full, the element is left untouched.
+     */
+    template<typename U>
+    bool tryPush(U&& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache > m_mask)
+                return false;
+        }
+        new (m_slots[tail & m_mask].m_data) T(std::forward<U>(value));
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element, consumer side only.
+     * @param out Receives the element.
+     * @return false if the ring is empty.
+     */
+    bool tryPop(T& out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+                return false;
+        }
+        T* elem = at(head);
+        out     = std::move(*elem);
+        elem->~T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Checks for pending elements, safe from either side.
+     * @return true if nothing is queued.
+     */
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire)
+               == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Number of elements currently queued, approximate while either
+     * side is active.
+     */
+    size_t size() const
+    {
+        // Read head first so that the difference can never underflow
+        size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @brief Maximum number of elements the ring can hold.
+     */
+    size_t capacity() const { return m_mask + 1; }
+};
+
 // Classes implementing no locking queue
 
 class NoLockQueueElement
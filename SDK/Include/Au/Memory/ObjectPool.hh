@@ -28,17 +28,170 @@
 
 #pragma once
 
+#include "Au/Types.hh"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Au::Memory {
+
 /**
- * FIXME:
- * https://howardhinnant.github.io/allocator_boilerplate.html
+ * @class ObjectPool
+ * @brief Fixed-capacity pool of preallocated objects, safe to use from any
+ * number of threads.
  *
- * https://github.com/TileDB-Inc/TileDB/blob/dev/tiledb/sm/misc/resource_pool.h
- *
- * NCBI implementation
- * https://www.ncbi.nlm.nih.gov/IEB/ToolBox/CPP_DOC/lxr/source/src/corelib/ncbimempool.cpp
+ * Free slots form a lock-free stack threaded through the slots themselves.
+ * The stack head packs a slot index with a version tag so that a slot which
+ * is popped and pushed back between another thread's load and
+ * compare-exchange (the ABA problem) is detected. When every slot is in use,
+ * acquire() falls back to the heap and release() gives such objects back to
+ * the heap, so the pool never fails but only allocates when it is exhausted.
  *
+ * @tparam Object Type of pooled objects.
  */
-
 template<class Object>
 class ObjectPool
-{};
+{
+  private:
+    struct Slot
+    {
+        alignas(Object) unsigned char m_storage[sizeof(Object)];
+        std::atomic<Uint32> m_next; ///< Index + 1 of next free slot, 0 ends
+    };
+
+    static constexpr Uint64 cIndexMask = 0xFFFFFFFFULL;
+
+    const Uint32            m_capacity;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<Uint64>     m_head;     ///< (tag << 32) | (index + 1)
+    std::atomic<Uint64>     m_fallback; ///< Heap allocations so far
+
+    Slot* pop()
+    {
+        Uint64 head = m_head.load(std::memory_order_acquire);
+        while ((head & cIndexMask) != 0) {
+            Slot*  slot = &m_slots[(head & cIndexMask) - 1];
+            Uint64 next = ((head >> 32) + 1) << 32
+                          | slot->m_next.load(std::memory_order_relaxed);
+            if (m_head.compare_exchange_weak(head,
+                                             next,
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire))
+                return slot;
+        }
+        return nullptr;
+    }
+
+    void push(Slot* slot)
+    {
+        Uint64 index = static_cast<Uint64>(slot - m_slots.get()) + 1;
+        Uint64 head  = m_head.load(std::memory_order_relaxed);
+        Uint64 next;
+        do {
+            slot->m_next.store(static_cast<Uint32>(head & cIndexMask),
+                               std::memory_order_relaxed);
+            next = ((head >> 32) + 1) << 32 | index;
+        } while (!m_head.compare_exchange_weak(head,
+                                               next,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+
+  public:
+    /**
+     * @brief Preallocates the slots, no Object is constructed yet.
+     * @param capacity Number of objects served without heap allocation.
+     */
+    explicit ObjectPool(Uint32 capacity)
+        : m_capacity{ capacity }
+        , m_slots{ new Slot[capacity] }
+        , m_head{ 0 }
+        , m_fallback{ 0 }
+    {
+        assert(capacity < cIndexMask);
+        // Chain the slots in order so that the first ones are used first
+        for (Uint32 i = 0; i < capacity; i++) {
+            m_slots[i].m_next.store(i + 1 < capacity ? i + 2 : 0,
+                                    std::memory_order_relaxed);
+        }
+        m_head.store(capacity ? 1 : 0, std::memory_order_release);
+    }
+
+    ObjectPool(const ObjectPool&)            = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Constructs an object in a free slot, or on the heap when the
+     * pool is exhausted.
+     * @param args Constructor arguments.
+     * @return Pointer to be handed back with release().
+     */
+    template<typename... Args>
+    Object* acquire(Args&&... args)
+    {
+        Slot* slot = pop();
+        if (slot == nullptr) {
+            m_fallback.fetch_add(1, std::memory_order_relaxed);
+            return new Object(std::forward<Args>(args)...);
+        }
+        try {
+            return new (slot->m_storage) Object(std::forward<Args>(args)...);
+        } catch (...) {
+            push(slot);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Destroys an object obtained from acquire() and recycles its slot.
+     * @param obj Object to release, nullptr is ignored.
+     */
+    void release(Object* obj)
+    {
+        if (obj == nullptr) {
+            return;
+        }
+        if (!owns(obj)) {
+            delete obj;
+            return;
+        }
+        auto offset = reinterpret_cast<const unsigned char*>(obj)
+                      - reinterpret_cast<const unsigned char*>(m_slots.get());
+        obj->~Object();
+        push(&m_slots[offset / sizeof(Slot)]);
+    }
+
+    /**
+     * @brief Checks whether an object lives in one of the pool's slots.
+     */
+    bool owns(const Object* obj) const
+    {
+        auto p     = reinterpret_cast<const unsigned char*>(obj);
+        auto begin = reinterpret_cast<const unsigned char*>(m_slots.get());
+        return p >= begin && p < begin + sizeof(Slot) * m_capacity;
+    }
+
+    /**
+     * @brief Number of objects served without heap allocation.
+     */
+    Uint32 capacity() const { return m_capacity; }
+
+    /**
+     * @brief Number of times acquire() had to fall back to the heap.
+     */
+    Uint64 getFallbackCount() const
+    {
+        return m_fallback.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Objects still acquired when the pool goes away are not
+     * destroyed, release them first.
+     */
+    ~ObjectPool() = default;
+};
+
+} // namespace Au::Memory
@@ -22,7 +22,9 @@
 
 #pragma once
 #include "Au/Config.h"
+#include "Au/Status.hh"
 #include <memory>
+#include <string>
 #include <vector>
 
 // Define DWORD
@@ -36,7 +38,25 @@ enum pinStrategy
 {
     SPREAD,
     CORE,
-    LOGICAL
+    LOGICAL,
+    NUMA_SPREAD,
+    NUMA_COMPACT
+};
+
+/**
+ * @brief          Requested and actual affinity of a pinned thread.
+ *
+ * @details        The actual affinity is read back from the operating system
+ * once the thread is pinned, so a pinning the kernel silently changed, for
+ * example because the processor went offline, shows up as well as an error
+ * returned when pinning.
+ */
+struct ThreadAffinity
+{
+    pthread_t        thread{};       ///< The pinned thread
+    int              requested = -1; ///< Processor the thread was pinned to
+    std::vector<int> actual{};       ///< Processors the thread may run on
+    Status           status{};       ///< Why the pinning failed, ok otherwise
 };
 
 class ThreadPinning
@@ -57,11 +77,17 @@ class ThreadPinning
      *        Pin the threads to the physical cores
      *  2 - Logical
      *        Processor Pin the threads to the logical processors
+     *  3 - NUMA Spread
+     *        Balance the threads across the NUMA nodes, then across the L3
+     * caches within each node, using physical cores before SMT siblings.
+     *  4 - NUMA Compact
+     *        Fill the physical cores of one NUMA node, L3 cache by L3 cache,
+     * before moving to the next node.
      *
      * @param[in]      threadList        ThreadIDs to pin
      *
      * @param[in]      pinStrategyIndex  0 - spread , 1 - Core, 2 - Logical
-     * Processor
+     * Processor, 3 - NUMA spread, 4 - NUMA compact
      *
      * @return         None
      */
@@ -99,6 +125,180 @@ class ThreadPinning
     void pinThreads(std::vector<pthread_t> const& threadList,
                     std::vector<int> const&       processPinGroup);
 
+    /**
+     * @brief          pinThreads
+     *
+     * @details        Pin Threads using a strategy and report, for every
+     * thread, the processor it was pinned to and the affinity read back from
+     * the operating system.
+     *
+     * @param[in]      threadList        ThreadIDs to pin
+     *
+     * @param[in]      pinStrategyIndex  0 - spread , 1 - Core, 2 - Logical
+     * Processor, 3 - NUMA spread, 4 - NUMA compact
+     *
+     * @param[out]     report            One entry per thread, in the order
+     * of threadList
+     *
+     * @return         The first error of the report, ok if every thread runs
+     * on the requested processor
+     */
+    Status pinThreads(std::vector<pthread_t> const& threadList,
+                      int                           pinStrategyIndex,
+                      std::vector<ThreadAffinity>&  report);
+
+    /**
+     * @brief          pinThreads
+     *
+     * @details        Pin Threads to a specific processor group and report the
+     * requested and actual affinity of every thread.
+     *
+     * @param[in]      threadList        ThreadIDs to pin
+     *
+     * @param[in]      processPinGroup   Processor Group to pin the threads
+     *
+     * @param[out]     report            One entry per thread, in the order
+     * of threadList
+     *
+     * @return         The first error of the report, ok if every thread runs
+     * on the requested processor
+     */
+    Status pinThreads(std::vector<pthread_t> const& threadList,
+                      std::vector<int> const&       processPinGroup,
+                      std::vector<ThreadAffinity>&  report);
+
+    /**
+     * @brief          placeThreads
+     *
+     * @details        Pin Threads following a placement specification, so that
+     * the placement can be tuned, for example from an environment variable,
+     * without recompiling.
+     *
+     * The specification is a policy followed by comma separated modifiers:
+     *  compact[,N]    Thread n + 1 as close as possible to thread n: SMT
+     *                 siblings, then cores of the same cache, then caches of
+     *                 the same NUMA node. N (or permute=N) makes the N
+     *                 innermost levels the most significant, "compact,1"
+     *                 fills physical cores before siblings.
+     *  scatter[,N]    Thread n + 1 as far as possible from thread n: NUMA
+     *                 nodes round robin, then caches, cores and siblings.
+     *  close          As OMP_PROC_BIND=close, over the places given by
+     *                 places=threads|cores|ll_caches|numa_domains.
+     *  spread         As OMP_PROC_BIND=spread, over the same places.
+     *  nosmt          Modifier: one thread per physical core, the SMT
+     *                 siblings are not used.
+     *
+     * Example: "compact,1", "scatter,nosmt", "spread,places=cores".
+     *
+     * @param[in]      threadList        ThreadIDs to pin
+     *
+     * @param[in]      placement         The placement specification
+     *
+     * @return         false if the specification is malformed, no thread is
+     * pinned then, or if a thread could not be pinned
+     */
+    bool placeThreads(std::vector<pthread_t> const& threadList,
+                      std::string const&            placement);
+
+    /**
+     * @brief          placeThreads
+     *
+     * @details        Pin Threads following a placement specification and
+     * report the requested and actual affinity of every thread.
+     *
+     * @param[in]      threadList        ThreadIDs to pin
+     *
+     * @param[in]      placement         The placement specification
+     *
+     * @param[out]     report            One entry per thread, in the order
+     * of threadList, empty if the specification is malformed
+     *
+     * @return         InvalidArgumentError if the specification is malformed,
+     * otherwise the first error of the report
+     */
+    Status placeThreads(std::vector<pthread_t> const& threadList,
+                        std::string const&            placement,
+                        std::vector<ThreadAffinity>&  report);
+
+    /**
+     * @brief          getThreadAffinity
+     *
+     * @details        Processors a thread may run on, as read back from the
+     * operating system.
+     *
+     * @param[in]      thread            Thread to query
+     *
+     * @return         Processor numbers in ascending order, empty if the
+     * affinity cannot be read
+     */
+    std::vector<int> getThreadAffinity(pthread_t thread) const;
+
+    /**
+     * @brief          getAvailableProcessors
+     *
+     * @details        Logical processors the threads can be pinned to: the
+     * online processors which are in the process affinity mask and, on Linux,
+     * in the cpuset of the cgroup of the process. All the pinning strategies
+     * only use these processors.
+     *
+     * On Linux, processes sharing the machine can each take a slice of it
+     * with the AU_CPU_PARTITION environment variable: "i/K" gives slice i of
+     * K balanced slices aligned on the caches and NUMA nodes, "auto" takes
+     * i and K from the local rank and size set by the MPI launcher or Slurm,
+     * setPartition() selects the slice at run time. The slices split the
+     * online processors of the cgroup cpuset, which all the processes see
+     * alike, and the available processors are then those of the slice. A
+     * process already bound to fewer processors by its launcher keeps them.
+     *
+     * @return         Processor numbers in ascending order
+     */
+    std::vector<int> getAvailableProcessors() const;
+
+    /**
+     * @brief          setPartition
+     *
+     * @details        Selects slice index of count balanced slices of the
+     * machine, see getAvailableProcessors(), in place of the one given by
+     * AU_CPU_PARTITION. Processes sharing a machine which learn their rank at
+     * run time, from MPI_Comm_rank() or a scheduler of their own, each select
+     * a different slice. Applies to the ThreadPinning and ThreadPool objects
+     * created afterwards.
+     *
+     * @param[in]      index             Slice of the process, below count
+     *
+     * @param[in]      count             Number of slices, 0 or 1 for the
+     * whole machine
+     *
+     * @return         InvalidArgumentError if index is not below count,
+     * NotImplementedError on Windows
+     */
+    static Status setPartition(size_t index, size_t count);
+
+    /**
+     * @brief          getPartition
+     *
+     * @details        Slice selected by setPartition() or AU_CPU_PARTITION.
+     *
+     * @param[out]     index             Slice of the process
+     *
+     * @param[out]     count             Number of slices, 1 for the whole
+     * machine
+     */
+    static void getPartition(size_t& index, size_t& count);
+
+    /**
+     * @brief          getCpuQuota
+     *
+     * @details        CPU bandwidth the process may use, in processors. On
+     * Linux this is the cgroup quota (cpu.max, or cpu.cfs_quota_us with v1)
+     * divided by its period, so a container limited to "150000 100000" gets
+     * 1.5. A process may run on more processors than its quota, but running
+     * more busy threads than the quota rounded up leads to throttling.
+     *
+     * @return         The quota, 0 if the CPU time is not limited
+     */
+    double getCpuQuota() const;
+
   private:
     class Impl;
     const Impl*           pImpl() const { return m_pimpl.get(); }
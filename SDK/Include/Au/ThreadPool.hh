@@ -0,0 +1,158 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+#include "Au/Config.h"
+#include "Au/Status.hh"
+#include "Au/ThreadPinning.hh"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Au {
+
+/**
+ * @class ThreadPool
+ * @brief Worker threads pinned with a ThreadPinning strategy, balancing their
+ * tasks by work stealing.
+ *
+ * Every worker owns a Chase-Lev deque: it runs its own tasks newest first and,
+ * once it runs dry, steals the oldest task of another worker. Victims are
+ * tried by distance in the topology: the SMT sibling first, then the workers
+ * sharing the last level cache, then the same NUMA node and only then remote
+ * nodes, so that stolen work stays where its data is likely cached. Tasks
+ * submitted from outside the pool go to a shared queue.
+ *
+ * Tasks must not throw.
+ */
+class ThreadPool
+{
+  public:
+    using Task      = std::function<void()>;
+    using RangeTask = std::function<void(size_t begin, size_t end)>;
+
+    /// Pin strategy that leaves the workers unpinned
+    static constexpr int cNoPinning = -1;
+
+    /**
+     * @brief          ThreadPool
+     *
+     * @details        Starts the workers and pins them.
+     *
+     * @param[in]      threadCount       Number of workers, 0 for one per
+     * available processor, capped by the CPU quota of the process
+     *
+     * @param[in]      pinStrategyIndex  0 - spread , 1 - Core, 2 - Logical
+     * Processor, 3 - NUMA spread, 4 - NUMA compact, cNoPinning
+     */
+    explicit ThreadPool(size_t threadCount      = 0,
+                        int    pinStrategyIndex = pinStrategy::SPREAD);
+
+    /**
+     * @brief          ~ThreadPool
+     *
+     * @details        Waits for the submitted tasks, then stops the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief          size
+     *
+     * @return         Number of workers
+     */
+    size_t size() const;
+
+    /**
+     * @brief          workerIndex
+     *
+     * @return         Index of the calling worker, -1 if the caller is not a
+     * worker of this pool
+     */
+    int workerIndex() const;
+
+    /**
+     * @brief          getAffinity
+     *
+     * @details        Requested and actual affinity of every worker, in
+     * worker order, empty with cNoPinning.
+     */
+    std::vector<ThreadAffinity> const& getAffinity() const;
+
+    /**
+     * @brief          getStatus
+     *
+     * @return         The first error met pinning the workers, ok otherwise
+     */
+    Status getStatus() const;
+
+    /**
+     * @brief          submit
+     *
+     * @details        Queues a task. From a worker it goes to the worker's own
+     * deque, so that related tasks stay on the same processor.
+     *
+     * @param[in]      task              Task to run
+     */
+    void submit(Task task);
+
+    /**
+     * @brief          wait
+     *
+     * @details        Returns once every submitted task has run, including the
+     * tasks submitted in the meantime. The caller runs tasks while waiting.
+     * Must not be called from a submitted task, which would wait for itself.
+     */
+    void wait();
+
+    /**
+     * @brief          parallelFor
+     *
+     * @details        Runs body over [begin, end) split into chunks of at most
+     * grain indexes. The range is halved recursively, the halves are pushed
+     * on the deque of the splitting thread and stolen by idle workers. The
+     * calling thread takes part and returns once every chunk has run. Calls
+     * may be nested.
+     *
+     * @param[in]      begin             First index
+     *
+     * @param[in]      end               One past the last index
+     *
+     * @param[in]      body              Called with the bounds of each chunk
+     *
+     * @param[in]      grain             Largest chunk, 0 to have about eight
+     * chunks per worker
+     */
+    void parallelFor(size_t           begin,
+                     size_t           end,
+                     RangeTask const& body,
+                     size_t           grain = 0);
+
+  private:
+    class Impl;
+    const Impl*           pImpl() const { return m_pimpl.get(); }
+    Impl*                 pImpl() { return m_pimpl.get(); }
+    std::unique_ptr<Impl> m_pimpl;
+};
+} // namespace Au
@@ -35,6 +35,8 @@
 
 #include "Capi/au/logger_ctx.h"
 
+#include <stdarg.h>
+
 AUD_EXTERN_C_BEGIN
 
 /**
@@ -71,6 +73,36 @@ au_logger_create();
 AUD_API_EXPORT void
 au_logger_log(logger_ctx_t* logger, const char* message, log_level_t level);
 
+/**
+ * @brief Logs a printf style formatted message at the specified log level.
+ *
+ * Nothing is formatted if the level is disabled. Otherwise the text is
+ * formatted directly into a pooled message record, so unlike au_logger_log()
+ * no temporary buffer or copy is needed. The message is handed to the
+ * logging thread right away, without waiting for au_logger_flush().
+ *
+ * @param[in] logger  Pointer to the logger context.
+ * @param[in] level   Desired log severity level.
+ * @param[in] fmt     printf format string.
+ */
+AUD_API_EXPORT void
+au_logger_logf(logger_ctx_t* logger, log_level_t level, const char* fmt, ...)
+    AUD_PRINTF_FORMAT(3, 4);
+
+/**
+ * @brief va_list variant of au_logger_logf().
+ *
+ * @param[in] logger  Pointer to the logger context.
+ * @param[in] level   Desired log severity level.
+ * @param[in] fmt     printf format string.
+ * @param[in] args    Arguments for fmt.
+ */
+AUD_API_EXPORT void
+au_logger_vlogf(logger_ctx_t* logger,
+                log_level_t   level,
+                const char*   fmt,
+                va_list       args) AUD_PRINTF_FORMAT(3, 0);
+
 /**
  * @brief Forces any buffered messages to be flushed.
  *
@@ -41,6 +41,20 @@ typedef HANDLE pthread_t;
 #include <sys/types.h>
 #endif
 
+/**
+ * @brief          Requested and actual affinity of a pinned thread.
+ */
+typedef struct au_thread_affinity
+{
+    pthread_t thread;      /**< The pinned thread */
+    int       requested;   /**< Processor the thread was pinned to */
+    int       actual;      /**< Processor read back once pinned, -1 if the
+                                thread may run on several or none */
+    size_t    actualCount; /**< Number of processors the thread may run on */
+    int       status;      /**< 0 if the thread only runs on the requested
+                                processor, -1 otherwise */
+} au_thread_affinity_t;
+
 /**
  * @brief          Pin threads to the processor group using pinStrateg::CORE.
  *
@@ -123,6 +137,51 @@ AUD_API_EXPORT
 void
 au_pin_threads_spread(pthread_t* threadList, size_t threadListSize);
 
+/**
+ * @brief          Pin threads to the processor group using
+ * pinStrategy::NUMA_SPREAD.
+ *
+ * @details        This function will balance the threads across the NUMA
+ * nodes, then across the L3 cache groups within each node. Within a cache
+ * group the physical cores are used before their SMT siblings. Consecutive
+ * threads are placed on the same node.
+ *
+ * Example: Let threadList be [0, 1, 2, 3]. The machine has two nodes with two
+ * L3 cache groups of four cores each, node 0 holding cores [0-7] and node 1
+ * cores [8-15]. The threads will be pinned following the below table
+ * | Thread List Index | Logical Core Index |
+ * |-------------------|--------------------|
+ * | 0                 | 0                  |
+ * | 1                 | 4                  |
+ * | 2                 | 8                  |
+ * | 3                 | 12                 |
+ *
+ * @param[in]      threadList      List of threads to pin.
+ * @param[in]      threadListSize  Number of threads in the list.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_pin_threads_numa_spread(pthread_t* threadList, size_t threadListSize);
+
+/**
+ * @brief          Pin threads to the processor group using
+ * pinStrategy::NUMA_COMPACT.
+ *
+ * @details        This function will fill the physical cores of one NUMA node,
+ * L3 cache group by L3 cache group, before moving to the next node. SMT
+ * siblings are used once every physical core has a thread.
+ *
+ * @param[in]      threadList      List of threads to pin.
+ * @param[in]      threadListSize  Number of threads in the list.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_pin_threads_numa_compact(pthread_t* threadList, size_t threadListSize);
+
 /**
  * @brief          Pin threads to the processor group using custom affinity
  * vector.
@@ -154,5 +213,142 @@ au_pin_threads_custom(pthread_t* threadList,
                       int*       affinityVector,
                       size_t     affinityVectorSize);
 
+/**
+ * @brief          Pin threads using a custom affinity vector and verify it.
+ *
+ * @details        Like au_pin_threads_custom, then the affinity of every
+ * thread is read back to check that it only runs on the requested processor.
+ * A failure to pin a thread does not stop the others from being pinned.
+ *
+ * @warning        "threadList", "affinityVector" and "report" should be of the
+ * same size.
+ *
+ * @param[in]      threadList      List of threads to pin.
+ * @param[in]      threadListSize  Number of threads in the list.
+ * @param[in]      affinityVector  Custom affinity vector.
+ * @param[in]      affinityVectorSize  Size of the affinity vector.
+ * @param[out]     report          Requested and actual affinity of every
+ *                                 thread, may be NULL.
+ *
+ * @return         0 if every thread runs on its requested processor, -1
+ *                 otherwise.
+ */
+AUD_API_EXPORT
+int
+au_pin_threads_custom_report(pthread_t*            threadList,
+                             size_t                threadListSize,
+                             int*                  affinityVector,
+                             size_t                affinityVectorSize,
+                             au_thread_affinity_t* report);
+
+/**
+ * @brief          Get the logical processors a thread may run on.
+ *
+ * @param[in]      thread          Thread to query.
+ * @param[out]     processors      Array receiving the processor numbers in
+ *                                 ascending order, may be NULL.
+ * @param[in]      processorsSize  Number of entries of the array.
+ *
+ * @return         Number of processors the thread may run on, which may be
+ *                 larger than processorsSize, 0 if the affinity cannot be
+ *                 read.
+ */
+AUD_API_EXPORT
+size_t
+au_get_thread_affinity(pthread_t thread,
+                       int*      processors,
+                       size_t    processorsSize);
+
+/**
+ * @brief          Pin threads following a placement specification.
+ *
+ * @details        The specification is a policy, compact, scatter, close or
+ * spread, followed by comma separated modifiers: a permute level for compact
+ * and scatter, places=threads|cores|ll_caches|numa_domains for close and
+ * spread, and nosmt to leave the SMT siblings unused. It is typically read
+ * from an environment variable so that the placement can be tuned without
+ * recompiling, see Au::ThreadPinning::placeThreads for the details.
+ *
+ * Example: "compact,1", "scatter,nosmt", "spread,places=cores".
+ *
+ * @param[in]      threadList      List of threads to pin.
+ * @param[in]      threadListSize  Number of threads in the list.
+ * @param[in]      placement       The placement specification.
+ *
+ * @return         0 on success, -1 if the specification is malformed, no
+ *                 thread is pinned then, or if a thread could not be pinned.
+ */
+AUD_API_EXPORT
+int
+au_place_threads(pthread_t*  threadList,
+                 size_t      threadListSize,
+                 const char* placement);
+
+/**
+ * @brief          Get the logical processors threads can be pinned to.
+ *
+ * @details        These are the online processors in the process affinity
+ * mask and, on Linux, in the cpuset of the cgroup of the process, narrowed to
+ * the slice selected by au_set_cpu_partition() or AU_CPU_PARTITION. Every
+ * au_pin_threads_* function only uses these processors.
+ *
+ * @param[out]     processors      Array receiving the processor numbers in
+ *                                 ascending order, may be NULL.
+ * @param[in]      processorsSize  Number of entries of the array.
+ *
+ * @return         Number of available processors, which may be larger than
+ *                 processorsSize.
+ */
+AUD_API_EXPORT
+size_t
+au_get_available_processors(int* processors, size_t processorsSize);
+
+/**
+ * @brief          Select the slice of the machine of the process.
+ *
+ * @details        Takes slice index of count balanced slices of the machine,
+ * aligned on the caches and NUMA nodes, in place of the one given by
+ * AU_CPU_PARTITION. Processes sharing a machine which learn their rank at run
+ * time, from MPI_Comm_rank() or a scheduler of their own, each select a
+ * different slice. Linux only.
+ *
+ * @param[in]      index           Slice of the process, below count.
+ * @param[in]      count           Number of slices, 0 or 1 for the whole
+ *                                 machine.
+ *
+ * @return         0 on success, -1 if index is not below count or partitions
+ *                 are not supported.
+ */
+AUD_API_EXPORT
+int
+au_set_cpu_partition(size_t index, size_t count);
+
+/**
+ * @brief          Get the slice of the machine of the process.
+ *
+ * @param[out]     index           Slice of the process, may be NULL.
+ * @param[out]     count           Number of slices, 1 for the whole machine,
+ *                                 may be NULL.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_get_cpu_partition(size_t* index, size_t* count);
+
+/**
+ * @brief          Get the CPU bandwidth quota of the process.
+ *
+ * @details        On Linux this is the cgroup quota (cpu.max, or
+ * cpu.cfs_quota_us with cgroup v1) divided by its period, in processors. Size
+ * the number of busy threads to it to avoid throttling.
+ *
+ * @return         The quota, for example 1.5, or 0 if the CPU time is not
+ *                 limited.
+ */
+AUD_API_EXPORT
+double
+au_get_cpu_quota(void);
+
 AUD_EXTERN_C_END
 #endif // __AU_THREAD_PINNING_H__
@@ -0,0 +1,141 @@
+/*
+ * Copyright(c) 2024 Advanced Micro Devices, Inc.All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this softwareand associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright noticeand this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __AU_THREAD_POOL_H__
+#define __AU_THREAD_POOL_H__
+
+#include "Au/Config.h"
+#include "Au/Defs.hh"
+#include "Capi/au/macros.h"
+
+#include <stddef.h>
+
+AUD_EXTERN_C_BEGIN
+
+typedef void au_thread_pool_t;
+
+/**
+ * @brief          Task run by a worker of the pool.
+ */
+typedef void (*au_task_fn_t)(void* arg);
+
+/**
+ * @brief          Body of a parallel loop, called with the bounds of a chunk.
+ */
+typedef void (*au_range_fn_t)(size_t begin, size_t end, void* arg);
+
+/**
+ * @brief          Start a pool of work stealing threads.
+ *
+ * @details        The workers are pinned with one of the au_pin_threads_*
+ * strategies and steal the tasks of the closest workers first: the SMT
+ * sibling, then the same last level cache, the same NUMA node and remote
+ * nodes.
+ *
+ * @param[in]      threadCount     Number of workers, 0 for one per available
+ *                                 processor, capped by the CPU quota.
+ * @param[in]      pinStrategy     0 - spread, 1 - core, 2 - logical, 3 - NUMA
+ *                                 spread, 4 - NUMA compact, -1 to leave the
+ *                                 workers unpinned.
+ *
+ * @return         The pool, to be released with au_thread_pool_destroy.
+ */
+AUD_API_EXPORT
+au_thread_pool_t*
+au_thread_pool_create(size_t threadCount, int pinStrategy);
+
+/**
+ * @brief          Wait for the submitted tasks and stop the workers.
+ *
+ * @param[in]      pool            Pool to destroy, may be NULL.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_thread_pool_destroy(au_thread_pool_t* pool);
+
+/**
+ * @brief          Get the number of workers.
+ *
+ * @param[in]      pool            The pool.
+ *
+ * @return         Number of workers.
+ */
+AUD_API_EXPORT
+size_t
+au_thread_pool_size(au_thread_pool_t* pool);
+
+/**
+ * @brief          Queue a task.
+ *
+ * @param[in]      pool            The pool.
+ * @param[in]      task            Function to run.
+ * @param[in]      arg             Argument passed to the function.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_thread_pool_submit(au_thread_pool_t* pool, au_task_fn_t task, void* arg);
+
+/**
+ * @brief          Wait until every submitted task has run.
+ *
+ * @details        Must not be called from a submitted task.
+ *
+ * @param[in]      pool            The pool.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_thread_pool_wait(au_thread_pool_t* pool);
+
+/**
+ * @brief          Run a loop over [begin, end) on the pool.
+ *
+ * @details        The range is split into chunks of at most grain indexes,
+ * the calling thread takes part and the function returns once every chunk
+ * has run.
+ *
+ * @param[in]      pool            The pool.
+ * @param[in]      begin           First index.
+ * @param[in]      end             One past the last index.
+ * @param[in]      grain           Largest chunk, 0 for about eight chunks per
+ *                                 worker.
+ * @param[in]      body            Called with the bounds of each chunk.
+ * @param[in]      arg             Argument passed to body.
+ *
+ * @return         void
+ */
+AUD_API_EXPORT
+void
+au_parallel_for(au_thread_pool_t* pool,
+                size_t            begin,
+                size_t            end,
+                size_t            grain,
+                au_range_fn_t     body,
+                void*             arg);
+
+AUD_EXTERN_C_END
+#endif // __AU_THREAD_POOL_H__